@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "app_arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+void* AppArena::allocate(size_t size) {
+    size = round_up(std::max<size_t>(size, sizeof(FreeBlock)));
+
+    void* p = nullptr;
+    if (size <= pooled_max) {
+        auto& pool = pools_[size / alignment - 1];
+        if (pool) {
+            p = pool;
+            pool = pool->next;
+        }
+    }
+
+    if (!p)
+        p = bump(size);
+
+    used_ += size;
+    high_water_ = std::max(high_water_, used_);
+    return p;
+}
+
+void AppArena::deallocate(void* p, size_t size) {
+    if (!p)
+        return;
+
+    size = round_up(std::max<size_t>(size, sizeof(FreeBlock)));
+    used_ -= size;
+
+    // Last allocation in the current chunk, just step back.
+    if (chunks_ && static_cast<uint8_t*>(p) + size == data(chunks_) + chunks_->top) {
+        chunks_->top -= size;
+        return;
+    }
+
+    if (size <= pooled_max) {
+        auto& pool = pools_[size / alignment - 1];
+        pool = new (p) FreeBlock{pool};
+    }
+}
+
+void AppArena::release() {
+    while (chunks_) {
+        auto next = chunks_->next;
+        ::operator delete(chunks_);
+        chunks_ = next;
+    }
+
+    pools_.fill(nullptr);
+    reserved_ = 0;
+    used_ = 0;
+}
+
+void* AppArena::bump(size_t size) {
+    if (!chunks_ || chunks_->top + size > chunks_->size) {
+        // Oversized requests get a chunk of their own.
+        auto chunk_size = std::max(round_up(chunk_size_), size);
+        auto chunk = static_cast<Chunk*>(::operator new(header_size + chunk_size));
+        *chunk = {chunks_, chunk_size, 0};
+        chunks_ = chunk;
+        reserved_ += header_size + chunk_size;
+    }
+
+    auto p = data(chunks_) + chunks_->top;
+    chunks_->top += size;
+    return p;
+}
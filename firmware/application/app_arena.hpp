@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __APP_ARENA_H__
+#define __APP_ARENA_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/* Memory owned by one app for its lifetime.
+ * Apps that keep growing containers (recent entry lists and the like)
+ * scatter small blocks over the shared heap, and once the app is closed
+ * the holes they leave fragment it for the next app. An AppArena takes
+ * memory from the heap in large chunks and hands it out from there. All
+ * chunks go back to the heap together when the arena is destroyed, so an
+ * app member arena is released wholesale when the app is popped.
+ *
+ * Freed blocks up to pooled_max bytes are kept on per-size free lists and
+ * reused, so list style churn (node erased, node inserted) stays inside
+ * the arena. Larger blocks are only reclaimed when they are the last
+ * allocation, otherwise they are held until the arena goes away. */
+class AppArena {
+   public:
+    static constexpr size_t alignment = 8;
+    static constexpr size_t pooled_max = 512;
+    static constexpr size_t default_chunk_size = 2048;
+
+    explicit AppArena(size_t chunk_size = default_chunk_size)
+        : chunk_size_{chunk_size} {}
+    ~AppArena() { release(); }
+
+    AppArena(const AppArena&) = delete;
+    AppArena& operator=(const AppArena&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* p, size_t size);
+
+    /* Gives every chunk back to the heap. Anything still allocated from
+     * the arena is invalid afterwards. */
+    void release();
+
+    /* Bytes taken from the heap. */
+    size_t reserved() const { return reserved_; }
+    /* Bytes currently handed out. */
+    size_t used() const { return used_; }
+    /* Peak of used() since construction. */
+    size_t high_water() const { return high_water_; }
+
+   private:
+    struct Chunk {
+        Chunk* next;
+        size_t size;  // Usable bytes after the header.
+        size_t top;   // Bytes bumped so far.
+    };
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static constexpr size_t header_size = (sizeof(Chunk) + alignment - 1) & ~(alignment - 1);
+    static constexpr size_t pool_count = pooled_max / alignment;
+
+    static size_t round_up(size_t size) {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    static uint8_t* data(Chunk* chunk) {
+        return reinterpret_cast<uint8_t*>(chunk) + header_size;
+    }
+
+    void* bump(size_t size);
+
+    size_t chunk_size_;
+    Chunk* chunks_{nullptr};  // Current chunk first.
+    std::array<FreeBlock*, pool_count> pools_{};
+    size_t reserved_{0};
+    size_t used_{0};
+    size_t high_water_{0};
+};
+
+/* Standard allocator over an AppArena for std containers.
+ * A default constructed allocator uses the heap, so containers can switch
+ * to it and only the apps that own an arena have to pass one in. */
+template <typename T>
+class ArenaAllocator {
+   public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static_assert(alignof(T) <= AppArena::alignment, "Type is over-aligned for AppArena.");
+
+    ArenaAllocator() = default;
+    ArenaAllocator(AppArena& arena)
+        : arena_{&arena} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : arena_{other.arena()} {}
+
+    T* allocate(size_t n) {
+        auto size = n * sizeof(T);
+        return static_cast<T*>(arena_ ? arena_->allocate(size) : ::operator new(size));
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (arena_)
+            arena_->deallocate(p, n * sizeof(T));
+        else
+            ::operator delete(p);
+    }
+
+    AppArena* arena() const { return arena_; }
+
+   private:
+    AppArena* arena_{nullptr};
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+#endif /*__APP_ARENA_H__*/
@@ -30,6 +30,9 @@
 #include "io_file.hpp"
 #include "rtc_time.hpp"
 #include "baseband_api.hpp"
+#include "portapack_shared_memory.hpp"
+#include "radio.hpp"
+#include "scanner_schedule.hpp"
 #include "string_format.hpp"
 #include "portapack_persistent_memory.hpp"
 #include "ui_fileman.hpp"
@@ -429,6 +432,8 @@ BLERxView::BLERxView(NavigationView& nav)
                   &check_serial_log,
                   &button_filter,
                   &options_filter,
+                  &options_dwell,
+                  &text_channel_stats,
                   &button_save_list,
                   &button_clear_list,
                   &button_switch,
@@ -488,6 +493,8 @@ BLERxView::BLERxView(NavigationView& nav)
 
     button_clear_list.on_select = [this](Button&) {
         recent.clear();
+        channel_stats.clear();
+        update_channel_stats();
     };
 
     button_switch.on_select = [&nav](Button&) {
@@ -508,18 +515,22 @@ BLERxView::BLERxView(NavigationView& nav)
     options_channel.on_change = [this](size_t index, int32_t v) {
         channel_index = (uint8_t)index;
 
-        // If we selected Auto don't do anything and Auto will handle changing.
-        if (v == 40) {
-            auto_channel = true;
-            return;
+        // Auto hops 37/38/39 from on_timer(), starting here.
+        auto_channel = (v == 40);
+        options_dwell.hidden(!auto_channel);
+        set_dirty();
+
+        if (auto_channel) {
+            hop_schedule.restart();
+            tune_channel(hop_schedule.channel());
         } else {
-            auto_channel = false;
+            tune_channel(v);
         }
+    };
 
-        field_frequency.set_value(get_freq_by_channel_number(v));
-        channel_number = v;
-
-        baseband::set_btlerx(channel_number);
+    options_dwell.on_change = [this](size_t, int32_t v) {
+        hop_dwell_ms = v;
+        hop_schedule.set_dwell_ms(v);
     };
 
     options_sort.on_change = [this](size_t index, int32_t v) {
@@ -532,6 +543,10 @@ BLERxView::BLERxView(NavigationView& nav)
         handle_filter_options(v);
     };
 
+    // Falls back to the first option for a value that isn't one.
+    options_dwell.set_by_value(hop_dwell_ms);
+    hop_dwell_ms = options_dwell.selected_index_value();
+    hop_schedule.set_dwell_ms(hop_dwell_ms);
     options_channel.set_selected_index(channel_index, true);
     options_sort.set_selected_index(sort_index, true);
     options_filter.set_selected_index(filter_index, true);
@@ -818,19 +833,47 @@ void BLERxView::on_file_changed(const std::filesystem::path& new_file_path) {
 
 // called each 1/60th of second, so 6 = 100ms
 void BLERxView::on_timer() {
+    if (auto_channel && hop_schedule.advance(1000000 / 60)) {
+        tune_channel(hop_schedule.channel());
+    }
+
     if (++timer_count == timer_period) {
         timer_count = 0;
+        update_channel_stats();
+    }
+}
 
-        if (auto_channel) {
-            int min = 37;
-            int max = 39;
+// Same handshake as the scanner: the baseband drops the packet it was
+// reading and the settle time, so none is decoded across two channels.
+void BLERxView::tune_channel(uint8_t channel) {
+    const auto first_lo = radio::first_lo_frequency();
+    field_frequency.set_value(get_freq_by_channel_number(channel));
 
-            int randomChannel = min + std::rand() % (max - min + 1);
+    shared_memory.retune_settle_us = scanner::settle_us(radio::first_lo_frequency() != first_lo);
+    shared_memory.retune_window_us = 0;
+    shared_memory.retune_epoch = shared_memory.retune_epoch + 1;
 
-            field_frequency.set_value(get_freq_by_channel_number(randomChannel));
-            baseband::set_btlerx(randomChannel);
-        }
+    channel_number = channel;
+    baseband::set_btlerx(channel_number);
+}
+
+void BLERxView::on_statistics(const BTLERxStatisticsMessage& message) {
+    channel_stats.add(message.channel, message.packets, message.crc_errors);
+}
+
+static std::string to_string_count(uint32_t count) {
+    return (count < 1000) ? to_string_dec_uint(count) : to_string_dec_uint(count / 1000) + "k";
+}
+
+void BLERxView::update_channel_stats() {
+    std::string str;
+    for (auto ch : ble::advertising_channels) {
+        const auto counters = channel_stats.counters(ch);
+        if (!str.empty())
+            str += " ";
+        str += to_string_dec_uint(ch) + ":" + to_string_count(counters.packets) + "/" + to_string_count(counters.crc_errors);
     }
+    text_channel_stats.set(str);
 }
 
 void BLERxView::handle_entries_sort(uint8_t index) {
@@ -918,7 +961,7 @@ void BLERxView::updateEntry(const BlePacketData* packet, BleRecentEntry& entry,
 
     entry.numHits++;
     entry.pduType = pdu_type;
-    entry.channelNumber = channel_number;
+    entry.channelNumber = packet->channel;
 
     // Parse Data Section into buffer to be interpretted later.
     for (int i = 0; i < packet->dataLen; i++) {
@@ -25,6 +25,7 @@
 #define __BLE_RX_APP_H__
 
 #include "ble_tx_app.hpp"
+#include "ble_hop_schedule.hpp"
 
 #include "ui.hpp"
 #include "ui_navigation.hpp"
@@ -202,6 +203,9 @@ class BLERxView : public View {
     void on_file_changed(const std::filesystem::path& new_file_path);
     void file_error();
     void on_timer();
+    void tune_channel(uint8_t channel);
+    void on_statistics(const BTLERxStatisticsMessage& message);
+    void update_channel_stats();
     void handle_entries_sort(uint8_t index);
     void handle_filter_options(uint8_t index);
     void updateEntry(const BlePacketData* packet, BleRecentEntry& entry, ADV_PDU_TYPE pdu_type);
@@ -216,6 +220,7 @@ class BLERxView : public View {
     uint8_t channel_index{0};
     uint8_t sort_index{0};
     uint8_t filter_index{0};
+    uint32_t hop_dwell_ms{100};
     std::string filter{};
     bool logging{false};
     bool serial_logging{false};
@@ -233,6 +238,7 @@ class BLERxView : public View {
             // disabled to always start without USB serial activated until we can make it non blocking if not connected
             // {"serial_log"sv, &serial_logging},
             {"name"sv, &name_enable},
+            {"hop_dwell_ms"sv, &hop_dwell_ms},
         }};
 
     std::string str_console = "";
@@ -240,6 +246,8 @@ class BLERxView : public View {
     uint32_t prev_value{0};
     uint8_t channel_number = 37;
     bool auto_channel = false;
+    ble::HopSchedule hop_schedule{};
+    ble::ChannelStatistics channel_stats{};
 
     int16_t timer_count{0};
     int16_t timer_period{6};  // 100ms
@@ -258,7 +266,7 @@ class BLERxView : public View {
     std::filesystem::path log_packets_path{blerx_dir / u"Logs/????.TXT"};
     std::filesystem::path packet_save_path{blerx_dir / u"Lists/????.csv"};
 
-    static constexpr auto header_height = 9 * 8;
+    static constexpr auto header_height = 11 * 8;
     static constexpr auto switch_button_height = 3 * 16;
 
     OptionsField options_channel{
@@ -310,6 +318,16 @@ class BLERxView : public View {
         {{"Data", 0},
          {"MAC", 1}}};
 
+    // Time on each channel in Auto.
+    OptionsField options_dwell{
+        {24 * 8, 2 * 8},
+        5,
+        {{"50ms", 50},
+         {"100ms", 100},
+         {"250ms", 250},
+         {"500ms", 500},
+         {"1s", 1000}}};
+
     Checkbox check_log{
         {10 * 8, 4 * 8 + 2},
         3,
@@ -333,6 +351,11 @@ class BLERxView : public View {
         {11 * 8, 7 * 8 - 2, 20 * 8, 16},
         "0/0"};
 
+    // Packets/CRC failures per advertising channel.
+    Text text_channel_stats{
+        {0 * 8, 9 * 8, 30 * 8, 16},
+        ""};
+
     Checkbox check_serial_log{
         {18 * 8 + 2, 4 * 8 + 2},
         7,
@@ -357,8 +380,10 @@ class BLERxView : public View {
     std::string str_log{""};
     std::unique_ptr<BLELogger> logger{};
 
-    BleRecentEntries recent{};
-    BleRecentEntries tempList{};
+    // Before the lists, it has to outlive them.
+    AppArena arena{};
+    BleRecentEntries recent{arena};
+    BleRecentEntries tempList{arena};
 
     const RecentEntriesColumns columns{{
         {"Mac Address", 17},
@@ -371,8 +396,14 @@ class BLERxView : public View {
     MessageHandlerRegistration message_handler_packet{
         Message::ID::BlePacket,
         [this](Message* const p) {
-            const auto message = static_cast<const BLEPacketMessage*>(p);
-            this->on_data(message->packet);
+            const auto message = static_cast<BLEPacketMessage*>(p);
+            this->on_data(&message->packet);
+        }};
+
+    MessageHandlerRegistration message_handler_statistics{
+        Message::ID::BTLERxStatistics,
+        [this](const Message* const p) {
+            this->on_statistics(*static_cast<const BTLERxStatisticsMessage*>(p));
         }};
 
     MessageHandlerRegistration message_handler_frame_sync{
@@ -89,7 +89,8 @@ CaptureAppView::CaptureAppView(NavigationView& nav)
 
         // Automatically switch default capture format to C8 when bandwidth setting is increased to >=1.5MHz
         if ((bandwidth >= 1500000) && (previous_bandwidth < 1500000)) {
-            option_format.set_selected_index(1);
+            const bool usb = option_format.selected_index_value() == RecordView::FileType::UsbS16;
+            option_format.set_selected_index(usb ? 3 : 1);
         }
         previous_bandwidth = bandwidth;
 
@@ -99,6 +100,9 @@ CaptureAppView::CaptureAppView(NavigationView& nav)
     receiver_model.enable();
     option_bandwidth.set_by_value(500000);
 
+    // Reserve a minute of capture up front, longer captures continue past it.
+    record_view.set_preallocate_seconds(60);
+
     record_view.on_error = [&nav](std::string message) {
         nav.display_modal("Error", message);
     };
@@ -87,11 +87,14 @@ class CaptureAppView : public View {
         5,
         {}};
 
+    // uC16 and uC8 stream to the host over USB serial instead of the SD card.
     OptionsField option_format{
         {18 * 8, 1 * 16},
-        3,
+        4,
         {{"C16", RecordView::FileType::RawS16},
-         {"C8", RecordView::FileType::RawS8}}};
+         {"C8", RecordView::FileType::RawS8},
+         {"uC16", RecordView::FileType::UsbS16},
+         {"uC8", RecordView::FileType::UsbS8}}};
 
     Checkbox check_trim{
         {23 * 8, 1 * 16},
@@ -92,6 +92,7 @@ void SoundBoardView::start_tx(const uint32_t id) {
     uint32_t tone_key_index = options_tone_key.selected_index();
     uint32_t sample_rate;
     uint8_t bits_per_sample;
+    uint8_t channels;
 
     stop();
 
@@ -102,12 +103,14 @@ void SoundBoardView::start_tx(const uint32_t id) {
 
     playing_id = id;
 
-    progressbar.set_max(reader->sample_count());
+    // Progress is counted in frames, stereo is mixed to mono by the baseband.
+    progressbar.set_max(reader->sample_count() / reader->channels());
 
     // button_play.set_bitmap(&bitmap_stop);
 
     sample_rate = reader->sample_rate();
     bits_per_sample = reader->bits_per_sample();
+    channels = reader->channels();
 
     replay_thread = std::make_unique<ReplayThread>(
         std::move(reader),
@@ -129,8 +132,9 @@ void SoundBoardView::start_tx(const uint32_t id) {
         false,  // AM
         false,  // DSB
         false,  // USB
-        false   // LSB
-    );
+        false,  // LSB
+        channels,
+        interpolate);
     baseband::set_sample_rate(sample_rate);
 
     transmitter_model.enable();
@@ -175,7 +179,7 @@ void SoundBoardView::refresh_list() {
 
                 if (entry_extension == ".WAV") {
                     if (reader->open(wav_dir / entry.path())) {
-                        if ((reader->channels() == 1) && ((reader->bits_per_sample() == 8) || (reader->bits_per_sample() == 16))) {
+                        if (((reader->channels() == 1) || (reader->channels() == 2)) && ((reader->bits_per_sample() == 8) || (reader->bits_per_sample() == 16))) {
                             // sounds[c].ms_duration = reader->ms_duration();
                             // sounds[c].path = u"WAV/" + entry.path().native();
                             if (count >= (page - 1) * 100 && count < page * 100) {
@@ -247,6 +251,7 @@ SoundBoardView::SoundBoardView(
                   &page_info,
                   &check_loop,
                   &check_random,
+                  &check_hq,
                   &button_prev_page,
                   &button_next_page,
                   &tx_view});
@@ -279,6 +284,11 @@ SoundBoardView::SoundBoardView(
     check_loop.set_value(false);
     check_random.set_value(false);
 
+    check_hq.set_value(interpolate);
+    check_hq.on_select = [this](Checkbox&, bool v) {
+        interpolate = v;
+    };
+
     tx_view.on_edit_frequency = [this, &nav]() {
         auto new_view = nav.push<FrequencyKeypadView>(transmitter_model.target_frequency());
         new_view->on_changed = [this](rf::Frequency f) {
@@ -55,8 +55,14 @@ class SoundBoardView : public View {
         1750000 /* bandwidth */,
         1536000 /* sampling rate */
     };
+    bool interpolate{false};
+
     app_settings::SettingsManager settings_{
-        "tx_soundboard", app_settings::Mode::TX};
+        "tx_soundboard",
+        app_settings::Mode::TX,
+        {
+            {"interpolate"sv, &interpolate},
+        }};
 
     NavigationView& nav_;
 
@@ -104,7 +110,7 @@ class SoundBoardView : public View {
         "<="};
 
     Text page_info{
-        {0, 29 * 8, 30 * 8, 16}};
+        {0, 29 * 8, 25 * 8, 16}};
 
     MenuView menu_view{
         {0, 0, 240, 175},
@@ -143,6 +149,13 @@ class SoundBoardView : public View {
         6,
         "Random"};
 
+    // Polyphase interpolation in the baseband instead of a sample hold.
+    Checkbox check_hq{
+        {26 * 8, 29 * 8},
+        2,
+        "HQ",
+        true};
+
     ProgressBar progressbar{
         {0 * 8, 31 * 8 + 2, 30 * 8, 4}};
 
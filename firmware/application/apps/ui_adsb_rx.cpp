@@ -116,7 +116,8 @@ void ADSBLogger::log(const ADSBLogEntry& log_entry) {
 
 ADSBRxAircraftDetailsView::ADSBRxAircraftDetailsView(
     NavigationView& nav,
-    const AircraftRecentEntry& entry) {
+    const AircraftRecentEntry& entry,
+    database& db) {
     add_children(
         {&labels,
          &text_icao_address,
@@ -133,7 +134,6 @@ ADSBRxAircraftDetailsView::ADSBRxAircraftDetailsView(
     text_icao_address.set(entry.icao_str);
 
     // Try getting the aircraft information from icao24.db
-    database db{};
     database::AircraftDBRecord aircraft_record;
     auto return_code = db.retrieve_aircraft_record(&aircraft_record, entry.icao_str);
     switch (return_code) {
@@ -227,8 +227,12 @@ void ADSBRxAircraftDetailsView::focus() {
 
 ADSBRxDetailsView::ADSBRxDetailsView(
     NavigationView& nav,
-    const AircraftRecentEntry& entry)
-    : entry_(entry) {
+    const AircraftRecentEntry& entry,
+    database& db_aircraft,
+    database& db_airlines)
+    : entry_(entry),
+      db_aircraft_(db_aircraft),
+      db_airlines_(db_airlines) {
     add_children(
         {&labels,
          &text_icao_address,
@@ -246,7 +250,7 @@ ADSBRxDetailsView::ADSBRxDetailsView(
     text_icao_address.set(entry_.icao_str);
 
     button_aircraft_details.on_select = [this, &nav](Button&) {
-        aircraft_details_view_ = nav.push<ADSBRxAircraftDetailsView>(entry_);
+        aircraft_details_view_ = nav.push<ADSBRxAircraftDetailsView>(entry_, db_aircraft_);
         nav.set_on_pop([this]() {
             aircraft_details_view_ = nullptr;
             refresh_ui();
@@ -327,10 +331,9 @@ void ADSBRxDetailsView::refresh_ui() {
     if (!airline_checked && !entry_.callsign.empty()) {
         airline_checked = true;
 
-        database db;
         database::AirlinesDBRecord airline_record;
         std::string airline_code = entry_.callsign.substr(0, 3);
-        auto return_code = db.retrieve_airline_record(&airline_record, airline_code);
+        auto return_code = db_airlines_.retrieve_airline_record(&airline_record, airline_code);
 
         switch (return_code) {
             case DATABASE_RECORD_FOUND:
@@ -384,7 +387,7 @@ ADSBRxView::ADSBRxView(NavigationView& nav) {
     recent_entries_view.set_parent_rect({0, 16, 240, 272});
     recent_entries_view.on_select = [this, &nav](const AircraftRecentEntry& entry) {
         detail_key = entry.key();
-        details_view = nav.push<ADSBRxDetailsView>(entry);
+        details_view = nav.push<ADSBRxDetailsView>(entry, db_aircraft, db_airlines);
 
         nav.set_on_pop([this]() {
             detail_key = AircraftRecentEntry::invalid_key;
@@ -445,7 +448,7 @@ void ADSBRxView::on_frame(const ADSBFrameMessage* message) {
                     ? message->amp
                     : ((entry.amp * 15) + message->amp) >> 4;
 
-    log_entry.raw_data = to_string_hex_array(frame.get_raw_data(), 14);
+    log_entry.raw_data = to_string_hex_array(frame.get_raw_data(), frame.length());
     log_entry.icao = entry.icao_str;
 
     if (frame.get_DF() == DF_ADSB) {
@@ -198,7 +198,8 @@ class ADSBRxAircraftDetailsView : public View {
    public:
     ADSBRxAircraftDetailsView(
         NavigationView&,
-        const AircraftRecentEntry& entry);
+        const AircraftRecentEntry& entry,
+        database& db);
 
     void focus() override;
     std::string title() const override { return "AC Details"; }
@@ -259,7 +260,7 @@ class ADSBRxAircraftDetailsView : public View {
 /* Shows detailed information about an aircraft's flight. */
 class ADSBRxDetailsView : public View {
    public:
-    ADSBRxDetailsView(NavigationView&, const AircraftRecentEntry& entry);
+    ADSBRxDetailsView(NavigationView&, const AircraftRecentEntry& entry, database& db_aircraft, database& db_airlines);
 
     ADSBRxDetailsView(const ADSBRxDetailsView&) = delete;
     ADSBRxDetailsView& operator=(const ADSBRxDetailsView&) = delete;
@@ -288,6 +289,10 @@ class ADSBRxDetailsView : public View {
     AircraftRecentEntry entry_{AircraftRecentEntry::invalid_key};
     bool airline_checked{false};
 
+    // Owned by ADSBRxView so that open files and cached lookups outlive this view.
+    database& db_aircraft_;
+    database& db_airlines_;
+
     Labels labels{
         {{0 * 8, 1 * 16}, "ICAO:", Theme::getInstance()->fg_light->foreground},
         {{13 * 8, 1 * 16}, "Callsign:", Theme::getInstance()->fg_light->foreground},
@@ -400,7 +405,8 @@ class ADSBRxView : public View {
          {"Amp", 3},
          {"Hit", 3},
          {"Age", 4}}};
-    AircraftRecentEntries recent{};
+    AppArena arena{};
+    AircraftRecentEntries recent{arena};
     RecentEntriesView<AircraftRecentEntries> recent_entries_view{columns, recent};
 
     /* Entry Management */
@@ -413,6 +419,10 @@ class ADSBRxView : public View {
     AircraftRecentEntry::Key detail_key{AircraftRecentEntry::invalid_key};
     ADSBRxDetailsView* details_view{nullptr};
 
+    /* Lookup databases, kept open for the lifetime of the app. */
+    database db_aircraft{};
+    database db_airlines{};
+
     Labels labels{
         {{0 * 8, 0 * 8}, "LNA:   VGA:   AMP:", Theme::getInstance()->fg_light->foreground}};
 
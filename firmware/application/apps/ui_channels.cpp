@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ui_channels.hpp"
+#include "ui_freqman.hpp"
+#include "ui_spectrum.hpp"
+#include "portapack.hpp"
+#include "string_format.hpp"
+
+#include <algorithm>
+
+using namespace portapack;
+
+namespace ui {
+
+// Channels are laid out in two columns of rows, lowest offset first.
+static constexpr size_t channel_rows = 8;
+static constexpr Dim column_width = 120;
+static constexpr Dim row_height = 20;
+static constexpr Coord rows_top = 4 * 16;
+
+ChannelsView::ChannelsView(NavigationView& nav)
+    : nav_{nav} {
+    baseband::run_image(portapack::spi_flash::image_tag_channelizer);
+
+    add_children({&labels,
+                  &field_lna,
+                  &field_vga,
+                  &field_rf_amp,
+                  &field_width,
+                  &button_frequency});
+
+    for (size_t i = 0; i < channel_count; i++) {
+        const Coord x = (i / channel_rows) * column_width;
+        const Coord y = rows_top + (i % channel_rows) * row_height;
+
+        texts_offset.push_back(std::make_unique<Text>(Rect{x, y, 6 * 8, 16}));
+        add_child(texts_offset.back().get());
+
+        bars_level.push_back(std::make_unique<ProgressBar>(Rect{x + 6 * 8 + 4, y + 2, column_width - 6 * 8 - 12, 12}));
+        bars_level.back()->set_max(level_max_db - level_min_db);
+        add_child(bars_level.back().get());
+    }
+
+    freq_ = receiver_model.target_frequency();
+
+    button_frequency.on_select = [this](ButtonWithEncoder&) {
+        auto new_view = nav_.push<FrequencyKeypadView>(freq_);
+        new_view->on_changed = [this](rf::Frequency f) {
+            set_frequency(f);
+        };
+    };
+
+    button_frequency.on_change = [this]() {
+        const int64_t step = channel_width();
+        int64_t f = freq_ + button_frequency.get_encoder_delta() * step;
+        button_frequency.set_encoder_delta(0);
+        if (f < step) f = step;
+        if (f > MAX_UFREQ) f = MAX_UFREQ;
+        set_frequency(f);
+    };
+
+    field_width.set_by_value(sampling_rate_);
+    sampling_rate_ = field_width.selected_index_value();
+    field_width.on_change = [this](size_t, OptionsField::value_t v) {
+        sampling_rate_ = v;
+        configure();
+    };
+
+    configure();
+    receiver_model.enable();
+}
+
+ChannelsView::~ChannelsView() {
+    receiver_model.disable();
+    baseband::shutdown();
+}
+
+void ChannelsView::focus() {
+    button_frequency.focus();
+}
+
+uint32_t ChannelsView::channel_width() const {
+    // 4x front end decimation, then 64 channels.
+    return sampling_rate_ / 256;
+}
+
+void ChannelsView::set_frequency(rf::Frequency f) {
+    freq_ = f;
+    receiver_model.set_target_frequency(f);
+    button_frequency.set_text("<" + to_string_short_freq(freq_) + " MHz>");
+}
+
+void ChannelsView::configure() {
+    // Offsets -8..+7 channels from the target, channelizer channel numbers
+    // wrap around with the negative ones at the top.
+    std::vector<uint8_t> selected{};
+    for (size_t i = 0; i < channel_count; i++) {
+        const int32_t offset = static_cast<int32_t>(i) - static_cast<int32_t>(channel_count / 2);
+        selected.push_back(offset & 63);
+        texts_offset[i]->set(to_string_decimal_padding(offset * (channel_width() / 1000.0f), 1, 6));
+        bars_level[i]->set_value(0);
+    }
+
+    receiver_model.set_sampling_rate(sampling_rate_);
+    receiver_model.set_baseband_bandwidth(filter_bandwidth_for_sampling_rate(sampling_rate_));
+    set_frequency(freq_);  // The tuning offset follows the sampling rate.
+    baseband::set_channelizer(sampling_rate_, selected);
+}
+
+void ChannelsView::on_statistics(const MultiChannelStatistics& statistics) {
+    const size_t count = std::min(statistics.channel_count, channel_count);
+    for (size_t i = 0; i < count; i++) {
+        const int32_t level = std::clamp<int32_t>(statistics.max_db[i], level_min_db, level_max_db);
+        bars_level[i]->set_value(level - level_min_db);
+    }
+}
+
+} /* namespace ui */
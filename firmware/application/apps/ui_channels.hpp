@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _UI_CHANNELS
+#define _UI_CHANNELS
+
+#include "app_settings.hpp"
+#include "baseband_api.hpp"
+#include "message.hpp"
+#include "radio_state.hpp"
+#include "receiver_model.hpp"
+#include "ui.hpp"
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace ui {
+
+/* Levels of the 16 channels around the target frequency, all measured at
+ * once by the channelizer baseband. */
+class ChannelsView : public View {
+   public:
+    ChannelsView(NavigationView& nav);
+    ~ChannelsView();
+
+    void focus() override;
+
+    std::string title() const override { return "Channels"; };
+
+   private:
+    static constexpr size_t channel_count = MultiChannelStatistics::max_channels;
+    static constexpr int32_t level_min_db = -100;
+    static constexpr int32_t level_max_db = 0;
+
+    NavigationView& nav_;
+
+    RxRadioState radio_state_{ReceiverModel::Mode::Capture};
+
+    rf::Frequency freq_{0};
+    uint32_t sampling_rate_{3200000};
+
+    app_settings::SettingsManager settings_{
+        "rx_channels",
+        app_settings::Mode::RX,
+        {
+            {"sampling_rate"sv, &sampling_rate_},
+        }};
+
+    Labels labels{
+        {{0 * 8, 0 * 16}, "LNA:   VGA:   AMP:  ", Theme::getInstance()->fg_light->foreground},
+        {{0 * 8, 1 * 16}, "Width:", Theme::getInstance()->fg_light->foreground},
+    };
+
+    LNAGainField field_lna{
+        {4 * 8, 0 * 16}};
+
+    VGAGainField field_vga{
+        {11 * 8, 0 * 16}};
+
+    RFAmpField field_rf_amp{
+        {18 * 8, 0 * 16}};
+
+    OptionsField field_width{
+        {7 * 8, 1 * 16},
+        5,
+        {
+            {"12.5k", 3200000},
+            {"25k", 6400000},
+        }};
+
+    ButtonWithEncoder button_frequency{
+        {0 * 8, 2 * 16 + 8, 15 * 8, 1 * 8},
+        ""};
+
+    std::vector<std::unique_ptr<Text>> texts_offset{};
+    std::vector<std::unique_ptr<ProgressBar>> bars_level{};
+
+    uint32_t channel_width() const;
+    void set_frequency(rf::Frequency f);
+    void configure();
+    void on_statistics(const MultiChannelStatistics& statistics);
+
+    MessageHandlerRegistration message_handler_stats{
+        Message::ID::MultiChannelStatistics,
+        [this](const Message* const p) {
+            this->on_statistics(static_cast<const MultiChannelStatisticsMessage*>(p)->statistics);
+        }};
+};
+
+} /* namespace ui */
+
+#endif
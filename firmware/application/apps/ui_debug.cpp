@@ -25,6 +25,7 @@
 #include "debug.hpp"
 
 #include "ch.h"
+#include "chibios_cpp.hpp"
 
 #include "radio.hpp"
 #include "string_format.hpp"
@@ -55,6 +56,10 @@ DebugMemoryView::DebugMemoryView(NavigationView& nav) {
                   &text_label_m0_heap_fragmented_free_value,
                   &text_label_m0_heap_fragments,
                   &text_label_m0_heap_fragments_value,
+                  &text_label_m0_heap_allocated,
+                  &text_label_m0_heap_allocated_value,
+                  &text_label_m0_heap_high_water,
+                  &text_label_m0_heap_high_water_value,
                   &button_done});
 
     const auto m0_core_free = chCoreStatus();
@@ -65,6 +70,9 @@ DebugMemoryView::DebugMemoryView(NavigationView& nav) {
     text_label_m0_heap_fragmented_free_value.set(to_string_dec_uint(m0_fragmented_free_space, 5));
     text_label_m0_heap_fragments_value.set(to_string_dec_uint(m0_fragments, 5));
 
+    text_label_m0_heap_allocated_value.set(to_string_dec_uint(chibios::heap_allocated(), 5));
+    text_label_m0_heap_high_water_value.set(to_string_dec_uint(chibios::heap_high_water(), 5));
+
     button_done.on_select = [&nav](Button&) { nav.pop(); };
 }
 
@@ -81,8 +81,26 @@ class DebugMemoryView : public View {
         {200, 160, 40, 16},
     };
 
+    Text text_label_m0_heap_allocated{
+        {0, 176, 152, 16},
+        "M0 Heap Allocated",
+    };
+
+    Text text_label_m0_heap_allocated_value{
+        {200, 176, 40, 16},
+    };
+
+    Text text_label_m0_heap_high_water{
+        {0, 192, 160, 16},
+        "M0 Heap High Water",
+    };
+
+    Text text_label_m0_heap_high_water_value{
+        {200, 192, 40, 16},
+    };
+
     Button button_done{
-        {72, 192, 96, 24},
+        {72, 224, 96, 24},
         "Done"};
 };
 
@@ -36,6 +36,7 @@
 #include "portapack.hpp"
 #include "event_m0.hpp"
 #include "file_path.hpp"
+#include "freqman_db.hpp"
 
 using namespace portapack;
 namespace fs = std::filesystem;
@@ -571,6 +572,7 @@ void FileManagerView::on_rename(std::string_view hint) {
         [this](std::string& renamed) {
             auto renamed_path = fs::path{renamed};
             rename_file(get_selected_full_path(), current_path / renamed_path);
+            delete_freqman_index(get_selected_full_path());
 
             auto has_partner = partner_file_prompt(
                 nav_, get_selected_full_path(), "Rename",
@@ -599,6 +601,7 @@ void FileManagerView::on_delete() {
         [this](bool choice) {
             if (choice) {
                 delete_file(get_selected_full_path());
+                delete_freqman_index(get_selected_full_path());
 
                 auto has_partner = partner_file_prompt(
                     nav_, get_selected_full_path(), "Delete",
@@ -655,8 +658,10 @@ void FileManagerView::on_paste() {
     if (clipboard_mode == ClipboardMode::Cut)
         if ((current_path / clipboard_path.filename()) == clipboard_path)
             result = FR_OK;  // Skip paste to avoid renaming if path is unchanged
-        else
+        else {
             result = rename_file(clipboard_path, current_path / new_name);
+            delete_freqman_index(clipboard_path);
+        }
 
     else if (clipboard_mode == ClipboardMode::Copy)
         result = copy_file(clipboard_path, current_path / new_name);
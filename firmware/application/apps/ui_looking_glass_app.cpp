@@ -36,6 +36,7 @@ void GlassView::focus() {
 }
 
 GlassView::~GlassView() {
+    stop_sweep();
     audio::output::stop();
     receiver_model.set_sampling_rate(3072000);  // Just a hack to avoid hanging other apps
     receiver_model.disable();
@@ -69,24 +70,24 @@ void GlassView::manage_beep_audio() {
     }
 }
 
-void GlassView::get_max_power(const ChannelSpectrum& spectrum, uint8_t bin, uint8_t& max_power) {
+void GlassView::get_max_power(const std::array<uint8_t, SPEC_NB_BINS>& db, uint8_t bin, uint8_t& max_power) {
     if (mode == LOOKING_GLASS_SINGLEPASS) {
         // <20MHz spectrum mode
         if (bin < 120) {
-            if (spectrum.db[SPEC_NB_BINS - 120 + bin] > max_power)
-                max_power = spectrum.db[SPEC_NB_BINS - 120 + bin];
+            if (db[SPEC_NB_BINS - 120 + bin] > max_power)
+                max_power = db[SPEC_NB_BINS - 120 + bin];
         } else {
-            if (spectrum.db[bin - 120] > max_power)
-                max_power = spectrum.db[bin - 120];
+            if (db[bin - 120] > max_power)
+                max_power = db[bin - 120];
         }
     } else {
         // FAST or SLOW mode
         if (bin < 120) {
-            if (spectrum.db[134 + bin] > max_power)
-                max_power = spectrum.db[134 + bin];
+            if (db[134 + bin] > max_power)
+                max_power = db[134 + bin];
         } else {
-            if (spectrum.db[bin - 118] > max_power)
-                max_power = spectrum.db[bin - 118];
+            if (db[bin - 118] > max_power)
+                max_power = db[bin - 118];
         }
     }
 }
@@ -108,13 +109,50 @@ void GlassView::on_marker_change() {
     plot_marker(marker_pixel_index);  // Refresh marker on screen
 }
 
-void GlassView::retune() {
-    // Start a new sweep.
-    // Tune rx for this new slice directly because the model
-    // saves to persistent memory which is slower.
-    radio::set_tuning_frequency(f_center);
-    chThdSleepMilliseconds(5);             // stabilize freq
-    baseband::spectrum_streaming_start();  // Do the RX
+void GlassView::start_sweep() {
+    // The M4 steps through the slices by itself, a SweepThread tunes them.
+    // One spare step covers the pixel rounding, slices past the end of the
+    // line are skipped until the sweep wraps.
+    const rf::Frequency step_count = (looking_glass_range + looking_glass_step - 1) / looking_glass_step + 1;
+    sweep_resync = false;
+    sweep_thread = std::make_unique<SweepThread>(f_center_ini, looking_glass_step);
+    baseband::set_sweep(f_center_ini, looking_glass_step, step_count, sweep_frames_per_step, sweep_settle_us, ++sweep_generation);
+}
+
+void GlassView::stop_sweep() {
+    if (sweep_thread) {
+        baseband::stop_sweep();
+        sweep_thread.reset();
+    }
+}
+
+void GlassView::on_sweep_batch(const SweepBatchMessage& message) {
+    // Batches of an earlier plan may be refilled already, leave them alone.
+    if (message.generation != sweep_generation)
+        return;
+
+    auto& batch = *message.batch;
+    if (sweep_thread) {
+        for (size_t i = 0; i < batch.count; i++) {
+            const auto& spectrum = batch.spectra[i];
+            if (sweep_resync) {
+                if (spectrum.step != 0) continue;
+                sweep_resync = false;
+            }
+            if (process_slice(spectrum.db)) {
+                sweep_resync = true;  // New line, wait for the first slice
+            }
+        }
+    }
+    batch.busy = false;
+}
+
+void GlassView::set_spectrum() {
+    // Blackman-Harris keeps strong signals from leaking over the weak ones next to them.
+    baseband::set_spectrum(
+        looking_glass_bandwidth,
+        trigger,
+        WidebandSpectrumConfigMessage::Window::BlackmanHarris);
 }
 
 void GlassView::reset_live_view() {
@@ -127,12 +165,15 @@ void GlassView::reset_live_view() {
 }
 
 void GlassView::add_spectrum_pixel(uint8_t power) {
-    spectrum_row[pixel_index] = spectrum_rgb3_lut[power];                                                                           // row of colors
+    waterfall.set_level(pixel_index, power);
     spectrum_data[pixel_index] = (live_frequency_integrate * spectrum_data[pixel_index] + power) / (live_frequency_integrate + 1);  // smoothing
     pixel_index++;
 
     if (pixel_index == SCREEN_W)  // got an entire waterfall line
     {
+        if (sweep_logger)
+            log_sweep();
+
         if (live_frequency_view > 0) {
             constexpr int rssi_sample_range = SPEC_NB_BINS;
             constexpr float rssi_voltage_min = 0.4;
@@ -160,20 +201,52 @@ void GlassView::add_spectrum_pixel(uint8_t power) {
             }
             if (last_max_freq != max_freq_hold) {
                 last_max_freq = max_freq_hold;
-                freq_stats.set("MAX HOLD: " + to_string_short_freq(max_freq_hold));
+                freq_stats.set("MAX: " + to_string_short_freq(max_freq_hold));
             }
             plot_marker(marker_pixel_index);
         } else {
-            display.draw_pixels({{0, display.scroll(1)}, {SCREEN_W, 1}}, spectrum_row);  // new line at top, one less var, speedier
+            waterfall.push_line();  // new line at top
         }
         pixel_index = 0;  // Start New cascade line
     }
 }
 
+void GlassView::toggle_logging() {
+    if (sweep_logger) {
+        sweep_logger.reset();
+        button_rec.set_style(nullptr);
+        button_rec.set_text("REC");
+        return;
+    }
+
+    ensure_directory(looking_glass_dir);
+    auto path = next_filename_matching_pattern(looking_glass_dir / u"SWEEP_????.PPS");
+    if (path.empty())
+        return;
+
+    sweep_logger = std::make_unique<SweepLogger>(path);
+    if (sweep_logger->failed()) {
+        sweep_logger.reset();
+        nav_.display_modal("Error", "Can't create\n" + path.string());
+        return;
+    }
+    button_rec.set_style(Theme::getInstance()->fg_red);
+    button_rec.set_text("STOP");
+}
+
+void GlassView::log_sweep() {
+    // One record per line, each level covering marker_pixel_step Hz.
+    const rf::Frequency start = get_freq_from_bin_pos(0);
+    const rf::Frequency last = get_freq_from_bin_pos(SCREEN_W - 1);
+    const uint32_t bin_width = (last - start) / (SCREEN_W - 1);
+    sweep_logger->log(start, last + bin_width, bin_width, sweep_levels.data(), SCREEN_W);
+}
+
 bool GlassView::process_bins(uint8_t* powerlevel) {
     bins_hz_size += each_bin_size;          // add pixel to fulfilled bag of Hz
     if (bins_hz_size >= marker_pixel_step)  // new pixel fullfilled
     {
+        sweep_levels[pixel_index] = *powerlevel;
         if (*powerlevel > min_color_power)
             add_spectrum_pixel(*powerlevel);  // Pixel will represent max_power
         else
@@ -183,12 +256,7 @@ bool GlassView::process_bins(uint8_t* powerlevel) {
         if (!pixel_index)  // Received indication that a waterfall line has been completed
         {
             bins_hz_size = 0;  // Since this is an entire pixel line, we don't carry "Pixels into next bin"
-            if (mode != LOOKING_GLASS_SINGLEPASS) {
-                f_center = f_center_ini;
-                retune();
-            } else
-                baseband::spectrum_streaming_start();
-            return true;  // signal a new line
+            return true;       // signal a new line
         }
         bins_hz_size -= marker_pixel_step;  // reset bins size, but carrying the eventual excess Hz into next pixel
     }
@@ -199,20 +267,25 @@ bool GlassView::process_bins(uint8_t* powerlevel) {
 // Each having the radio signal power for its corresponding frequency slot
 void GlassView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
     baseband::spectrum_streaming_stop();
+    process_slice(spectrum.db);
+    baseband::spectrum_streaming_start();
+}
+
+bool GlassView::process_slice(const std::array<uint8_t, SPEC_NB_BINS>& db) {
     // Convert bins of this spectrum slice into a representative max_power and when enough, into pixels
     // we actually need SCREEN_W (240) of those bins
     for (uint8_t bin = 0; bin < bin_length; bin++) {
-        get_max_power(spectrum, bin, max_power);
+        get_max_power(db, bin, max_power);
         if (max_power > range_max_power)
             range_max_power = max_power;
         // process dc spike if enable
         if (bin == 119) {
             uint8_t next_max_power = 0;
-            get_max_power(spectrum, bin + 1, next_max_power);
+            get_max_power(db, bin + 1, next_max_power);
             for (uint8_t it = 0; it < ignore_dc; it++) {
                 uint8_t med_max_power = (max_power + next_max_power) / 2;  // due to the way process_bins works we have to keep resetting the color
                 if (process_bins(&med_max_power) == true)
-                    return;  // new line signaled, return
+                    return true;  // new line signaled, return
             }
         }
         // process actual bin
@@ -222,28 +295,28 @@ void GlassView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
                 baseband::request_audio_beep(map(range_max_power, 0, 256, 400, 2600), 24000, 250);
             }
             range_max_power = 0;
-            return;  // new line signaled, return
+            return true;  // new line signaled, return
         }
     }
-    if (mode != LOOKING_GLASS_SINGLEPASS) {
-        f_center += looking_glass_step;
-        retune();
-    } else {
-        baseband::spectrum_streaming_start();
-    }
+    return false;
 }
 
 void GlassView::on_hide() {
+    stop_sweep();
     baseband::spectrum_streaming_stop();
-    display.scroll_disable();
+    waterfall.detach();
 }
 
 void GlassView::on_show() {
-    display.scroll_set_area(109, 319);  // Restart scroll on the correct coordinates
+    if (live_frequency_view == 0)
+        waterfall.attach(waterfall_rect);  // Restart scroll on the correct coordinates
     baseband::spectrum_streaming_start();
+    if (mode != LOOKING_GLASS_SINGLEPASS && !sweep_thread)
+        start_sweep();
 }
 
 void GlassView::on_range_changed() {
+    stop_sweep();
     reset_live_view();
     f_min = field_frequency_min.value();
     f_max = field_frequency_max.value();
@@ -295,8 +368,10 @@ void GlassView::on_range_changed() {
 
     receiver_model.set_squelch_level(0);
     f_center = f_center_ini;  // Reset sweep into first slice
-    baseband::set_spectrum(looking_glass_bandwidth, trigger);
+    set_spectrum();
     receiver_model.set_target_frequency(f_center);  // tune rx for this slice
+    if (mode != LOOKING_GLASS_SINGLEPASS)
+        start_sweep();
 }
 
 void GlassView::plot_marker(uint8_t pos) {
@@ -379,6 +454,7 @@ GlassView::GlassView(
                   &field_trigger,
                   &button_jump,
                   &button_rst,
+                  &button_rec,
                   &field_rx_iq_phase_cal,
                   &freq_stats});
 
@@ -434,12 +510,12 @@ GlassView::GlassView(
                 freq_stats.hidden(true);
                 button_jump.hidden(true);
                 button_rst.hidden(true);
-                display.scroll_set_area(109, 319);  // Restart scroll on the correct coordinates.
+                waterfall.attach(waterfall_rect);  // Restart scroll on the correct coordinates.
                 break;
 
             case 1:  // LEVEL
                 display.fill_rectangle({{0, 108}, {SCREEN_W, 24}}, {0, 0, 0});
-                display.scroll_disable();
+                waterfall.detach();
                 level_integration.hidden(false);
                 freq_stats.hidden(false);
                 button_jump.hidden(false);
@@ -449,7 +525,7 @@ GlassView::GlassView(
             case 2:  // PEAK
             default:
                 display.fill_rectangle({{0, 108}, {SCREEN_W, 24}}, {0, 0, 0});
-                display.scroll_disable();
+                waterfall.detach();
                 level_integration.hidden(false);
                 freq_stats.hidden(false);
                 button_jump.hidden(false);
@@ -498,7 +574,7 @@ GlassView::GlassView(
 
     field_trigger.on_change = [this](int32_t v) {
         trigger = v;
-        baseband::set_spectrum(looking_glass_bandwidth, trigger);
+        set_spectrum();
     };
     field_trigger.set_value(trigger);
 
@@ -516,6 +592,10 @@ GlassView::GlassView(
         reset_live_view();
     };
 
+    button_rec.on_select = [this](Button&) {
+        toggle_logging();
+    };
+
     field_rx_iq_phase_cal.set_range(0, hackrf_r9 ? 63 : 31);                 // max2839 has 6 bits [0..63],  max2837 has 5 bits [0..31]
     field_rx_iq_phase_cal.set_value(get_spec_iq_phase_calibration_value());  // using  accessor function of AnalogAudioView to read iq_phase_calibration_value from rx_audio.ini
     field_rx_iq_phase_cal.on_change = [this](int32_t v) {
@@ -523,13 +603,10 @@ GlassView::GlassView(
     };
     set_spec_iq_phase_calibration_value(get_spec_iq_phase_calibration_value());  // initialize iq_phase_calibration in radio
 
-    display.scroll_set_area(109, 319);
-
     // trigger:
-    // Discord User jteich:  WidebandSpectrum::on_message to set the trigger value. In WidebandSpectrum::execute,
-    // it keeps adding the output of the fft to the buffer until "trigger" number of calls are made,
-    // at which time it pushes the buffer up with channel_spectrum.feed
-    baseband::set_spectrum(looking_glass_bandwidth, trigger);
+    // WidebandSpectrum::execute averages the power of windowed, overlapping FFT frames until "trigger" number
+    // of buffers are seen, at which time it pushes the averaged spectrum up with channel_spectrum.feed_power
+    set_spectrum();
 
     marker_pixel_index = SCREEN_W / 2;
     on_range_changed();  // Force a UI update.
@@ -626,6 +703,7 @@ void GlassView::populate_presets() {
 }
 
 void GlassView::launch_audio(rf::Frequency center_freq) {
+    stop_sweep();
     receiver_model.set_target_frequency(center_freq);
     auto settings = receiver_model.settings();
     settings.frequency_step = MHZ_DIV;        // Preset a 1 MHz frequency step into RX -> AUDIO
@@ -30,12 +30,17 @@
 #include "baseband_api.hpp"
 #include "radio_state.hpp"
 #include "receiver_model.hpp"
+#include "ui_waterfall.hpp"
 #include "ui_widget.hpp"
 #include "ui_navigation.hpp"
 #include "ui_receiver.hpp"
 #include "string_format.hpp"
 #include "analog_audio_app.hpp"
 #include "spectrum_color_lut.hpp"
+#include "sweep_logger.hpp"
+#include "sweep_thread.hpp"
+
+#include <memory>
 
 namespace ui {
 
@@ -117,18 +122,24 @@ class GlassView : public View {
     void update_min(int32_t v);
     void update_max(int32_t v);
     void update_range_field();
-    void get_max_power(const ChannelSpectrum& spectrum, uint8_t bin, uint8_t& max_power);
+    void get_max_power(const std::array<uint8_t, SPEC_NB_BINS>& db, uint8_t bin, uint8_t& max_power);
     rf::Frequency get_freq_from_bin_pos(uint8_t pos);
     void on_marker_change();
-    void retune();
+    void start_sweep();
+    void stop_sweep();
+    void on_sweep_batch(const SweepBatchMessage& message);
+    void set_spectrum();
     bool process_bins(uint8_t* powerlevel);
     void on_channel_spectrum(const ChannelSpectrum& spectrum);
+    bool process_slice(const std::array<uint8_t, SPEC_NB_BINS>& db);
     void do_timers();
     int64_t next_mult_of(int64_t num, int64_t multiplier);
     void adjust_range(int64_t* f_min, int64_t* f_max, int64_t width);
     void on_range_changed();
     void reset_live_view();
     void add_spectrum_pixel(uint8_t power);
+    void toggle_logging();
+    void log_sweep();
     void plot_marker(uint8_t pos);
     void load_presets();
     void populate_presets();
@@ -153,10 +164,23 @@ class GlassView : public View {
     uint8_t min_color_power{0};  // Filter cutoff level.
     uint32_t pixel_index{0};
 
-    std::array<Color, SCREEN_W> spectrum_row{};
+    // SPEC view, below the controls down to the bottom line.
+    static constexpr Rect waterfall_rect{0, 109, SCREEN_W, 210};
+    WaterfallSurface waterfall{spectrum_rgb3_lut};
     std::array<uint8_t, SCREEN_W> spectrum_data{};
     ChannelSpectrumFIFO* fifo{};
 
+    // Multi pass views sweep on the M4, see start_sweep().
+    static constexpr uint8_t sweep_frames_per_step = 2;
+    static constexpr uint16_t sweep_settle_us = 1000;
+    std::unique_ptr<SweepThread> sweep_thread{};
+    bool sweep_resync{false};
+    uint32_t sweep_generation{0};
+
+    // Unfiltered levels of the line being drawn, logged to SD while recording.
+    std::array<uint8_t, SCREEN_W> sweep_levels{};
+    std::unique_ptr<SweepLogger> sweep_logger{};
+
     int32_t steps = 1;
     bool locked_range = false;
 
@@ -298,8 +322,12 @@ class GlassView : public View {
         {SCREEN_W - 9 * 8, 5 * 16, 4 * 8, 16},
         "RST"};
 
+    Button button_rec{
+        {SCREEN_W - 14 * 8, 5 * 16, 4 * 8, 16},
+        "REC"};
+
     Text freq_stats{
-        {0 * 8, 5 * 16, SCREEN_W - 10 * 8, 8},
+        {0 * 8, 5 * 16, SCREEN_W - 15 * 8, 8},
         ""};
 
     MessageHandlerRegistration message_handler_spectrum_config{
@@ -320,6 +348,12 @@ class GlassView : public View {
             }
         }};
 
+    MessageHandlerRegistration message_handler_sweep_batch{
+        Message::ID::SweepBatch,
+        [this](Message* const p) {
+            this->on_sweep_batch(*static_cast<const SweepBatchMessage*>(p));
+        }};
+
     MessageHandlerRegistration message_handler_freqchg{
         Message::ID::FreqChangeCommand,
         [this](Message* const p) {
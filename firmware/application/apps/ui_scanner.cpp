@@ -27,6 +27,8 @@
 #include "ui_fileman.hpp"
 #include "ui_freqman.hpp"
 #include "file_path.hpp"
+#include "portapack_shared_memory.hpp"
+#include "radio.hpp"
 
 using namespace portapack;
 namespace fs = std::filesystem;
@@ -100,51 +102,144 @@ void ScannerThread::set_scanning_direction(bool fwd) {
     }
 }
 
+void ScannerThread::set_statistics_epoch(const uint32_t v) {
+    _statistics_epoch = v;
+}
+
+void ScannerThread::set_batch_scan(const bool v) {
+    _batch_scan = v;
+}
+
+bool ScannerThread::is_probing() {
+    return _probing;
+}
+
+void ScannerThread::set_batch_statistics(const uint32_t epoch, const uint32_t active) {
+    _batch_active = active;
+    _batch_epoch = epoch;
+}
+
 msg_t ScannerThread::static_fn(void* arg) {
     auto obj = static_cast<ScannerThread*>(arg);
     obj->run();
     return 0;
 }
 
+// Retune and have the channel statistics restart once the synthesizers settled.
+// Set the retune_channel_* fields before to measure channel_count channels.
+void ScannerThread::retune(const rf::Frequency frequency, const size_t channel_count) {
+    const auto first_lo = radio::first_lo_frequency();
+    receiver_model.set_target_frequency(frequency);
+
+    shared_memory.retune_channel_count = channel_count;
+    shared_memory.retune_settle_us = scanner::settle_us(radio::first_lo_frequency() != first_lo);
+    shared_memory.retune_window_us = scanner::probe_window_us;
+    shared_memory.retune_epoch = shared_memory.retune_epoch + 1;
+}
+
+// Wait for the first statistics taken after the retune. By then the view has
+// decided whether to lock onto the channel. Times out for modes without them.
+void ScannerThread::wait_for_statistics() {
+    const uint32_t epoch = shared_memory.retune_epoch;
+    for (uint32_t ms = 0; ms < SCANNER_SLEEP_MS && !chThdShouldTerminate(); ms++) {
+        if (_statistics_epoch == epoch)
+            return;
+        chThdSleepMilliseconds(1);
+    }
+}
+
+// Tells whether the channel at position is worth tuning to. The first time a
+// batch of channels is reached, all of them are measured from one tune.
+bool ScannerThread::is_channel_active(const scanner::ScanSchedule& schedule, const size_t position) {
+    const auto b = schedule.batch_of(position);
+    const auto& batch = schedule.batch(b);
+    if (batch.count < 2)
+        return true;  // Nothing to gain, tune to it directly.
+
+    if (b != probed_batch_) {
+        for (size_t i = 0; i < batch.count; i++)
+            shared_memory.retune_channel_offsets[i] = frequency_list_[schedule.index(batch.first + i)] - batch.center;
+        shared_memory.retune_channel_spacing = batch.spacing;
+
+        _probing = true;
+        retune(batch.center, batch.count);
+
+        RetuneMessage message{};  // Show where the scan is while skipping quiet channels
+        message.freq = frequency_list_[schedule.index(batch.first)];
+        message.range = schedule.index(batch.first);
+        EventDispatcher::send_message(message);
+
+        const uint32_t epoch = shared_memory.retune_epoch;
+        probed_active_ = UINT32_MAX;  // No answer, visit every channel.
+        for (uint32_t ms = 0; ms < SCANNER_SLEEP_MS && !chThdShouldTerminate(); ms++) {
+            if (_batch_epoch == epoch) {
+                probed_active_ = _batch_active;
+                break;
+            }
+            chThdSleepMilliseconds(1);
+        }
+        _probing = false;
+        probed_batch_ = b;
+    }
+
+    return probed_active_ & (1U << (position - batch.first));
+}
+
 void ScannerThread::run() {
     RetuneMessage message{};
 
     if (!_manual_search && frequency_list_.size()) {  // IF NOT MANUAL MODE AND THERE IS A FREQUENCY LIST ...
-        int32_t size = frequency_list_.size();
-        int32_t frequency_index = (_stepper > 0) ? size : 0;  // Forcing wraparound to starting frequency on 1st pass
+        // Scan by frequency so that neighbouring channels share the first LO.
+        scanner::ScanSchedule schedule{frequency_list_};
+        int32_t size = schedule.size();
+        int32_t position = (_stepper > 0) ? size : 0;  // Forcing wraparound to starting frequency on 1st pass
 
         while (!chThdShouldTerminate()) {
             bool force_one_step = (_index_stepper != 0);
             int32_t step = force_one_step ? _index_stepper : _stepper;  //_index_stepper direction takes priority
+            bool retuned = false;
+
+            if (size == 0) {  // Everything deleted
+                chThdSleepMilliseconds(SCANNER_SLEEP_MS);
+                continue;
+            }
 
             if (_scanning || force_one_step) {              // Scanning, or paused and using rotary encoder
                 if ((_freq_lock == 0) || force_one_step) {  // normal scanning (not performing freq_lock)
-                    frequency_index += step;
-                    if (frequency_index >= size)  // Wrap
-                        frequency_index = 0;
-                    else if (frequency_index < 0)
-                        frequency_index = size - 1;
+                    position += step;
+                    if (position >= size || position < 0) {  // Wrap
+                        position = (position < 0) ? size - 1 : 0;
+                        probed_batch_ = SIZE_MAX;  // Measure again on the next pass
+                    }
 
                     if (force_one_step)
                         _index_stepper = 0;
+                    else if (_batch_scan && !is_channel_active(schedule, position))
+                        continue;  // Quiet, skip without tuning to it
 
-                    receiver_model.set_target_frequency(frequency_list_[frequency_index]);  // Retune
+                    retune(frequency_list_[schedule.index(position)]);
+                    retuned = true;
                 }
-                message.freq = frequency_list_[frequency_index];
-                message.range = frequency_index;  // Inform freq (for coloring purposes also!)
+                message.freq = frequency_list_[schedule.index(position)];
+                message.range = schedule.index(position);  // Inform freq (for coloring purposes also!)
                 EventDispatcher::send_message(message);
             } else if (_freq_del != 0) {                    // There is a frequency to delete
                 for (int32_t i = 0; i < size; i++) {        // Search for the freq to delete
                     if (frequency_list_[i] == _freq_del) {  // found: Erase it
                         frequency_list_.erase(frequency_list_.begin() + i);
-                        size = frequency_list_.size();
+                        schedule = scanner::ScanSchedule{frequency_list_};
+                        size = schedule.size();
+                        probed_batch_ = SIZE_MAX;
                         break;
                     }
                 }
                 _freq_del = 0;  // deleted.
             }
 
-            chThdSleepMilliseconds(SCANNER_SLEEP_MS);  // Needed to (eventually) stabilize the receiver into new freq
+            if (retuned)
+                wait_for_statistics();
+            else
+                chThdSleepMilliseconds(SCANNER_SLEEP_MS);
         }
     } else if (_manual_search && (def_step_hz_ > 0))  // manual search range mode
     {
@@ -154,6 +249,7 @@ void ScannerThread::run() {
         while (!chThdShouldTerminate()) {
             bool force_one_step = (_index_stepper != 0);
             int32_t step = force_one_step ? _index_stepper : _stepper;  //_index_stepper direction takes priority
+            bool retuned = false;
 
             if (_scanning || force_one_step) {              // Scanning, or paused and using rotary encoder
                 if ((_freq_lock == 0) || force_one_step) {  // normal scanning (not performing freq_lock)
@@ -166,14 +262,18 @@ void ScannerThread::run() {
                     if (force_one_step)
                         _index_stepper = 0;
 
-                    receiver_model.set_target_frequency(frequency_range_.min + frequency_index * def_step_hz_);  // Retune
+                    retune(frequency_range_.min + frequency_index * def_step_hz_);
+                    retuned = true;
                 }
                 message.freq = frequency_range_.min + frequency_index * def_step_hz_;
                 message.range = 0;  // Inform freq (for coloring purposes also!)
                 EventDispatcher::send_message(message);
             }
 
-            chThdSleepMilliseconds(SCANNER_SLEEP_MS);  // Needed to (eventually) stabilize the receiver into new freq
+            if (retuned)
+                wait_for_statistics();
+            else
+                chThdSleepMilliseconds(SCANNER_SLEEP_MS);
         }
     }
 }
@@ -625,6 +725,11 @@ void ScannerView::update_squelch_while_paused(int32_t max_db) {
 }
 
 void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
+    // Measured before the last retune, or the scanner thread is measuring a
+    // batch of channels and this is none of them.
+    if (statistics.epoch != shared_memory.retune_epoch || (scan_thread && scan_thread->is_probing()))
+        return;
+
     if (userpause) {
         update_squelch_while_paused(statistics.max_db);
     } else if (scan_thread)  // Scanning not user-paused
@@ -667,6 +772,21 @@ void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
             }
         }
     }
+
+    // Let the scanner thread move on, the lock decision is made.
+    if (scan_thread)
+        scan_thread->set_statistics_epoch(statistics.epoch);
+}
+
+void ScannerView::on_batch_statistics_update(const MultiChannelStatistics& statistics) {
+    uint32_t active = 0;
+    for (size_t i = 0; i < statistics.channel_count; i++) {
+        if (statistics.max_db[i] > squelch)
+            active |= 1U << i;
+    }
+
+    if (scan_thread)
+        scan_thread->set_batch_statistics(statistics.epoch, active);
 }
 
 void ScannerView::scan_pause() {
@@ -750,6 +870,10 @@ void ScannerView::start_scan_thread() {
             frequency_list.push_back(entry.freq);
 
         scan_thread = std::make_unique<ScannerThread>(std::move(frequency_list));
+
+        // The NFM and AM basebands can measure several channels at once.
+        const auto mode = receiver_model.modulation();
+        scan_thread->set_batch_scan(mode == ReceiverModel::Mode::NarrowbandFMAudio || mode == ReceiverModel::Mode::AMAudio);
     }
 
     scan_thread->set_scanning_direction(fwd);
@@ -30,14 +30,15 @@
 #include "portapack_persistent_memory.hpp"
 #include "radio_state.hpp"
 #include "receiver_model.hpp"
+#include "scanner_schedule.hpp"
 #include "string_format.hpp"
 #include "ui.hpp"
 #include "ui_mictx.hpp"
 #include "ui_receiver.hpp"
 
-#define SCANNER_SLEEP_MS 50  // ms that Scanner Thread sleeps per loop
+#define SCANNER_SLEEP_MS 50  // ms that Scanner Thread sleeps per loop when not scanning, and longest wait for statistics after a retune
 #define STATISTICS_UPDATES_PER_SEC 10
-#define MAX_FREQ_LOCK 10  // # of 50ms cycles scanner locks into freq when signal detected, to verify signal is not spurious
+#define MAX_FREQ_LOCK 10  // # of statistics updates scanner locks into freq when signal detected, to verify signal is not spurious
 
 namespace ui {
 
@@ -75,6 +76,17 @@ class ScannerThread {
     void set_index_stepper(const int32_t v);
     void set_scanning_direction(bool fwd);
 
+    /* Called with each ChannelStatistics once the view has acted on it. */
+    void set_statistics_epoch(const uint32_t v);
+
+    /* Measure neighbouring list channels at once from one tune. */
+    void set_batch_scan(const bool v);
+    bool is_probing();
+
+    /* Called with each MultiChannelStatistics, bit n set when the n-th
+     * channel of the batch is above squelch. */
+    void set_batch_statistics(const uint32_t epoch, const uint32_t active);
+
     void stop();
 
     ScannerThread(const ScannerThread&) = delete;
@@ -95,8 +107,18 @@ class ScannerThread {
     uint32_t _freq_idx{0};
     int32_t _stepper{1};
     int32_t _index_stepper{0};
+    uint32_t _statistics_epoch{0};
+    bool _batch_scan{false};
+    volatile bool _probing{false};
+    volatile uint32_t _batch_epoch{0};
+    volatile uint32_t _batch_active{0};
+    size_t probed_batch_{SIZE_MAX};
+    uint32_t probed_active_{0};
     static msg_t static_fn(void* arg);
     void run();
+    void retune(const rf::Frequency frequency, const size_t channel_count = 0);
+    void wait_for_statistics();
+    bool is_channel_active(const scanner::ScanSchedule& schedule, const size_t position);
     void create_thread();
 };
 
@@ -145,6 +167,7 @@ class ScannerView : public View {
     void bigdisplay_update(int32_t);
     void update_squelch_while_paused(int32_t max_db);
     void on_statistics_update(const ChannelStatistics& statistics);
+    void on_batch_statistics_update(const MultiChannelStatistics& statistics);
     void handle_retune(int64_t freq, uint32_t freq_idx);
     void handle_encoder(EncoderEvent delta);
     std::string loaded_filename() const;
@@ -313,6 +336,12 @@ class ScannerView : public View {
         [this](const Message* const p) {
             this->on_statistics_update(static_cast<const ChannelStatisticsMessage*>(p)->statistics);
         }};
+
+    MessageHandlerRegistration message_handler_batch_stats{
+        Message::ID::MultiChannelStatistics,
+        [this](const Message* const p) {
+            this->on_batch_statistics_update(static_cast<const MultiChannelStatisticsMessage*>(p)->statistics);
+        }};
 };
 
 } /* namespace ui */
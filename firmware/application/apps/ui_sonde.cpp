@@ -116,9 +116,10 @@ SondeView::SondeView(NavigationView& nav)
     // inject a PitchRSSIConfigureMessage in order to arm
     // the pitch rssi events that will be used by the
     // processor:
-    const PitchRSSIConfigureMessage message{true, 0};
+    PitchRSSIConfigureMessage message{true, 0};
 
-    shared_memory.application_queue.push(message);
+    // The M4 is the only writer of application_queue, use the local queue.
+    EventDispatcher::send_message(message);
 
     baseband::set_pitch_rssi(0, true);
 }
@@ -216,7 +216,9 @@ void set_audiotx_config(
     const bool am_enabled,
     const bool dsb_enabled,
     const bool usb_enabled,
-    const bool lsb_enabled) {
+    const bool lsb_enabled,
+    const uint8_t channels,
+    const bool interpolate) {
     const AudioTXConfigMessage message{
         divider,
         deviation_hz,
@@ -228,7 +230,9 @@ void set_audiotx_config(
         am_enabled,
         dsb_enabled,
         usb_enabled,
-        lsb_enabled};
+        lsb_enabled,
+        channels,
+        interpolate};
     send_message(&message);
 }
 
@@ -298,9 +302,34 @@ void set_rds_data(const uint16_t message_length) {
     send_message(&message);
 }
 
-void set_spectrum(const size_t sampling_rate, const size_t trigger) {
+void set_spectrum(
+    const size_t sampling_rate,
+    const size_t trigger,
+    const WidebandSpectrumConfigMessage::Window window,
+    const uint8_t overlap_log2,
+    const WidebandSpectrumConfigMessage::Detector detector) {
     const WidebandSpectrumConfigMessage message{
-        sampling_rate, trigger};
+        sampling_rate, trigger, window, overlap_log2, detector};
+    send_message(&message);
+}
+
+void set_sweep(const int64_t first_frequency, const uint32_t step, const uint16_t step_count, const uint8_t frames_per_step, const uint16_t settle_us, const uint32_t generation) {
+    const SweepConfigMessage message{
+        first_frequency, step, step_count, frames_per_step, settle_us, generation};
+    send_message(&message);
+}
+
+void stop_sweep() {
+    set_sweep(0, 0, 0, 0, 0, 0);
+}
+
+void set_channelizer(const uint32_t sampling_rate, const std::vector<uint8_t>& selected) {
+    std::array<uint8_t, ChannelizerConfigMessage::max_selected> channels{};
+    const size_t count = std::min(selected.size(), channels.size());
+    std::copy_n(selected.begin(), count, channels.begin());
+
+    const ChannelizerConfigMessage message{
+        sampling_rate, channels, count};
     send_message(&message);
 }
 
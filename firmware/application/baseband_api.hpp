@@ -32,6 +32,7 @@
 #include "spi_image.hpp"
 
 #include <cstddef>
+#include <vector>
 
 namespace baseband {
 
@@ -63,7 +64,7 @@ void set_tone(const uint32_t index, const uint32_t delta, const uint32_t duratio
 void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint16_t tone_count, const bool dual_tone, const bool audio_out);
 void kill_tone();
 void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration);
-void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain, uint8_t audio_shift_bits_s16, uint8_t bits_per_sample, const uint32_t tone_key_delta, const bool am_enabled, const bool dsb_enabled, const bool usb_enabled, const bool lsb_enabled);
+void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain, uint8_t audio_shift_bits_s16, uint8_t bits_per_sample, const uint32_t tone_key_delta, const bool am_enabled, const bool dsb_enabled, const bool usb_enabled, const bool lsb_enabled, const uint8_t channels = 1, const bool interpolate = false);
 void set_fifo_data(const int8_t* data);
 void set_pitch_rssi(int32_t avg, bool enabled);
 void set_afsk_data(const uint32_t afsk_samples_per_bit, const uint32_t afsk_phase_inc_mark, const uint32_t afsk_phase_inc_space, const uint8_t afsk_repeat, const uint32_t afsk_bw, const uint8_t symbol_count);
@@ -84,7 +85,15 @@ void set_pocsag();
 void set_adsb();
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
-void set_spectrum(const size_t sampling_rate, const size_t trigger);
+void set_spectrum(
+    const size_t sampling_rate,
+    const size_t trigger,
+    const WidebandSpectrumConfigMessage::Window window = WidebandSpectrumConfigMessage::Window::Hann,
+    const uint8_t overlap_log2 = 1,
+    const WidebandSpectrumConfigMessage::Detector detector = WidebandSpectrumConfigMessage::Detector::Average);
+void set_sweep(const int64_t first_frequency, const uint32_t step, const uint16_t step_count, const uint8_t frames_per_step, const uint16_t settle_us, const uint32_t generation);
+void stop_sweep();
+void set_channelizer(const uint32_t sampling_rate, const std::vector<uint8_t>& selected);
 void set_siggen_tone(const uint32_t tone);
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
 void set_spectrum_painter_config(const uint16_t width, const uint16_t height, bool update, int32_t bw);
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+
+#include "ble_hop_schedule.hpp"
+
+namespace ble {
+
+static size_t channel_slot(uint8_t channel) {
+    return channel - advertising_channels[0];
+}
+
+void HopSchedule::restart() {
+    elapsed_us_ = 0;
+    index_ = 0;
+}
+
+bool HopSchedule::advance(uint32_t elapsed_us) {
+    elapsed_us_ += elapsed_us;
+    if (elapsed_us_ < dwell_us_)
+        return false;
+
+    elapsed_us_ = 0;
+    index_ = (index_ + 1) % advertising_channels.size();
+    return true;
+}
+
+void ChannelStatistics::add(uint8_t channel, uint32_t packets, uint32_t crc_errors) {
+    const auto slot = channel_slot(channel);
+    if (slot >= counters_.size())
+        return;
+
+    counters_[slot].packets += packets;
+    counters_[slot].crc_errors += crc_errors;
+}
+
+void ChannelStatistics::clear() {
+    counters_ = {};
+}
+
+ChannelCounters ChannelStatistics::counters(uint8_t channel) const {
+    const auto slot = channel_slot(channel);
+    return slot < counters_.size() ? counters_[slot] : ChannelCounters{};
+}
+
+} /* namespace ble */
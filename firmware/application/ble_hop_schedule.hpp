@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+
+#ifndef __BLE_HOP_SCHEDULE_H__
+#define __BLE_HOP_SCHEDULE_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// NB: Don't include UI or radio headers to keep this code unit testable.
+
+namespace ble {
+
+constexpr std::array<uint8_t, 3> advertising_channels{37, 38, 39};
+
+/* Cycles the advertising channels in order, like a scanning phone does,
+ * staying dwell_ms on each. Driven by the caller's clock. */
+class HopSchedule {
+   public:
+    void set_dwell_ms(uint32_t dwell_ms) { dwell_us_ = dwell_ms * 1000; }
+    uint32_t dwell_ms() const { return dwell_us_ / 1000; }
+
+    /* Back to the first channel with a full dwell ahead. */
+    void restart();
+
+    /* Accounts elapsed_us, true when the dwell is over and channel() moved
+     * on. A late call hops once, the new channel gets a full dwell. */
+    bool advance(uint32_t elapsed_us);
+
+    uint8_t channel() const { return advertising_channels[index_]; }
+
+   private:
+    uint32_t dwell_us_{100'000};
+    uint32_t elapsed_us_{0};
+    size_t index_{0};
+};
+
+struct ChannelCounters {
+    uint32_t packets{0};     // With a good CRC
+    uint32_t crc_errors{0};  // Sane header but a bad CRC
+};
+
+/* Packets per advertising channel, as reported by the baseband. */
+class ChannelStatistics {
+   public:
+    /* Counts for other channels are dropped. */
+    void add(uint8_t channel, uint32_t packets, uint32_t crc_errors);
+    void clear();
+
+    /* Zeros for a channel that is not an advertising one. */
+    ChannelCounters counters(uint8_t channel) const;
+
+   private:
+    std::array<ChannelCounters, advertising_channels.size()> counters_{};
+};
+
+} /* namespace ble */
+
+#endif /*__BLE_HOP_SCHEDULE_H__*/
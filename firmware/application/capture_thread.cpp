@@ -77,6 +77,8 @@ Optional<File::Error> CaptureThread::run() {
 
     while (!chThdShouldTerminate()) {
         auto buffer = buffers.get();
+        // Buffers are whole sectors, so for raw captures FatFs transfers
+        // straight from the shared buffer without staging it in the FIL.
         auto write_result = writer->write(buffer->data(), buffer->size());
         if (write_result.is_error()) {
             return write_result.error();
@@ -24,72 +24,57 @@
 #include "database.hpp"
 #include "file.hpp"
 #include "file_path.hpp"
-#include <cstring>
 
 int database::retrieve_mid_record(MidDBRecord* record, std::string search_term) {
-    file_path = ais_dir / u"mids.db";
-    index_item_length = 4;
-    record_length = 32;
-
-    result = retrieve_record(file_path, index_item_length, record_length, record, search_term);
-
-    return (result);
+    return retrieve_record(ais_dir / u"mids.db", 4, sizeof(MidDBRecord), record, search_term);
 }
 
 int database::retrieve_airline_record(AirlinesDBRecord* record, std::string search_term) {
-    file_path = adsb_dir / u"airlines.db";
-    index_item_length = 4;
-    record_length = 64;
-
-    result = retrieve_record(file_path, index_item_length, record_length, record, search_term);
-
-    return (result);
+    return retrieve_record(adsb_dir / u"airlines.db", 4, sizeof(AirlinesDBRecord), record, search_term);
 }
 
 int database::retrieve_aircraft_record(AircraftDBRecord* record, std::string search_term) {
-    file_path = adsb_dir / u"icao24.db";
-    index_item_length = 7;
-    record_length = 146;
+    return retrieve_record(adsb_dir / u"icao24.db", 7, sizeof(AircraftDBRecord), record, search_term);
+}
 
-    result = retrieve_record(file_path, index_item_length, record_length, record, search_term);
+int database::retrieve_record(const std::filesystem::path& path, size_t index_item_length, size_t record_length, void* record, const std::string& search_term) {
+    if (search_term.empty() || search_term.length() > index_item_length)
+        return DATABASE_RECORD_NOT_FOUND;
+
+    if (!is_open || !(path == file_path)) {
+        if (!open_database(path, index_item_length, record_length))
+            return DATABASE_NOT_FOUND;
+    }
 
-    return (result);
+    const auto result = index.lookup(db_file, search_term, record);
+    if (result == DATABASE_NOT_FOUND) {
+        // Read error, most likely the SD card went away; reopen on the next lookup.
+        close_database();
+    }
+    return result;
 }
 
-int database::retrieve_record(std::filesystem::path file_path, int index_item_length, int record_length, void* record, std::string search_term) {
-    if (search_term.empty())
-        return DATABASE_RECORD_NOT_FOUND;
+bool database::open_database(const std::filesystem::path& path, size_t index_item_length, size_t record_length) {
+    close_database();
 
-    auto result = db_file.open(file_path);
-    if (!result.is_valid()) {
-        number_of_records = (db_file.size() / (index_item_length + record_length));  // determine number of records in file
-                                                                                     // binary search tree
-        int first = 0,                                                               // First search element
-            last = number_of_records - 1,                                            // Last search element
-            middle,                                                                  // Mid point of search
-            position = -1;                                                           // Position of search value
+    auto error = db_file.open(path);
+    if (error.is_valid())
+        return false;
 
-        while (!found && first <= last) {
-            middle = (first + last) / 2;  // Calculate mid point
-            db_file.seek(middle * index_item_length);
-            db_file.read(file_buffer, search_term.length());
-            if (file_buffer == search_term) {  // If value is found at mid
-                found = true;
-                position = middle;
-            } else if (file_buffer > search_term)  // If value is in lower half
-                last = middle - 1;
-            else
-                first = middle + 1;  // If value is in upper half
-        }
+    if (!index.open(db_file, index_item_length, record_length)) {
+        db_file.close();
+        return false;
+    }
 
-        if (found == true) {
-            db_file.seek((number_of_records * index_item_length) + (position * record_length));  // seek starting after index
-            db_file.read(record, record_length);
-            return (DATABASE_RECORD_FOUND);
-        } else {
-            return (DATABASE_RECORD_NOT_FOUND);
-        }
+    file_path = path;
+    is_open = true;
+    return true;
+}
 
-    } else
-        return (DATABASE_NOT_FOUND);
+void database::close_database() {
+    if (is_open)
+        db_file.close();
+    is_open = false;
+    file_path = {};
+    index.close();
 }
@@ -24,18 +24,18 @@
 #ifndef __DATABASE_H__
 #define __DATABASE_H__
 
-#include <cstddef>
-#include <cstdint>
 #include <string>
 
 #include "file.hpp"
+#include "database_index.hpp"
 
+/* Lookup into the sorted .db files generated by the tools/make_*_db scripts.
+ *
+ * A database object keeps its file open between lookups and remembers the
+ * last few results in its DatabaseIndex, so it should be kept alive for as
+ * long as the owning app runs rather than created per lookup. */
 class database {
    public:
-#define DATABASE_RECORD_FOUND 0       // record found in database
-#define DATABASE_NOT_FOUND -1         // database not found / could not be opened
-#define DATABASE_RECORD_NOT_FOUND -2  // record could not be found in database
-
     struct MidDBRecord {
         char country[32];  // country name
     };
@@ -61,20 +61,14 @@ class database {
     int retrieve_aircraft_record(AircraftDBRecord* record, std::string search_term);
 
    private:
-    std::filesystem::path file_path = "";  // path including filename
-    int index_item_length = 0;             // length of index item
-    int record_length = 0;                 // length of record
-
+    std::filesystem::path file_path{};  // path of the currently open database
     File db_file{};
-    int number_of_records = 0;
-    int position = 0;
-
-    char file_buffer[32]{0};
-    bool found = false;
-
-    int result = 0;
+    bool is_open{false};
+    DatabaseIndex<File> index{};
 
-    int retrieve_record(std::filesystem::path file_path, int index_item_length, int record_length, void* record, std::string search_term);
+    int retrieve_record(const std::filesystem::path& path, size_t index_item_length, size_t record_length, void* record, const std::string& search_term);
+    bool open_database(const std::filesystem::path& path, size_t index_item_length, size_t record_length);
+    void close_database();
 };
 
 #endif /*__DATABASE_H__*/
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DATABASE_INDEX_H__
+#define __DATABASE_INDEX_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#define DATABASE_RECORD_FOUND 0       // record found in database
+#define DATABASE_NOT_FOUND -1         // database not found / could not be opened
+#define DATABASE_RECORD_NOT_FOUND -2  // record could not be found in database
+
+/* Key search and record cache over an open .db file, see database.
+ * TFile is File on the device and MockFile in the tests.
+ *
+ * Files carrying the "PPDB" header provide a prefix bucket table that is
+ * loaded by open() and narrows each search to a single bucket; files
+ * without a header are searched over the full key index. The last few
+ * results, hits and misses, are kept in a small LRU. */
+template <typename TFile>
+class DatabaseIndex {
+   public:
+    /* Header written in front of the key index by the db tools (all fields little endian). */
+    struct FileHeader {
+        char magic[4];           // "PPDB"
+        uint16_t version;        // header_version
+        uint16_t key_length;     // length of index item
+        uint16_t record_length;  // length of record
+        uint16_t bucket_count;   // number of prefix buckets, followed by bucket_count + 1 uint32_t record indices
+        uint32_t record_count;   // number of records
+    };
+    static_assert(sizeof(FileHeader) == 16, "FileHeader must match the on-disk layout");
+
+    static constexpr uint16_t header_version = 1;
+    static constexpr size_t bucket_count = 256;
+    static constexpr size_t cache_slots = 8;
+    static constexpr size_t key_length_max = 8;
+
+    /* Bucket of a key, from its first two characters. Monotonic in the
+     * key's sort order so each bucket covers one contiguous record range. */
+    static size_t bucket_of(const char* key, size_t length) {
+        const char c0 = (length > 0) ? key[0] : 0;
+        const char c1 = (length > 1) ? key[1] : 0;
+        return (bucket_nibble(c0) << 4) | bucket_nibble(c1);
+    }
+
+    /* Reads the header, if any, of a file positioned at its start. False
+     * when the header doesn't match the expected layout. */
+    bool open(TFile& file, size_t index_item_length, size_t record_length) {
+        close();
+
+        if (index_item_length > key_length_max || index_item_length > window_size)
+            return false;
+
+        this->index_item_length = index_item_length;
+        this->record_length = record_length;
+        index_offset = 0;
+        number_of_records = file.size() / (index_item_length + record_length);
+
+        FileHeader header{};
+        auto read_result = file.read(&header, sizeof(header));
+        if (read_result.is_ok() && *read_result == sizeof(header) &&
+            memcmp(header.magic, "PPDB", sizeof(header.magic)) == 0) {
+            if (header.version != header_version ||
+                header.key_length != index_item_length ||
+                header.record_length != record_length ||
+                header.bucket_count != bucket_count) {
+                return false;
+            }
+
+            const size_t table_size = (bucket_count + 1) * sizeof(uint32_t);
+            buckets = std::make_unique<uint32_t[]>(bucket_count + 1);
+            read_result = file.read(buckets.get(), table_size);
+            if (read_result.is_error() || *read_result != table_size) {
+                buckets.reset();
+                return false;
+            }
+
+            number_of_records = header.record_count;
+            index_offset = sizeof(header) + table_size;
+        }
+
+        cache_data = std::make_unique<uint8_t[]>(cache_slots * (key_length_max + record_length));
+        return true;
+    }
+
+    void close() {
+        buckets.reset();
+        cache_data.reset();
+        for (auto& slot : cache)
+            slot = {};
+        cache_clock = 0;
+    }
+
+    /* DATABASE_RECORD_FOUND or DATABASE_RECORD_NOT_FOUND, DATABASE_NOT_FOUND
+     * when the file can't be read. search_term is at most index_item_length. */
+    int lookup(TFile& file, const std::string& search_term, void* record) {
+        auto result = cache_lookup(search_term, record);
+        if (result != DATABASE_NOT_FOUND)
+            return result;
+
+        uint32_t position = 0;
+        if (!find_record(file, search_term, position)) {
+            result = DATABASE_RECORD_NOT_FOUND;
+        } else if (read_record(file, position, record)) {
+            result = DATABASE_RECORD_FOUND;
+        } else {
+            return DATABASE_NOT_FOUND;
+        }
+
+        cache_store(search_term, result, record);
+        return result;
+    }
+
+   private:
+    size_t index_item_length{0};  // length of index item
+    size_t record_length{0};      // length of record
+    uint32_t number_of_records{0};
+    uint32_t index_offset{0};  // file offset of the key index
+
+    /* First record index of each bucket, bucket_count + 1 entries; empty for files without header. */
+    std::unique_ptr<uint32_t[]> buckets{};
+
+    /* Recently looked up keys, each slot holding key_length_max + record_length bytes. */
+    struct CacheSlot {
+        uint32_t last_used;
+        int result;
+    };
+    CacheSlot cache[cache_slots]{};
+    std::unique_ptr<uint8_t[]> cache_data{};
+    uint32_t cache_clock{0};
+
+    /* Keys of the final search range are read in one go. */
+    static constexpr size_t window_size = 256;
+    char key_window[window_size]{0};
+
+    /* Hex digits map to their value, anything sorting before '0' to 0, between
+     * '9' and 'A' to 9 and after 'F' to 15, which keeps the mapping monotonic. */
+    static size_t bucket_nibble(const char c) {
+        if (c < '0') return 0;
+        if (c <= '9') return c - '0';
+        if (c < 'A') return 9;
+        if (c <= 'F') return c - 'A' + 10;
+        return 15;
+    }
+
+    bool find_record(TFile& file, const std::string& search_term, uint32_t& position) {
+        // Keys are NUL padded to the index item length in the file.
+        char key[key_length_max]{0};
+        memcpy(key, search_term.data(), search_term.length());
+
+        uint32_t first = 0;
+        uint32_t last = number_of_records;  // one past the last candidate
+        if (buckets) {
+            const auto bucket = bucket_of(key, index_item_length);
+            // A damaged table must not send the search past the records.
+            last = std::min(buckets[bucket + 1], number_of_records);
+            first = std::min(buckets[bucket], last);
+        }
+
+        // Narrow down with single key reads until the range fits the window.
+        const uint32_t window_items = window_size / index_item_length;
+        while (last - first > window_items) {
+            const uint32_t middle = first + (last - first) / 2;
+            file.seek(index_offset + middle * index_item_length);
+            auto read_result = file.read(key_window, index_item_length);
+            if (read_result.is_error() || *read_result != index_item_length)
+                return false;
+
+            const auto cmp = memcmp(key_window, key, index_item_length);
+            if (cmp == 0) {
+                position = middle;
+                return true;
+            } else if (cmp > 0)
+                last = middle;
+            else
+                first = middle + 1;
+        }
+
+        if (first >= last)
+            return false;
+
+        // Then read the remaining keys at once and search them in memory.
+        const size_t window_length = (last - first) * index_item_length;
+        file.seek(index_offset + first * index_item_length);
+        auto read_result = file.read(key_window, window_length);
+        if (read_result.is_error() || *read_result != window_length)
+            return false;
+
+        for (uint32_t i = 0; i < last - first; i++) {
+            const auto cmp = memcmp(&key_window[i * index_item_length], key, index_item_length);
+            if (cmp == 0) {
+                position = first + i;
+                return true;
+            } else if (cmp > 0)
+                break;
+        }
+
+        return false;
+    }
+
+    bool read_record(TFile& file, uint32_t position, void* record) {
+        file.seek(index_offset + (number_of_records * index_item_length) + (position * record_length));  // seek starting after index
+        auto read_result = file.read(record, record_length);
+        return read_result.is_ok() && *read_result == record_length;
+    }
+
+    int cache_lookup(const std::string& search_term, void* record) {
+        const size_t slot_length = key_length_max + record_length;
+
+        for (size_t i = 0; i < cache_slots; i++) {
+            auto& slot = cache[i];
+            if (slot.last_used == 0)
+                continue;
+
+            const auto slot_data = &cache_data[i * slot_length];
+            if (strncmp(reinterpret_cast<const char*>(slot_data), search_term.c_str(), key_length_max) == 0) {
+                slot.last_used = ++cache_clock;
+                if (slot.result == DATABASE_RECORD_FOUND)
+                    memcpy(record, slot_data + key_length_max, record_length);
+                return slot.result;
+            }
+        }
+
+        return DATABASE_NOT_FOUND;
+    }
+
+    void cache_store(const std::string& search_term, int result, const void* record) {
+        const size_t slot_length = key_length_max + record_length;
+
+        // Take an empty slot, or else the least recently used one.
+        size_t victim = 0;
+        for (size_t i = 1; i < cache_slots; i++) {
+            if (cache[i].last_used < cache[victim].last_used)
+                victim = i;
+        }
+
+        auto slot_data = &cache_data[victim * slot_length];
+        memset(slot_data, 0, slot_length);
+        memcpy(slot_data, search_term.data(), search_term.length());
+        if (result == DATABASE_RECORD_FOUND)
+            memcpy(slot_data + key_length_max, record, record_length);
+
+        cache[victim].result = result;
+        cache[victim].last_used = ++cache_clock;
+    }
+};
+
+#endif /*__DATABASE_INDEX_H__*/
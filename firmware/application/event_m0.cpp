@@ -34,6 +34,7 @@
 #include "irq_controls.hpp"
 
 #include "buffer_exchange.hpp"
+#include "sweep_thread.hpp"
 
 #include "ch.h"
 
@@ -53,6 +54,7 @@ CH_IRQ_HANDLER(M4Core_IRQHandler) {
 
     chSysLockFromIsr();
     BufferExchange::handle_isr();
+    SweepThread::handle_isr();
     EventDispatcher::check_fifo_isr();
     chSysUnlockFromIsr();
 
@@ -198,7 +200,13 @@ void EventDispatcher::dispatch(const eventmask_t events) {
 
 void EventDispatcher::handle_application_queue() {
     shared_memory.application_queue.handle([](Message* const message) {
-        message_map.send(message);
+        if (message->id == Message::ID::PacketBatch) {
+            reinterpret_cast<PacketBatchMessage*>(message)->for_each([](Message* const packet, uint32_t) {
+                message_map.send(packet);
+            });
+        } else {
+            message_map.send(message);
+        }
     });
 }
 
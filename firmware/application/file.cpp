@@ -128,6 +128,16 @@ File::Result<File::Offset> File::truncate() {
     return {static_cast<File::Offset>(position)};
 }
 
+Optional<File::Error> File::expand(Size size) {
+    const auto result = f_expand(&f, size, 1);
+    if (result == FR_OK) {
+        // Flush the new chain now rather than on the first write.
+        return sync();
+    } else {
+        return {result};
+    }
+}
+
 File::Size File::size() const {
     return f_size(&f);
 }
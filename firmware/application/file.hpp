@@ -342,6 +342,10 @@ class File {
     Offset tell() const;
     Result<Offset> seek(uint64_t Offset);
     Result<Offset> truncate();
+    /* Allocates a contiguous extent of size bytes to an empty file opened for
+     * writing and sets the file size to it. Writes within the extent don't
+     * touch the FAT; truncate() at the end returns the unused part. */
+    Optional<Error> expand(Size size);
     Size size() const;
     Result<bool> eof();
 
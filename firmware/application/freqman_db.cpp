@@ -31,14 +31,17 @@
 #include "utility.hpp"
 #include "file_path.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cctype>
+#include <cstring>
 #include <string_view>
 #include <vector>
 
 namespace fs = std::filesystem;
 
 const std::filesystem::path freqman_extension{u".TXT"};
+const std::filesystem::path freqman_index_extension{u".IDX"};
 
 // NB: Don't include UI headers to keep this code unit testable.
 using option_t = std::pair<std::string, int32_t>;
@@ -232,7 +235,9 @@ bool load_freqman_file(const std::string& file_stem, freqman_db& db, freqman_loa
 }
 
 void delete_freqman_file(const std::string& file_stem) {
-    delete_file(get_freqman_path(file_stem));
+    auto path = get_freqman_path(file_stem);
+    delete_file(path);
+    delete_freqman_index(path);
 }
 
 std::string pretty_string(const freqman_entry& entry, size_t max_length) {
@@ -397,6 +402,15 @@ bool parse_freqman_entry(std::string_view str, freqman_entry& entry) {
     return is_valid(entry);
 }
 
+bool parse_freqman_line(std::string_view line, freqman_entry& entry) {
+    if (parse_freqman_entry(line, entry))
+        return true;
+
+    entry.type = freqman_type::Raw;
+    entry.description = trim(line).substr(0, freqman_max_desc_size);
+    return false;
+}
+
 bool parse_freqman_file(const fs::path& path, freqman_db& db, freqman_load_options options) {
     FreqmanDB freqman_db;
     freqman_db.set_read_raw(false);  // Don't return malformed lines.
@@ -469,38 +483,124 @@ bool is_valid(const freqman_entry& entry) {
 
 /* FreqmanDB ***********************************/
 
+freqman_index_record to_index_record(const freqman_entry& entry, uint32_t offset, bool parsed) {
+    freqman_index_record record{};
+    record.frequency_a = entry.frequency_a;
+    record.frequency_b = entry.frequency_b;
+    record.offset = offset;
+    record.type = entry.type;
+    record.modulation = entry.modulation;
+    record.bandwidth = entry.bandwidth;
+    record.step = entry.step;
+    record.tone = entry.tone;
+    record.parsed = parsed;
+
+    auto length = std::min(entry.description.length(), sizeof(record.description));
+    memcpy(record.description, entry.description.data(), length);
+    return record;
+}
+
+freqman_entry from_index_record(const freqman_index_record& record) {
+    auto length = std::find(record.description, std::end(record.description), '\0') - record.description;
+
+    return freqman_entry{
+        .frequency_a = record.frequency_a,
+        .frequency_b = record.frequency_b,
+        .description = std::string{record.description, static_cast<size_t>(length)},
+        .type = record.type,
+        .modulation = record.modulation,
+        .bandwidth = record.bandwidth,
+        .step = record.step,
+        .tone = record.tone,
+    };
+}
+
+static fs::path get_index_path(fs::path path) {
+    return path.replace_extension(freqman_index_extension);
+}
+
+void delete_freqman_index(const fs::path& path) {
+    if (path_iequal(path.extension(), freqman_extension))
+        delete_file(get_index_path(path));
+}
+
 bool FreqmanDB::open(const std::filesystem::path& path, bool create) {
-    auto result = FileWrapper::open(path, create);
-    if (!result)
-        return false;
+    close();
+    path_ = path;
 
-    wrapper_ = *std::move(result);
-    return true;
+    {
+        File source;
+        if (source.open(path, /*read_only*/ false, create))
+            return false;
+
+        auto timestamp = file_created_date(path);
+        uint32_t source_timestamp = (timestamp.FAT_date << 16) | timestamp.FAT_time;
+        uint32_t source_size = source.size();
+
+        if (!index_file_.open(get_index_path(path), /*read_only*/ false, /*create*/ true)) {
+            if (index_.open(index_file_, source_size, source_timestamp))
+                return true;
+
+            if (FreqmanIndex<File>::build(source, index_file_, source_timestamp) &&
+                index_.open(index_file_, source_size, source_timestamp))
+                return true;
+        }
+    }
+
+    // No usable index (e.g. write protected card), scan the file instead.
+    return ensure_wrapper();
 }
 
 void FreqmanDB::close() {
     wrapper_.reset();
+    index_.close();
+    index_file_.close();
+}
+
+bool FreqmanDB::ensure_wrapper() {
+    if (wrapper_)
+        return true;
+
+    index_.close();
+    index_file_.close();
+    delete_file(get_index_path(path_));
+
+    auto result = FileWrapper::open(path_);
+    if (!result)
+        return false;
+
+    wrapper_ = *std::move(result);
+    return true;
 }
 
 freqman_entry FreqmanDB::operator[](Index index) const {
-    auto length = wrapper_->line_length(index);
+    if (index_.is_open()) {
+        auto record = index_.record(index);
+        if (record && (record->parsed || read_raw_))
+            return from_index_record(*record);
+
+        return {};
+    }
+
+    if (!wrapper_)
+        return {};
+
+    auto length = std::min<uint32_t>(wrapper_->line_length(index), freqman_max_line_length);
     auto line_text = wrapper_->get_text(index, 0, length);
 
     if (line_text) {
         freqman_entry entry;
-        if (parse_freqman_entry(*line_text, entry))
-            return entry;
-        else if (read_raw_) {
-            entry.type = freqman_type::Raw;
-            entry.description = trim(*line_text).substr(0, freqman_max_desc_size);
+        if (parse_freqman_line(*line_text, entry) || read_raw_)
             return entry;
-        }
     }
 
     return {};
 }
 
 void FreqmanDB::insert_entry(Index index, const freqman_entry& entry) {
+    if (!ensure_wrapper())
+        return;
+
     index = clip<uint32_t>(index, 0u, entry_count());
     wrapper_->insert_line(index);
     replace_entry(index, entry);
@@ -511,6 +611,9 @@ void FreqmanDB::append_entry(const freqman_entry& entry) {
 }
 
 void FreqmanDB::replace_entry(Index index, const freqman_entry& entry) {
+    if (!ensure_wrapper())
+        return;
+
     auto range = wrapper_->line_range(index);
     if (!range)
         return;
@@ -521,6 +624,9 @@ void FreqmanDB::replace_entry(Index index, const freqman_entry& entry) {
 }
 
 void FreqmanDB::delete_entry(Index index) {
+    if (!ensure_wrapper())
+        return;
+
     wrapper_->delete_line(index);
 }
 
@@ -540,11 +646,17 @@ FreqmanDB::iterator FreqmanDB::find_entry(const freqman_entry& entry) {
 }
 
 uint32_t FreqmanDB::entry_count() const {
+    if (index_.is_open())
+        return index_.entry_count();
+
     // FileWrapper always presents a single line even for empty files.
     return empty() ? 0u : wrapper_->line_count();
 }
 
 bool FreqmanDB::empty() const {
+    if (index_.is_open())
+        return index_.entry_count() == 0;
+
     // FileWrapper always presents a single line even for empty files.
     // A DB is only really empty if the file size is 0.
     return !wrapper_ || wrapper_->size() == 0;
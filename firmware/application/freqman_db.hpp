@@ -164,6 +164,9 @@ constexpr size_t freqman_default_max_entries = 150;
 /* Limiting description to 30 as specified by the format */
 constexpr size_t freqman_max_desc_size = 30;
 
+/* Longer lines can't be valid entries, only this much of them is parsed. */
+constexpr size_t freqman_max_line_length = 0x100;
+
 struct freqman_load_options {
     /* Loads all entries when set to 0. */
     size_t max_entries{freqman_default_max_entries};
@@ -194,6 +197,181 @@ bool parse_freqman_file(const std::filesystem::path& path, freqman_db& db, freqm
 /* Returns true if the entry is well-formed. */
 bool is_valid(const freqman_entry& entry);
 
+/* Parses a line the way FreqmanDB presents it. When the line is not a valid
+ * entry, returns false and entry holds the line as a Raw entry. */
+bool parse_freqman_line(std::string_view line, freqman_entry& entry);
+
+/* Freqman Index ******************************/
+/* A freqman file can have thousands of lines and finding a line means
+ * scanning for newlines. The sidecar index (same path, .IDX extension)
+ * holds every line's offset and parsed entry in fixed size records, so any
+ * entry is a single seek + read. It is only trusted while the size and
+ * timestamp of the source file match the ones it was built from. */
+
+/* Defined in freqman_db.cpp */
+extern const std::filesystem::path freqman_index_extension;
+
+/* Removes the index next to a freqman file, once the file is renamed, moved
+ * or deleted the index would only be left behind. Not freqman files are
+ * ignored. */
+void delete_freqman_index(const std::filesystem::path& path);
+
+struct freqman_index_header {
+    static constexpr uint32_t magic_value = 0x58495146;  // "FQIX"
+    static constexpr uint16_t version_value = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t source_size;
+    uint32_t source_timestamp;  // FAT date << 16 | FAT time
+    uint32_t entry_count;
+};
+
+struct freqman_index_record {
+    int64_t frequency_a;
+    int64_t frequency_b;
+    uint32_t offset;  // Start of the line in the source file.
+    freqman_type type;
+    freqman_index_t modulation;
+    freqman_index_t bandwidth;
+    freqman_index_t step;
+    freqman_index_t tone;
+    uint8_t parsed;                            // 0 if the line isn't a valid entry.
+    char description[freqman_max_desc_size];  // NUL padded, not terminated when full.
+};
+static_assert(sizeof(freqman_index_record) == 56, "freqman_index_record size changed, bump the index version.");
+
+freqman_index_record to_index_record(const freqman_entry& entry, uint32_t offset, bool parsed);
+freqman_entry from_index_record(const freqman_index_record& record);
+
+/* Reads and builds a freqman index. BufferType is as for BufferWrapper. */
+template <typename BufferType>
+class FreqmanIndex {
+   public:
+    using Index = uint32_t;
+    using Offset = uint32_t;
+
+    /* Builds the index for source into index with one sequential pass over
+     * the source. Lines are split like BufferWrapper: a missing final
+     * newline still ends a line and an empty source has no entries. */
+    static bool build(BufferType& source, BufferType& index, uint32_t source_timestamp) {
+        freqman_index_header header{};
+        index.seek(0);
+        if (index.write(&header, sizeof(header)).is_error())
+            return false;
+
+        char buffer[buffer_size];
+        std::string line{};
+        line.reserve(0x80);
+        Offset offset = 0;
+        Offset line_start = 0;
+        uint32_t count = 0;
+
+        auto append_line = [&]() {
+            freqman_entry entry{};
+            auto parsed = parse_freqman_line(line, entry);
+            auto record = to_index_record(entry, line_start, parsed);
+            line.clear();
+            ++count;
+            return index.write(&record, sizeof(record)).is_ok();
+        };
+
+        source.seek(0);
+        while (true) {
+            auto result = source.read(buffer, buffer_size);
+            if (result.is_error())
+                return false;
+
+            for (Offset i = 0; i < *result; ++i) {
+                if (line.length() < freqman_max_line_length)
+                    line.push_back(buffer[i]);
+                if (buffer[i] == '\n') {
+                    if (!append_line())
+                        return false;
+                    line_start = offset + i + 1;
+                }
+            }
+
+            offset += *result;
+            if (*result < buffer_size)
+                break;
+        }
+
+        if (!line.empty() && !append_line())
+            return false;
+
+        // Drop any leftover records of a previous, longer index.
+        index.truncate();
+
+        // The header goes last so an interrupted build is never valid.
+        header.magic = freqman_index_header::magic_value;
+        header.version = freqman_index_header::version_value;
+        header.record_size = sizeof(freqman_index_record);
+        header.source_size = source.size();
+        header.source_timestamp = source_timestamp;
+        header.entry_count = count;
+
+        index.seek(0);
+        if (index.write(&header, sizeof(header)).is_error())
+            return false;
+
+        return !index.sync();
+    }
+
+    /* Uses index if it was built from a source with this size and timestamp. */
+    bool open(BufferType& index, uint32_t source_size, uint32_t source_timestamp) {
+        index_ = nullptr;
+
+        freqman_index_header header{};
+        index.seek(0);
+        auto result = index.read(&header, sizeof(header));
+        if (result.is_error() || *result != sizeof(header))
+            return false;
+
+        if (header.magic != freqman_index_header::magic_value ||
+            header.version != freqman_index_header::version_value ||
+            header.record_size != sizeof(freqman_index_record) ||
+            header.source_size != source_size ||
+            header.source_timestamp != source_timestamp ||
+            index.size() != sizeof(header) + header.entry_count * sizeof(freqman_index_record))
+            return false;
+
+        index_ = &index;
+        entry_count_ = header.entry_count;
+        return true;
+    }
+
+    void close() { index_ = nullptr; }
+    bool is_open() const { return index_ != nullptr; }
+    uint32_t entry_count() const { return entry_count_; }
+
+    Optional<freqman_index_record> record(Index index) const {
+        if (!index_ || index >= entry_count_)
+            return {};
+
+        freqman_index_record record{};
+        index_->seek(sizeof(freqman_index_header) + index * sizeof(freqman_index_record));
+        auto result = index_->read(&record, sizeof(record));
+        if (result.is_error() || *result != sizeof(record))
+            return {};
+
+        return record;
+    }
+
+    /* Gets the start offset of the line in the source file. */
+    Optional<Offset> line_offset(Index index) const {
+        auto r = record(index);
+        return r ? Optional<Offset>{r->offset} : Optional<Offset>{};
+    }
+
+   private:
+    static constexpr Offset buffer_size = 512;
+
+    BufferType* index_{nullptr};
+    uint32_t entry_count_{0};
+};
+
 /* API wrapper over a Freqman file. Provides CRUD operations
  * for freqman_entry instances that are read/written directly
  * to the underlying file. */
@@ -238,6 +416,8 @@ class FreqmanDB {
         Index index_;
     };
 
+    ~FreqmanDB() { close(); }
+
     bool open(const std::filesystem::path& path, bool create = false);
     void close();
 
@@ -277,7 +457,14 @@ class FreqmanDB {
     }
 
    private:
+    /* Opens the text file for editing and drops the index, it is rebuilt
+     * on the next open. Reads then go through the wrapper. */
+    bool ensure_wrapper();
+
+    std::filesystem::path path_{};
     std::unique_ptr<FileWrapper> wrapper_{};
+    File index_file_{};
+    FreqmanIndex<File> index_{};
     bool read_raw_{true};
 };
 
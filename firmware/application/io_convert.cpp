@@ -86,6 +86,20 @@ Optional<File::Error> FileConvertWriter::create(const std::filesystem::path& fil
     return file_.create(filename);
 }
 
+FileConvertWriter::~FileConvertWriter() {
+    if (preallocated_) {
+        file_.truncate();
+    }
+}
+
+Optional<File::Error> FileConvertWriter::preallocate(const File::Size bytes) {
+    auto error = file_.expand(bytes);
+    if (!error.is_valid()) {
+        preallocated_ = true;
+    }
+    return error;
+}
+
 // If C8 conversion is enabled, half the number of bytes are written to the file.
 File::Result<File::Size> FileConvertWriter::write(const void* const buffer, const File::Size bytes) {
     if (convert_c16_to_c8) {
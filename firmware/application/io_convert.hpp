@@ -66,8 +66,15 @@ class FileConvertWriter : public stream::Writer {
     FileConvertWriter(FileConvertWriter&& file) = delete;
     FileConvertWriter& operator=(FileConvertWriter&&) = delete;
 
+    ~FileConvertWriter();
+
     Optional<File::Error> create(const std::filesystem::path& filename);
 
+    /* Reserves a contiguous extent of bytes in the file so the capture
+     * doesn't extend the FAT chain as it goes. The file is truncated to what
+     * was actually written when the writer is destroyed. */
+    Optional<File::Error> preallocate(const File::Size bytes);
+
     File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
     const File& file() const& { return file_; }
 
@@ -76,4 +83,5 @@ class FileConvertWriter : public stream::Writer {
    protected:
     File file_{};
     uint64_t bytes_written_{0};
+    bool preallocated_{false};
 };
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "iq_block_ring.hpp"
+
+#include <atomic>
+#include <cstring>
+
+IqBlockRing::IqBlockRing(
+    uint8_t* const storage,
+    const size_t block_size,
+    const size_t block_count)
+    : storage{storage},
+      block_size_{block_size},
+      block_count{block_count} {
+}
+
+bool IqBlockRing::push(const void* const data, const size_t size) {
+    const uint32_t index = blocks_;
+    blocks_ = index + 1;
+
+    if (head - tail >= block_count || size > block_size_) {
+        dropped_ = dropped_ + 1;
+        return false;
+    }
+
+    uint8_t* const p = slot(head);
+    const Header header{index, static_cast<uint32_t>(size)};
+    memcpy(p, &header, sizeof(header));
+    memcpy(p + sizeof(header), data, size);
+
+    // The consumer may take the slot as soon as head moves past it.
+    std::atomic_signal_fence(std::memory_order_release);
+    head = head + 1;
+    return true;
+}
+
+size_t IqBlockRing::pop(void* const out, uint32_t& index) {
+    if (empty())
+        return 0;
+
+    std::atomic_signal_fence(std::memory_order_acquire);
+    const uint8_t* const p = slot(tail);
+    Header header;
+    memcpy(&header, p, sizeof(header));
+    memcpy(out, p + sizeof(header), header.size);
+    index = header.index;
+
+    std::atomic_signal_fence(std::memory_order_release);
+    tail = tail + 1;
+    return header.size;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __IQ_BLOCK_RING_H__
+#define __IQ_BLOCK_RING_H__
+
+#include <cstdint>
+#include <cstddef>
+
+/* Fixed size blocks of IQ handed from one thread to another. The producer
+ * never waits: a block that doesn't find a free slot is dropped and
+ * counted. Every pushed block is numbered, dropped ones included, so the
+ * consumer sees a gap in the numbering where data is missing.
+ *
+ * Safe for one producer and one consumer on a single core without a lock. */
+class IqBlockRing {
+   public:
+    static constexpr size_t storage_size(const size_t block_size, const size_t block_count) {
+        return (sizeof(Header) + block_size) * block_count;
+    }
+
+    IqBlockRing(uint8_t* const storage, const size_t block_size, const size_t block_count);
+
+    size_t block_size() const { return block_size_; }
+
+    /* Copies size bytes, at most block_size(), false if dropped. */
+    bool push(const void* const data, const size_t size);
+
+    /* Copies the oldest block to out, which needs block_size() bytes.
+     * Returns its size, 0 when empty. */
+    size_t pop(void* const out, uint32_t& index);
+
+    bool empty() const { return head == tail; }
+
+    /* Blocks pushed so far and how many of them were dropped. */
+    uint32_t blocks() const { return blocks_; }
+    uint32_t dropped() const { return dropped_; }
+
+   private:
+    struct Header {
+        uint32_t index;
+        uint32_t size;
+    };
+
+    uint8_t* const storage;
+    const size_t block_size_;
+    const size_t block_count;
+
+    volatile uint32_t head{0};
+    volatile uint32_t tail{0};
+    volatile uint32_t blocks_{0};
+    volatile uint32_t dropped_{0};
+
+    uint8_t* slot(const uint32_t n) const {
+        return storage + (n % block_count) * (sizeof(Header) + block_size_);
+    }
+};
+
+#endif /*__IQ_BLOCK_RING_H__*/
@@ -21,6 +21,8 @@
 
 #include "radio.hpp"
 
+#include "ch.h"
+
 #include "rf_path.hpp"
 
 #include "rffc507x.hpp"
@@ -97,13 +99,56 @@ static rf::Direction direction{rf::Direction::Receive};
 static bool baseband_invert = false;
 static bool mixer_invert = false;
 
+/* First LO programmed into the RFFC507x, 0 while it is disabled. */
+static rf::Frequency first_lo_frequency_current = 0;
+
+/* The sweep thread retunes while the UI thread changes gains, so every
+ * public entry point holds this across its register writes. */
+static MUTEX_DECL(radio_mutex);
+
+class RadioLock {
+   public:
+    RadioLock() {
+        chMtxLock(&radio_mutex);
+    }
+
+    ~RadioLock() {
+        chMtxUnlock();
+    }
+
+    RadioLock(const RadioLock&) = delete;
+    RadioLock& operator=(const RadioLock&) = delete;
+};
+
+static void set_rf_amp_locked(const bool rf_amp) {
+    rf_path.set_rf_amp(rf_amp);
+
+    if (direction == rf::Direction::Transmit) {
+        if (rf_amp)
+            led_tx.on();
+        else
+            led_tx.off();
+    }
+}
+
+static void set_antenna_bias_locked(const bool on) {
+    /* Pull MOSFET gate low to turn on antenna bias. */
+    if (hackrf_r9) {
+        gpio_r9_not_ant_pwr.write(on ? 0 : 1);
+    } else {
+        first_if.set_gpo1(on ? 0 : 1);
+    }
+}
+
 void init() {
+    RadioLock lock;
     if (hackrf_r9) {
         gpio_r9_not_ant_pwr.write(1);
         gpio_r9_not_ant_pwr.output();
     }
     rf_path.init();
     first_if.init();
+    first_lo_frequency_current = 0;
     second_if = hackrf_r9
                     ? (max283x::MAX283x*)&second_if_max2839
                     : (max283x::MAX283x*)&second_if_max2837;
@@ -113,6 +158,7 @@ void init() {
 }
 
 void set_direction(const rf::Direction new_direction) {
+    RadioLock lock;
     /* TODO: Refactor all the various "Direction" enumerations into one. */
     /* TODO: Only make changes if direction changes, but beware of clock enabling. */
 
@@ -157,6 +203,7 @@ void set_direction(const rf::Direction new_direction) {
 }
 
 bool set_tuning_frequency(const rf::Frequency frequency) {
+    RadioLock lock;
     rf::Frequency final_frequency = frequency;
     // if converter feature is enabled
     if (portapack::persistent_memory::config_converter()) {
@@ -181,14 +228,19 @@ bool set_tuning_frequency(const rf::Frequency frequency) {
             final_frequency = final_frequency + portapack::persistent_memory::config_freq_rx_correction();
     }
 
-    const auto tuning_config = tuning::config::create(final_frequency);
+    const auto tuning_config = tuning::config::create(final_frequency, first_lo_frequency_current);
     if (tuning_config.is_valid()) {
-        first_if.disable();
+        // Leave the RFFC507x locked when the first LO doesn't change.
+        if (tuning_config.first_lo_frequency != first_lo_frequency_current) {
+            first_if.disable();
+
+            // Program first local oscillator frequency (if there is one) into RFFC507x
+            if (tuning_config.first_lo_frequency) {
+                first_if.set_frequency(tuning_config.first_lo_frequency);
+                first_if.enable();
+            }
 
-        // Program first local oscillator frequency (if there is one) into RFFC507x
-        if (tuning_config.first_lo_frequency) {
-            first_if.set_frequency(tuning_config.first_lo_frequency);
-            first_if.enable();
+            first_lo_frequency_current = tuning_config.first_lo_frequency;
         }
 
         // Program second local oscillator frequency into MAX283x
@@ -205,33 +257,32 @@ bool set_tuning_frequency(const rf::Frequency frequency) {
 }
 
 void set_rf_amp(const bool rf_amp) {
-    rf_path.set_rf_amp(rf_amp);
-
-    if (direction == rf::Direction::Transmit) {
-        if (rf_amp)
-            led_tx.on();
-        else
-            led_tx.off();
-    }
+    RadioLock lock;
+    set_rf_amp_locked(rf_amp);
 }
 
 void set_lna_gain(const int_fast8_t db) {
+    RadioLock lock;
     second_if->set_lna_gain(db);
 }
 
 void set_vga_gain(const int_fast8_t db) {
+    RadioLock lock;
     second_if->set_vga_gain(db);
 }
 
 void set_tx_gain(const int_fast8_t db) {
+    RadioLock lock;
     second_if->set_tx_vga_gain(db);
 }
 
 void set_baseband_filter_bandwidth_rx(const uint32_t bandwidth_minimum) {
+    RadioLock lock;
     second_if->set_lpf_rf_bandwidth_rx(bandwidth_minimum);
 }
 
 void set_baseband_filter_bandwidth_tx(const uint32_t bandwidth_minimum) {
+    RadioLock lock;
     second_if->set_lpf_rf_bandwidth_tx(bandwidth_minimum);
 }
 
@@ -241,19 +292,17 @@ void set_baseband_rate(const uint32_t rate) {
 }
 
 void set_antenna_bias(const bool on) {
-    /* Pull MOSFET gate low to turn on antenna bias. */
-    if (hackrf_r9) {
-        gpio_r9_not_ant_pwr.write(on ? 0 : 1);
-    } else {
-        first_if.set_gpo1(on ? 0 : 1);
-    }
+    RadioLock lock;
+    set_antenna_bias_locked(on);
 }
 
 void set_tx_max283x_iq_phase_calibration(const size_t v) {
+    RadioLock lock;
     second_if->set_tx_LO_iq_phase_calibration(v);
 }
 
 void set_rx_max283x_iq_phase_calibration(const size_t v) {
+    RadioLock lock;
     second_if->set_rx_LO_iq_phase_calibration(v);
 }
 
@@ -271,12 +320,18 @@ void configure(Configuration configuration) {
     set_direction(configuration.direction);
 }*/
 
+rf::Frequency first_lo_frequency() {
+    return first_lo_frequency_current;
+}
+
 void disable() {
-    set_antenna_bias(false);
+    RadioLock lock;
+    set_antenna_bias_locked(false);
     baseband_codec.set_mode(max5864::Mode::Shutdown);
     second_if->set_mode(max2837::Mode::Standby);
     first_if.disable();
-    set_rf_amp(false);
+    first_lo_frequency_current = 0;
+    set_rf_amp_locked(false);
 
     led_rx.off();
     led_tx.off();
@@ -287,11 +342,15 @@ namespace debug {
 namespace first_if {
 
 uint32_t register_read(const size_t register_number) {
+    RadioLock lock;
     return radio::first_if.read(register_number);
 }
 
 void register_write(const size_t register_number, uint32_t value) {
+    RadioLock lock;
     radio::first_if.write(register_number, value);
+    // Don't trust the cached LO after a manual write.
+    radio::first_lo_frequency_current = -1;
 }
 
 } /* namespace first_if */
@@ -299,14 +358,17 @@ void register_write(const size_t register_number, uint32_t value) {
 namespace second_if {
 
 uint32_t register_read(const size_t register_number) {
+    RadioLock lock;
     return radio::second_if->read(register_number);
 }
 
 void register_write(const size_t register_number, uint32_t value) {
+    RadioLock lock;
     radio::second_if->write(register_number, value);
 }
 
 int8_t temp_sense() {
+    RadioLock lock;
     return radio::second_if->temp_sense();
 }
 
@@ -57,6 +57,9 @@ void set_antenna_bias(const bool on);
 void set_tx_max283x_iq_phase_calibration(const size_t v);
 void set_rx_max283x_iq_phase_calibration(const size_t v);
 
+/* First LO in use, 0 when the RFFC507x is off (mid band). */
+rf::Frequency first_lo_frequency();
+
 /* Use ReceiverModel or TransmitterModel instead. */
 // void enable(Configuration configuration);
 // void configure(Configuration configuration);
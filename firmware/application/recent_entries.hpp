@@ -23,6 +23,7 @@
 #define __RECENT_ENTRIES_H__
 
 #include "ui_widget.hpp"
+#include "app_arena.hpp"
 
 #include <algorithm>
 #include <cstddef>
@@ -32,8 +33,9 @@
 #include <list>
 #include <utility>
 
+/* Apps that own an AppArena can construct their list with it. */
 template <class Entry>
-using RecentEntries = std::list<Entry>;
+using RecentEntries = std::list<Entry, ArenaAllocator<Entry>>;
 
 template <typename ContainerType, typename Key>
 typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
@@ -60,9 +62,8 @@ template <typename ContainerType, typename Key>
 typename ContainerType::reference on_packet(ContainerType& entries, const Key key) {
     auto matching_recent = find(entries, key);
     if (matching_recent != std::end(entries)) {
-        // Found within. Move to front of list, increment counter.
-        entries.push_front(*matching_recent);
-        entries.erase(matching_recent);
+        // Found within. Move to front of list, no copy or allocation.
+        entries.splice(std::begin(entries), entries, matching_recent);
     } else {
         entries.emplace_front(key);
         truncate_entries(entries);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "scanner_schedule.hpp"
+
+#include "tuning.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace scanner {
+
+ScanSchedule::ScanSchedule(const std::vector<rf::Frequency>& frequencies)
+    : order_(frequencies.size()),
+      first_lo_(frequencies.size()),
+      batch_of_(frequencies.size()) {
+    std::iota(order_.begin(), order_.end(), 0);
+    std::stable_sort(order_.begin(), order_.end(), [&frequencies](size_t a, size_t b) {
+        return frequencies[a] < frequencies[b];
+    });
+
+    // Follow the radio: keep the current first LO for as long as it can be.
+    rf::Frequency first_lo = 0;
+    for (size_t i = 0; i < order_.size(); i++) {
+        first_lo = tuning::config::create(frequencies[order_[i]], first_lo).first_lo_frequency;
+        first_lo_[i] = first_lo;
+    }
+
+    // Cut the sorted list into runs that fit around one tune.
+    for (size_t first = 0; first < order_.size();) {
+        const auto low = frequencies[order_[first]];
+        uint32_t spacing = batch_max_spacing;
+        size_t last = first;
+        while ((last + 1 < order_.size()) &&
+               (last + 1 - first < batch_max_channels) &&
+               (frequencies[order_[last + 1]] - low <= 2 * batch_max_offset)) {
+            const auto gap = frequencies[order_[last + 1]] - frequencies[order_[last]];
+            if (gap > 0)
+                spacing = std::min<uint32_t>(spacing, gap);
+            last++;
+        }
+
+        const auto high = frequencies[order_[last]];
+        const ScanBatch batch{
+            low + (high - low) / 2,
+            static_cast<uint16_t>(first),
+            static_cast<uint16_t>(last - first + 1),
+            std::max(spacing, batch_min_spacing)};
+        for (size_t i = first; i <= last; i++)
+            batch_of_[i] = batches_.size();
+        batches_.push_back(batch);
+
+        first = last + 1;
+    }
+}
+
+size_t ScanSchedule::first_lo_changes() const {
+    size_t changes = 0;
+    for (size_t i = 0; i < first_lo_.size(); i++) {
+        const auto previous = first_lo_[(i + first_lo_.size() - 1) % first_lo_.size()];
+        if (first_lo_[i] != previous)
+            changes++;
+    }
+    return changes;
+}
+
+} /* namespace scanner */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SCANNER_SCHEDULE_H__
+#define __SCANNER_SCHEDULE_H__
+
+#include "rf_path.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// NB: Don't include UI or radio headers to keep this code unit testable.
+
+namespace scanner {
+
+/* Time allowed for the synthesizers after a retune. The MAX283x alone
+ * relocks quickly; a new first LO also power cycles the RFFC507x. */
+constexpr uint16_t second_lo_settle_us = 500;
+constexpr uint16_t first_lo_settle_us = 2000;
+
+/* Length of the first channel statistics window after a retune, the
+ * squelch decision for the channel is made on it. */
+constexpr uint16_t probe_window_us = 5000;
+
+/* Channels close enough together are measured at once by the baseband
+ * (ChannelBankCollector) from a tune to their middle. The NFM/AM front
+ * end runs at 384kHz, its edges are attenuated and alias. */
+constexpr rf::Frequency batch_max_offset = 96'000;
+constexpr size_t batch_max_channels = 16;
+constexpr uint32_t batch_min_spacing = 6'250;
+constexpr uint32_t batch_max_spacing = 25'000;
+
+struct ScanBatch {
+    rf::Frequency center;
+    uint16_t first;    // Position of the first channel
+    uint16_t count;    // Channels, at consecutive positions
+    uint32_t spacing;  // Measurement bandwidth, smallest gap between the channels
+};
+
+/* Scan order for a frequency list. Channels are visited by frequency and
+ * runs that can share a first LO (see tuning::config::create) are kept
+ * together, so most retunes only move the second LO. */
+class ScanSchedule {
+   public:
+    ScanSchedule() = default;
+    explicit ScanSchedule(const std::vector<rf::Frequency>& frequencies);
+
+    size_t size() const { return order_.size(); }
+    bool empty() const { return order_.empty(); }
+
+    /* Index in the frequency list of the channel scanned at position. */
+    size_t index(size_t position) const { return order_[position]; }
+
+    /* First LO the radio will use at position when scanning in order. */
+    rf::Frequency first_lo(size_t position) const { return first_lo_[position]; }
+
+    /* Number of first LO changes in one pass, wrap around included. */
+    size_t first_lo_changes() const;
+
+    size_t batch_count() const { return batches_.size(); }
+    const ScanBatch& batch(size_t b) const { return batches_[b]; }
+
+    /* Batch holding the channel scanned at position. */
+    size_t batch_of(size_t position) const { return batch_of_[position]; }
+
+   private:
+    std::vector<uint16_t> order_{};
+    std::vector<rf::Frequency> first_lo_{};
+    std::vector<ScanBatch> batches_{};
+    std::vector<uint16_t> batch_of_{};
+};
+
+/* Settle time for a retune that did or didn't move the first LO. */
+constexpr uint16_t settle_us(bool first_lo_changed) {
+    return first_lo_changed ? first_lo_settle_us : second_lo_settle_us;
+}
+
+} /* namespace scanner */
+
+#endif /*__SCANNER_SCHEDULE_H__*/
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "sweep_log.hpp"
+
+#include <cstring>
+
+namespace sweep_log {
+
+Reader::Reader(const uint8_t* const data, const size_t size)
+    : data{data},
+      size{size} {
+    FileHeader header{};
+    if (size >= sizeof(header)) {
+        std::memcpy(&header, data, sizeof(header));
+        valid_ = (header.magic == file_magic) && (header.version == file_version);
+        index_interval_ = header.index_interval;
+    }
+}
+
+bool Reader::record_at(const size_t offset, RecordHeader& record) const {
+    if (!valid_ || offset < sizeof(FileHeader) || offset + sizeof(record) > size) {
+        return false;
+    }
+    std::memcpy(&record, &data[offset], sizeof(record));
+    return (record.sync == record_sync) &&
+           (record.size >= sizeof(record)) &&
+           (record.size % 4 == 0) &&
+           (record.size <= size - offset);
+}
+
+bool Reader::sweep_at(const uint32_t offset, Sweep& sweep) const {
+    RecordHeader record{};
+    if (!record_at(offset, record) || record.type != RecordType::Sweep ||
+        record.size < sizeof(record) + sizeof(SweepHeader)) {
+        return false;
+    }
+
+    std::memcpy(&sweep.header, &data[offset + sizeof(record)], sizeof(sweep.header));
+    if (sweep_record_size(sweep.header.bin_count) != record.size) {
+        return false;
+    }
+    sweep.bins = &data[offset + sizeof(record) + sizeof(SweepHeader)];
+    sweep.offset = offset;
+    return true;
+}
+
+bool Reader::next(Sweep& sweep) {
+    RecordHeader record{};
+    while (record_at(position, record)) {
+        const size_t offset = position;
+        position += record.size;
+
+        if (record.type == RecordType::Sweep) {
+            if (sweep_at(offset, sweep)) {
+                return true;
+            }
+            break;
+        }
+    }
+
+    // Nothing valid past here.
+    position = size;
+    return false;
+}
+
+std::vector<uint32_t> Reader::indexed_sweeps() const {
+    // Find the last complete index, then walk the chain back.
+    size_t last_index = 0;
+    RecordHeader record{};
+    for (size_t offset = sizeof(FileHeader); record_at(offset, record); offset += record.size) {
+        if (record.type == RecordType::Index) {
+            last_index = offset;
+        }
+    }
+
+    std::vector<uint32_t> offsets;
+    size_t index = last_index;
+    while (index && record_at(index, record) && record.type == RecordType::Index) {
+        IndexHeader header{};
+        std::memcpy(&header, &data[index + sizeof(record)], sizeof(header));
+        if (index_record_size(header.count) != record.size) {
+            break;
+        }
+
+        std::vector<uint32_t> block(header.count);
+        std::memcpy(block.data(), &data[index + sizeof(record) + sizeof(header)], header.count * sizeof(uint32_t));
+        offsets.insert(offsets.begin(), block.begin(), block.end());
+
+        // The chain only goes backwards.
+        if (header.previous_index >= index) {
+            break;
+        }
+        index = header.previous_index;
+    }
+    return offsets;
+}
+
+} /* namespace sweep_log */
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SWEEP_LOG_H__
+#define __SWEEP_LOG_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+/* Append-only spectrum survey log, little endian:
+ *
+ *   FileHeader, then records, each a RecordHeader padded to 4 bytes.
+ *   Sweep: SweepHeader then bin_count uint8 levels (ChannelSpectrum scale,
+ *          0.2dB per step, 255 = full scale) from start to stop frequency.
+ *   Index: IndexHeader then count uint32 file offsets of the sweeps since
+ *          the previous index, which IndexHeader::previous_index points at.
+ *
+ * An index follows every index_interval sweeps and closes the file, so the
+ * last one chains back over every sweep before it. A file cut short by a
+ * power loss is still readable up to its last complete record.
+ */
+namespace sweep_log {
+
+constexpr uint32_t file_magic = 0x4C535050;  // "PPSL"
+constexpr uint16_t file_version = 1;
+constexpr uint16_t record_sync = 0x5753;  // "SW"
+constexpr size_t max_index_interval = 64;
+
+enum class RecordType : uint8_t {
+    Sweep = 1,
+    Index = 2,
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t index_interval;
+    uint32_t reserved[2];
+};
+
+struct RecordHeader {
+    uint16_t sync;
+    RecordType type;
+    uint8_t reserved;
+    uint32_t size;  // Whole record, header and padding included
+};
+
+struct SweepHeader {
+    uint32_t time;  // Seconds since 1970-01-01, RTC local time
+    uint32_t uptime_ms;
+    uint64_t start_frequency;
+    uint64_t stop_frequency;
+    uint32_t bin_width;
+    uint16_t bin_count;
+    uint16_t reserved;
+};
+
+struct IndexHeader {
+    uint32_t first_sweep;     // Number of the first indexed sweep, from 0
+    uint32_t previous_index;  // File offset, 0 for the first index
+    uint16_t count;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader size wrong");
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader size wrong");
+static_assert(sizeof(SweepHeader) == 32, "SweepHeader size wrong");
+static_assert(sizeof(IndexHeader) == 12, "IndexHeader size wrong");
+
+constexpr size_t padded(const size_t size) {
+    return (size + 3) & ~size_t(3);
+}
+
+constexpr size_t sweep_record_size(const size_t bin_count) {
+    return padded(sizeof(RecordHeader) + sizeof(SweepHeader) + bin_count);
+}
+
+constexpr size_t index_record_size(const size_t count) {
+    return sizeof(RecordHeader) + sizeof(IndexHeader) + count * sizeof(uint32_t);
+}
+
+/* Seconds since 1970-01-01 for a proleptic Gregorian date and time. */
+constexpr uint32_t unix_time(
+    const uint32_t year,
+    const uint32_t month,
+    const uint32_t day,
+    const uint32_t hour,
+    const uint32_t minute,
+    const uint32_t second) {
+    // Days from civil, with March as the first month of the year.
+    const uint32_t y = year - (month <= 2);
+    const uint32_t era = y / 400;
+    const uint32_t yoe = y - era * 400;
+    const uint32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const uint32_t days = era * 146097 + doe - 719468;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+/* Produces the byte stream, handing each piece to out(const void*, size_t). */
+class Encoder {
+   public:
+    constexpr Encoder(const uint16_t index_interval)
+        : index_interval_{static_cast<uint16_t>(
+              index_interval == 0 ? 1 : (index_interval > max_index_interval ? max_index_interval : index_interval))} {
+    }
+
+    uint16_t index_interval() const { return index_interval_; }
+
+    /* Bytes written so far. */
+    uint32_t size() const { return offset; }
+
+    /* Bytes the next sweep will take, with the index it may complete. */
+    size_t sweep_size(const size_t bin_count) const {
+        return sweep_record_size(bin_count) + ((pending_count + 1 == index_interval_) ? index_record_size(pending_count + 1) : 0);
+    }
+
+    /* Bytes finish() will take. */
+    size_t finish_size() const {
+        return pending_count ? index_record_size(pending_count) : 0;
+    }
+
+    template <typename Out>
+    void begin(Out out) {
+        const FileHeader header{file_magic, file_version, index_interval_, {0, 0}};
+        emit(out, &header, sizeof(header));
+    }
+
+    template <typename Out>
+    void sweep(const SweepHeader& header, const uint8_t* const bins, Out out) {
+        const uint32_t size = sweep_record_size(header.bin_count);
+        pending[pending_count++] = offset;
+
+        const RecordHeader record{record_sync, RecordType::Sweep, 0, size};
+        emit(out, &record, sizeof(record));
+        emit(out, &header, sizeof(header));
+        emit(out, bins, header.bin_count);
+
+        const uint32_t padding = 0;
+        emit(out, &padding, size - sizeof(record) - sizeof(header) - header.bin_count);
+
+        if (pending_count == index_interval_) {
+            index(out);
+        }
+    }
+
+    template <typename Out>
+    void finish(Out out) {
+        if (pending_count) {
+            index(out);
+        }
+    }
+
+   private:
+    uint16_t index_interval_;
+    uint32_t offset{0};
+    uint32_t sweep_count{0};
+    uint32_t previous_index{0};
+    std::array<uint32_t, max_index_interval> pending{};
+    size_t pending_count{0};
+
+    template <typename Out>
+    void emit(Out& out, const void* const p, const size_t n) {
+        if (n) {
+            out(p, n);
+            offset += n;
+        }
+    }
+
+    template <typename Out>
+    void index(Out& out) {
+        const uint32_t start = offset;
+        const RecordHeader record{record_sync, RecordType::Index, 0, static_cast<uint32_t>(index_record_size(pending_count))};
+        const IndexHeader header{sweep_count, previous_index, static_cast<uint16_t>(pending_count), 0};
+        emit(out, &record, sizeof(record));
+        emit(out, &header, sizeof(header));
+        emit(out, pending.data(), pending_count * sizeof(uint32_t));
+
+        sweep_count += pending_count;
+        pending_count = 0;
+        previous_index = start;
+    }
+};
+
+struct Sweep {
+    SweepHeader header;
+    const uint8_t* bins;
+    uint32_t offset;
+};
+
+/* Reads a whole log held in memory. */
+class Reader {
+   public:
+    Reader(const uint8_t* const data, const size_t size);
+
+    bool valid() const { return valid_; }
+    uint16_t index_interval() const { return index_interval_; }
+
+    /* Sweeps in file order. False at the end, or at a damaged or
+     * truncated record, past which nothing is read. */
+    bool next(Sweep& sweep);
+
+    /* Sweep record at a file offset, e.g. from an index. */
+    bool sweep_at(const uint32_t offset, Sweep& sweep) const;
+
+    /* Offsets of every indexed sweep in file order, following the chain
+     * back from the last complete index. */
+    std::vector<uint32_t> indexed_sweeps() const;
+
+   private:
+    const uint8_t* const data;
+    const size_t size;
+    bool valid_{false};
+    uint16_t index_interval_{0};
+    size_t position{sizeof(FileHeader)};
+
+    bool record_at(const size_t offset, RecordHeader& record) const;
+};
+
+} /* namespace sweep_log */
+
+#endif /*__SWEEP_LOG_H__*/
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "sweep_logger.hpp"
+
+#include "rtc_time.hpp"
+
+SweepLogger::SweepLogger(
+    const std::filesystem::path& path,
+    const uint16_t index_interval)
+    : encoder{index_interval},
+      data{std::make_unique<uint8_t[]>(buffer_size * buffer_count)},
+      fifo_buffers_empty{buffers_empty.data(), buffer_count_log2},
+      fifo_buffers_full{buffers_full.data(), buffer_count_log2} {
+    for (size_t i = 0; i < buffer_count; i++) {
+        buffers[i] = {&data[i * buffer_size], buffer_size};
+        fifo_buffers_empty.in(&buffers[i]);
+    }
+
+    auto error = file.create(path);
+    if (error.is_valid()) {
+        failed_ = true;
+        return;
+    }
+
+    encoder.begin([this](const void* p, const size_t bytes) { put(p, bytes); });
+
+    chBSemInit(&buffers_ready, TRUE);
+    thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, SweepLogger::static_fn, this);
+}
+
+SweepLogger::~SweepLogger() {
+    if (thread) {
+        // Close the file with an index over the last sweeps, if it fits.
+        if (!failed_ && reserve(encoder.finish_size())) {
+            encoder.finish([this](const void* p, const size_t bytes) { put(p, bytes); });
+        }
+        submit_active_buffer();
+
+        chThdTerminate(thread);
+        chBSemSignal(&buffers_ready);
+        chThdWait(thread);
+        thread = nullptr;
+    }
+}
+
+bool SweepLogger::log(
+    const uint64_t start_frequency,
+    const uint64_t stop_frequency,
+    const uint32_t bin_width,
+    const uint8_t* const bins,
+    const uint16_t bin_count) {
+    if (failed_) {
+        return false;
+    }
+
+    const size_t size = encoder.sweep_size(bin_count);
+    if (!reserve(size)) {
+        dropped_++;
+        return false;
+    }
+
+    const auto datetime = rtc_time::now();
+    const sweep_log::SweepHeader header{
+        sweep_log::unix_time(datetime.year(), datetime.month(), datetime.day(), datetime.hour(), datetime.minute(), datetime.second()),
+        static_cast<uint32_t>(chTimeNow() * 1000 / CH_FREQUENCY),
+        start_frequency,
+        stop_frequency,
+        bin_width,
+        bin_count,
+        0};
+    encoder.sweep(header, bins, [this](const void* p, const size_t bytes) { put(p, bytes); });
+    logged_++;
+
+    // That sweep completed an index, get it onto the card.
+    if (size > sweep_log::sweep_record_size(bin_count)) {
+        submit_active_buffer();
+    }
+    return true;
+}
+
+bool SweepLogger::reserve(const size_t bytes) {
+    const size_t active = active_buffer ? active_buffer->available() : 0;
+    return active + fifo_buffers_empty.len() * buffer_size >= bytes;
+}
+
+void SweepLogger::put(const void* p, size_t bytes) {
+    auto src = static_cast<const uint8_t*>(p);
+    while (bytes) {
+        if (!active_buffer && !fifo_buffers_empty.out(active_buffer)) {
+            // reserve() makes sure this doesn't happen.
+            return;
+        }
+
+        const size_t written = active_buffer->write(src, bytes);
+        src += written;
+        bytes -= written;
+
+        if (active_buffer->is_full()) {
+            submit_active_buffer();
+        }
+    }
+}
+
+void SweepLogger::submit_active_buffer() {
+    if (active_buffer && !active_buffer->is_empty()) {
+        fifo_buffers_full.in(active_buffer);
+        active_buffer = nullptr;
+        chBSemSignal(&buffers_ready);
+    }
+}
+
+msg_t SweepLogger::static_fn(void* arg) {
+    auto obj = static_cast<SweepLogger*>(arg);
+    obj->run();
+    return 0;
+}
+
+void SweepLogger::run() {
+    while (true) {
+        StreamBuffer* buffer{nullptr};
+        if (!fifo_buffers_full.out(buffer)) {
+            // Drain what was submitted before stopping.
+            if (chThdShouldTerminate()) {
+                break;
+            }
+            chBSemWait(&buffers_ready);
+            continue;
+        }
+
+        if (!failed_) {
+            auto result = file.write(buffer->data(), buffer->size());
+            if (result.is_error()) {
+                failed_ = true;
+            } else if (!buffer->is_full()) {
+                // Only indexes and the end of the log flush part of a buffer.
+                file.sync();
+            }
+        }
+
+        buffer->empty();
+        fifo_buffers_empty.in(buffer);
+    }
+}
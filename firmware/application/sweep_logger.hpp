@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SWEEP_LOGGER_H__
+#define __SWEEP_LOGGER_H__
+
+#include "ch.h"
+
+#include "file.hpp"
+#include "fifo.hpp"
+#include "message.hpp"
+#include "sweep_log.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory>
+
+/* Writes sweeps to a sweep_log file from its own thread. log() only copies
+ * into a few StreamBuffers and hands full ones over, like StreamInput does
+ * for captures, so the card never holds up the sweep. When the writer falls
+ * behind, whole sweeps are dropped and counted. Buffers are flushed at each
+ * index, so a power loss costs at most index_interval sweeps.
+ */
+class SweepLogger {
+   public:
+    SweepLogger(const std::filesystem::path& path, const uint16_t index_interval = 32);
+    ~SweepLogger();
+
+    SweepLogger(const SweepLogger&) = delete;
+    SweepLogger(SweepLogger&&) = delete;
+    SweepLogger& operator=(const SweepLogger&) = delete;
+    SweepLogger& operator=(SweepLogger&&) = delete;
+
+    bool log(
+        const uint64_t start_frequency,
+        const uint64_t stop_frequency,
+        const uint32_t bin_width,
+        const uint8_t* const bins,
+        const uint16_t bin_count);
+
+    /* The file couldn't be created or written, nothing more goes to it. */
+    bool failed() const { return failed_; }
+
+    uint32_t logged() const { return logged_; }
+    uint32_t dropped() const { return dropped_; }
+
+   private:
+    static constexpr size_t buffer_size = 2048;
+    static constexpr size_t buffer_count_log2 = 2;
+    static constexpr size_t buffer_count = 1 << buffer_count_log2;
+
+    File file{};
+    sweep_log::Encoder encoder;
+
+    std::unique_ptr<uint8_t[]> data;
+    std::array<StreamBuffer, buffer_count> buffers{};
+    std::array<StreamBuffer*, buffer_count> buffers_empty{};
+    std::array<StreamBuffer*, buffer_count> buffers_full{};
+    FIFO<StreamBuffer*> fifo_buffers_empty;
+    FIFO<StreamBuffer*> fifo_buffers_full;
+    StreamBuffer* active_buffer{nullptr};
+
+    BinarySemaphore buffers_ready{};
+    Thread* thread{nullptr};
+    volatile bool failed_{false};
+    uint32_t logged_{0};
+    uint32_t dropped_{0};
+
+    bool reserve(const size_t bytes);
+    void put(const void* p, size_t bytes);
+    void submit_active_buffer();
+
+    static msg_t static_fn(void* arg);
+    void run();
+};
+
+#endif /*__SWEEP_LOGGER_H__*/
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "sweep_thread.hpp"
+
+#include "portapack_shared_memory.hpp"
+#include "radio.hpp"
+
+SweepThread* SweepThread::obj{nullptr};
+
+SweepThread::SweepThread(
+    const rf::Frequency first_frequency,
+    const rf::Frequency step)
+    : first_frequency{first_frequency},
+      step{step} {
+    // Forget requests from an earlier sweep.
+    shared_memory.sweep_tuned = shared_memory.sweep_request;
+    obj = this;
+    thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, SweepThread::static_fn, this);
+}
+
+SweepThread::~SweepThread() {
+    if (thread) {
+        chThdTerminate(thread);
+        // The thread sleeps without a timeout, wake it to see the request.
+        chSysLock();
+        wakeup_isr();
+        chSchRescheduleS();
+        chSysUnlock();
+        chThdWait(thread);
+        thread = nullptr;
+    }
+    obj = nullptr;
+}
+
+msg_t SweepThread::static_fn(void* arg) {
+    auto obj = static_cast<SweepThread*>(arg);
+    obj->run();
+    return 0;
+}
+
+void SweepThread::run() {
+    while (!chThdShouldTerminate()) {
+        // Sleep until the M4 interrupt or the destructor readies us, the
+        // waker clears waiting so a thread is never readied twice.
+        chSysLock();
+        if (!chThdShouldTerminate() && (shared_memory.sweep_request == shared_memory.sweep_tuned)) {
+            waiting = chThdSelf();
+            chSchGoSleepS(THD_STATE_SUSPENDED);
+        }
+        chSysUnlock();
+
+        const uint32_t request = shared_memory.sweep_request;
+        if (request != shared_memory.sweep_tuned) {
+            radio::set_tuning_frequency(first_frequency + shared_memory.sweep_step * step);
+            shared_memory.sweep_tuned = request;
+        }
+    }
+}
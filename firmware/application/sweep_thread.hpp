@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SWEEP_THREAD_H__
+#define __SWEEP_THREAD_H__
+
+#include "ch.h"
+
+#include "rf_path.hpp"
+
+#include <cstdint>
+
+/* Tunes the steps the M4 sweep engine asks for, see SweepConfigMessage.
+ * Woken straight from the M4 interrupt, so retunes don't wait on the UI.
+ * Create it before sending the plan and destroy it after stopping it.
+ */
+class SweepThread {
+   public:
+    SweepThread(const rf::Frequency first_frequency, const rf::Frequency step);
+    ~SweepThread();
+
+    SweepThread(const SweepThread&) = delete;
+    SweepThread(SweepThread&&) = delete;
+    SweepThread& operator=(const SweepThread&) = delete;
+    SweepThread& operator=(SweepThread&&) = delete;
+
+    static void handle_isr() {
+        if (obj) {
+            obj->wakeup_isr();
+        }
+    }
+
+   private:
+    const rf::Frequency first_frequency;
+    const rf::Frequency step;
+    Thread* thread{nullptr};
+    Thread* waiting{nullptr};
+    static SweepThread* obj;
+
+    static msg_t static_fn(void* arg);
+    void run();
+
+    void wakeup_isr() {
+        auto thread_tmp = waiting;
+        if (thread_tmp) {
+            waiting = nullptr;
+            chSchReadyI(thread_tmp);
+        }
+    }
+};
+
+#endif /*__SWEEP_THREAD_H__*/
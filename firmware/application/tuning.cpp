@@ -23,6 +23,8 @@
 
 #include "utility.hpp"
 
+#include <cstdlib>
+
 namespace tuning {
 namespace config {
 
@@ -76,5 +78,20 @@ Config create(const rf::Frequency target_frequency) {
     }
 }
 
+Config create(const rf::Frequency target_frequency, const rf::Frequency first_lo_frequency) {
+    const auto planned = create(target_frequency);
+    if (!planned.is_valid() || planned.first_lo_frequency == 0 || first_lo_frequency == 0)
+        return planned;
+
+    // Low band mixes from above, high band from below.
+    const rf::Frequency second_lo_frequency = (planned.rf_path_band == rf::path::Band::Low)
+                                                  ? first_lo_frequency - target_frequency
+                                                  : target_frequency - first_lo_frequency;
+    if (std::abs(second_lo_frequency - planned.second_lo_frequency) > max_second_lo_offset)
+        return planned;
+
+    return {first_lo_frequency, second_lo_frequency, planned.rf_path_band, planned.mixer_invert};
+}
+
 } /* namespace config */
 } /* namespace tuning */
@@ -59,6 +59,15 @@ struct Config {
 
 Config create(const rf::Frequency target_frequency);
 
+/* How far the second LO may move from its planned frequency so that the
+ * first LO can be left alone. */
+constexpr rf::Frequency max_second_lo_offset = 10'000'000;
+
+/* Like create(), but keeps first_lo_frequency when it is in use and the
+ * resulting second LO stays within max_second_lo_offset of the plan. Only
+ * the MAX283x has to be retuned then, the RFFC507x keeps its lock. */
+Config create(const rf::Frequency target_frequency, const rf::Frequency first_lo_frequency);
+
 } /* namespace config */
 } /* namespace tuning */
 
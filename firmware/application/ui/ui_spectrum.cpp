@@ -21,8 +21,6 @@
 
 #include "ui_spectrum.hpp"
 
-#include "spectrum_color_lut.hpp"
-
 #include "portapack.hpp"
 using namespace portapack;
 
@@ -248,49 +246,24 @@ void FrequencyScale::on_tick_second() {
 }
 
 /* WaterfallWidget *********************************************************/
-// TODO: buffer and use "paint" instead of immediate drawing would help with
-// preventing flicker from drawing. Would use more RAM however.
 
 void WaterfallWidget::on_show() {
-    clear();
-
-    const auto screen_r = screen_rect();
-    display.scroll_set_area(screen_r.top(), screen_r.bottom());
+    surface.attach(screen_rect());
 }
 
 void WaterfallWidget::on_hide() {
-    /* TODO: Clear region to eliminate brief flash of content at un-shifted
-     * position?
-     */
-    display.scroll_disable();
+    surface.detach();
 }
 
 void WaterfallWidget::on_channel_spectrum(
     const ChannelSpectrum& spectrum) {
-    /* TODO: static_assert that message.spectrum.db.size() >= pixel_row.size() */
-
-    std::array<Color, 240> pixel_row;
-    for (size_t i = 0; i < 120; i++) {
-        const auto pixel_color = spectrum_rgb3_lut[spectrum.db[256 - 120 + i]];
-        pixel_row[i] = pixel_color;
-    }
-
-    for (size_t i = 120; i < 240; i++) {
-        const auto pixel_color = spectrum_rgb3_lut[spectrum.db[i - 120]];
-        pixel_row[i] = pixel_color;
-    }
-
-    const auto draw_y = display.scroll(1);
-
-    display.draw_pixels(
-        {{0, draw_y}, {pixel_row.size(), 1}},
-        pixel_row);
-}
+    static_assert(std::tuple_size<decltype(spectrum.db)>::value == 256, "ChannelSpectrum size unexpected");
 
-void WaterfallWidget::clear() {
-    display.fill_rectangle(
-        screen_rect(),
-        Color::black());
+    // Negative frequencies are at the top of the FFT output.
+    const size_t half = surface.width() / 2;
+    surface.set_levels(0, &spectrum.db[256 - half], half);
+    surface.set_levels(half, &spectrum.db[0], half);
+    surface.push_line();
 }
 
 /* WaterfallView *******************************************************/
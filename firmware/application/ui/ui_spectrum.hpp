@@ -24,8 +24,10 @@
 
 #include "ui.hpp"
 #include "ui_widget.hpp"
+#include "ui_waterfall.hpp"
 
 #include "event_m0.hpp"
+#include "spectrum_color_lut.hpp"
 
 #include "message.hpp"
 
@@ -117,7 +119,7 @@ class WaterfallWidget : public Widget {
     void on_channel_spectrum(const ChannelSpectrum& spectrum);
 
    private:
-    void clear();
+    WaterfallSurface surface{spectrum_rgb3_lut};
 };
 
 class WaterfallView : public View {
@@ -28,6 +28,8 @@
 using namespace hackrf::one;
 
 #include "string_format.hpp"
+#include "portapack_shared_memory.hpp"
+#include "rtc_time.hpp"
 
 namespace ui {
 
@@ -36,9 +38,52 @@ namespace ui {
 BasebandStatsView::BasebandStatsView() {
     add_children({
         &text_stats,
+        &text_profile,
     });
 }
 
+void BasebandStatsView::on_show() {
+    shared_memory.m4_profile.reset_requested = true;
+    shared_memory.m4_profile.enabled = true;
+    signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+        this->on_tick_second();
+    };
+}
+
+void BasebandStatsView::on_hide() {
+    rtc_time::signal_tick_second -= signal_token_tick_second;
+    shared_memory.m4_profile.enabled = false;
+}
+
+static std::string budget_percent_string(const uint32_t cycles, const uint32_t budget) {
+    return to_string_dec_uint(std::min<uint32_t>(cycles / (budget / 100), 999), 3) + "%";
+}
+
+void BasebandStatsView::on_tick_second() {
+    cycle_profile::Profile profile{};
+    if (!cycle_profile::snapshot(shared_memory.m4_profile, profile) || (profile.budget_cycles < 100)) {
+        return;
+    }
+
+    const auto& buffer = profile.scopes[static_cast<size_t>(cycle_profile::Scope::Buffer)];
+    if (buffer.count == 0) {
+        return;
+    }
+
+    // The stage with the highest worst case, leaving out the whole buffer.
+    size_t worst = 1;
+    for (size_t i = 2; i < cycle_profile::scope_count; i++) {
+        if (profile.scopes[i].max > profile.scopes[worst].max) {
+            worst = i;
+        }
+    }
+
+    text_profile.set(
+        budget_percent_string(buffer.average(), profile.budget_cycles) + " " +
+        budget_percent_string(buffer.max, profile.budget_cycles) + " " +
+        cycle_profile::scope_names[worst]);
+}
+
 static std::string ticks_to_percent_string(const uint32_t ticks) {
     constexpr size_t decimal_digits = 1;
     constexpr size_t decimal_factor = decimal_digits * 10;
@@ -27,6 +27,7 @@
 #include "event_m0.hpp"
 
 #include "message.hpp"
+#include "signal.hpp"
 
 namespace ui {
 
@@ -34,12 +35,26 @@ class BasebandStatsView : public View {
    public:
     BasebandStatsView();
 
+    void on_show() override;
+    void on_hide() override;
+
    private:
     Text text_stats{
         {0 * 8, 0, (4 * 4 + 3) * 8, 1 * 16},
         "",
     };
 
+    /* Per buffer M4 load from the cycle profiler: average and worst case as
+     * a percentage of the buffer budget, and the stage with the worst case. */
+    Text text_profile{
+        {0 * 8, 1 * 16, (4 * 4 + 3) * 8, 1 * 16},
+        "",
+    };
+
+    SignalToken signal_token_tick_second{};
+
+    void on_tick_second();
+
     MessageHandlerRegistration message_handler_stats{
         Message::ID::BasebandStatistics,
         [this](const Message* const p) {
@@ -27,6 +27,7 @@ using namespace portapack;
 #include "io_file.hpp"
 #include "io_wave.hpp"
 #include "io_convert.hpp"
+#include "usb_iq_stream.hpp"
 
 #include "baseband_api.hpp"
 #include "metadata_file.hpp"
@@ -181,6 +182,22 @@ void RecordView::start() {
         return;
     }
 
+    if (is_usb_stream()) {
+        const bool c8 = file_type == FileType::UsbS8;
+        auto p = std::make_unique<UsbIqWriter>(
+            usb_iq_stream::Format{receiver_model.target_frequency(), sampling_rate, uint8_t(c8 ? 1 : 2)},
+            c8);
+        if (!p->is_open()) {
+            if (on_error) {
+                on_error("USB stream busy");
+            }
+        } else {
+            start_capture(std::move(p), "USB");
+        }
+        update_status_display();
+        return;
+    }
+
     std::filesystem::path base_path;
 
     auto tmp_path = filename_stem_pattern;  // store it, to be able to modify without causing permanent change
@@ -244,6 +261,17 @@ void RecordView::start() {
             if (create_error.is_valid()) {
                 handle_error(create_error.value());
             } else {
+                if (preallocate_seconds > 0) {
+                    // Best effort, without a large enough contiguous area the file just grows as usual.
+                    // Capped to half the free space and below the FAT32 file size limit.
+                    const uint64_t bytes_per_sample = (file_type == FileType::RawS16) ? 4 : 2;
+                    const uint64_t free_bytes = std::filesystem::space(u"").free;
+                    const uint64_t bytes = std::min<uint64_t>(
+                        {uint64_t(sampling_rate) * bytes_per_sample * preallocate_seconds,
+                         free_bytes / 2,
+                         max_preallocate_bytes});
+                    p->preallocate(bytes);
+                }
                 writer = std::move(p);
             }
         } break;
@@ -253,24 +281,32 @@ void RecordView::start() {
     };
 
     if (writer) {
-        text_record_filename.set(truncate(base_path.filename().string(), 8));
-        button_record.set_bitmap(&bitmap_stop);
-        capture_thread = std::make_unique<CaptureThread>(
-            std::move(writer),
-            write_size, buffer_count,
-            []() {
-                CaptureThreadDoneMessage message{};
-                EventDispatcher::send_message(message);
-            },
-            [](File::Error error) {
-                CaptureThreadDoneMessage message{error.code()};
-                EventDispatcher::send_message(message);
-            });
+        start_capture(std::move(writer), truncate(base_path.filename().string(), 8));
     }
 
     update_status_display();
 }
 
+bool RecordView::is_usb_stream() const {
+    return file_type == FileType::UsbS8 || file_type == FileType::UsbS16;
+}
+
+void RecordView::start_capture(std::unique_ptr<stream::Writer> writer, const std::string& name) {
+    text_record_filename.set(name);
+    button_record.set_bitmap(&bitmap_stop);
+    capture_thread = std::make_unique<CaptureThread>(
+        std::move(writer),
+        write_size, buffer_count,
+        []() {
+            CaptureThreadDoneMessage message{};
+            EventDispatcher::send_message(message);
+        },
+        [](File::Error error) {
+            CaptureThreadDoneMessage message{error.code()};
+            EventDispatcher::send_message(message);
+        });
+}
+
 void RecordView::on_hide() {
     stop();  // Stop current recording
     View::on_hide();
@@ -303,7 +339,14 @@ void RecordView::update_status_display() {
     }
     */
 
-    if (sampling_rate > 0) {
+    if (is_usb_stream()) {
+        // Blocks the host didn't take in time instead of the SD card space left.
+        if (is_active()) {
+            text_time_available.set("lost" + to_string_dec_uint(usb_iq_stream::status().dropped, 5, ' '));
+        } else {
+            text_time_available.set("");
+        }
+    } else if (sampling_rate > 0) {
         const auto space_info = std::filesystem::space(u"");
         // - Audio is 1 int16_t per sample or '2' bytes per sample.
         // - C8 captures 2 (I,Q) int8_t per sample or '2' bytes per sample.
@@ -44,6 +44,8 @@ class RecordView : public View {
         RawS8 = 1,
         RawS16 = 2,
         WAV = 3,
+        UsbS8 = 4,  // Streamed live over USB serial, see usb_iq_stream.hpp
+        UsbS16 = 5,
     };
 
     RecordView(
@@ -65,6 +67,8 @@ class RecordView : public View {
 
     void set_file_type(const FileType v) { file_type = v; }
     void set_auto_trim(bool v) { auto_trim = v; }
+    /* Raw captures reserve a contiguous file extent for this many seconds, 0 to disable. */
+    void set_preallocate_seconds(uint32_t v) { preallocate_seconds = v; }
 
     void start();
     void stop();
@@ -82,6 +86,8 @@ class RecordView : public View {
     void on_tick_second();
     void update_status_display();
     void trim_capture();
+    bool is_usb_stream() const;
+    void start_capture(std::unique_ptr<stream::Writer> writer, const std::string& name);
 
     void handle_capture_thread_done(const File::Error error);
     void handle_error(const File::Error error);
@@ -109,6 +115,8 @@ class RecordView : public View {
     SignalToken signal_token_tick_second{};
 
     bool auto_trim = false;
+    uint32_t preallocate_seconds = 0;
+    static constexpr uint64_t max_preallocate_bytes = 0xFFF00000;
     std::filesystem::path trim_path{};
     TrimProgressUI trim_ui{};
 
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "usb_iq_stream.hpp"
+
+#include "iq_block_ring.hpp"
+#include "io_convert.hpp"
+
+#include "ch.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace usb_iq_stream {
+
+namespace {
+
+/* Owned by the open writer. The shell only borrows the ring inside read(),
+ * flagged by reading, and close() waits for it to let go. */
+std::unique_ptr<uint8_t[]> storage{};
+std::unique_ptr<IqBlockRing> ring{};
+Format format{};
+uint32_t epoch{0};
+volatile bool reading{false};
+
+bool open(const Format& new_format) {
+    auto new_storage = std::make_unique<uint8_t[]>(IqBlockRing::storage_size(block_size, block_count));
+    auto new_ring = std::make_unique<IqBlockRing>(new_storage.get(), block_size, block_count);
+
+    chSysLock();
+    const bool busy = (bool)ring;
+    if (!busy) {
+        storage = std::move(new_storage);
+        ring = std::move(new_ring);
+        format = new_format;
+        epoch++;
+    }
+    chSysUnlock();
+
+    return !busy;
+}
+
+void close() {
+    chSysLock();
+    auto old_ring = std::move(ring);
+    auto old_storage = std::move(storage);
+    format.sample_bytes = 0;
+    chSysUnlock();
+
+    while (reading)
+        chThdSleepMilliseconds(1);
+}
+
+void push(const void* const data, const size_t size) {
+    ring->push(data, size);
+}
+
+} /* namespace */
+
+Status status() {
+    Status s{};
+    chSysLock();
+    s.epoch = epoch;
+    s.format = format;
+    if (ring) {
+        s.blocks = ring->blocks();
+        s.dropped = ring->dropped();
+    }
+    chSysUnlock();
+    return s;
+}
+
+size_t read(void* const out, uint32_t& index) {
+    chSysLock();
+    IqBlockRing* const r = ring.get();
+    reading = (r != nullptr);
+    chSysUnlock();
+
+    if (!r)
+        return 0;
+
+    const size_t size = r->pop(out, index);
+    reading = false;
+    return size;
+}
+
+} /* namespace usb_iq_stream */
+
+UsbIqWriter::UsbIqWriter(
+    const usb_iq_stream::Format& format,
+    const bool convert_c16_to_c8)
+    : convert_c16_to_c8{convert_c16_to_c8},
+      open_{usb_iq_stream::open(format)} {
+}
+
+UsbIqWriter::~UsbIqWriter() {
+    if (open_)
+        usb_iq_stream::close();
+}
+
+File::Result<File::Size> UsbIqWriter::write(const void* const buffer, const File::Size bytes) {
+    if (!open_)
+        return File::Size{bytes};
+
+    if (convert_c16_to_c8)
+        file_convert::c16_to_c8(buffer, bytes);
+
+    const auto data = static_cast<const uint8_t*>(buffer);
+    const size_t size = convert_c16_to_c8 ? bytes / 2 : bytes;
+    for (size_t offset = 0; offset < size; offset += usb_iq_stream::block_size)
+        usb_iq_stream::push(&data[offset], std::min(size - offset, usb_iq_stream::block_size));
+
+    return File::Size{bytes};
+}
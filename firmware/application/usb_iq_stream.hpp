@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __USB_IQ_STREAM_H__
+#define __USB_IQ_STREAM_H__
+
+#include "io.hpp"
+#include "usb_serial_frame.hpp"
+
+#include <cstdint>
+#include <cstddef>
+
+/* Live IQ from a capture to the USB serial port. The capture side writes
+ * through a UsbIqWriter, which never blocks; the shell's binary mode drains
+ * the blocks with the Iq request while the host keeps up and the writer
+ * drops and counts whole blocks when it doesn't. */
+namespace usb_iq_stream {
+
+/* Capture buffers split evenly into blocks, so the host can place each
+ * one by its number alone and fill the gaps left by dropped ones. */
+constexpr size_t block_size = 1024;
+/* A 16 KiB capture buffer, or two once converted to C8. */
+constexpr size_t block_count = 20;
+
+struct Format {
+    uint64_t frequency;
+    uint32_t sampling_rate;
+    uint8_t sample_bytes;  // Per I or Q value, 1 for C8 and 2 for C16
+};
+
+struct Status {
+    uint32_t epoch;   // Bumped each time a writer starts
+    Format format;    // sample_bytes is 0 while no writer is open
+    uint32_t blocks;  // Handed to the writer since it started
+    uint32_t dropped;
+};
+
+Status status();
+
+/* Copies the oldest block to out, which needs block_size bytes. Returns
+ * its size, 0 when there is none. */
+size_t read(void* const out, uint32_t& index);
+
+} /* namespace usb_iq_stream */
+
+class UsbIqWriter : public stream::Writer {
+   public:
+    /* Capture buffers are C16, convert_c16_to_c8 halves them on the way. */
+    UsbIqWriter(const usb_iq_stream::Format& format, const bool convert_c16_to_c8);
+    ~UsbIqWriter();
+
+    UsbIqWriter(const UsbIqWriter&) = delete;
+    UsbIqWriter& operator=(const UsbIqWriter&) = delete;
+    UsbIqWriter(UsbIqWriter&&) = delete;
+    UsbIqWriter& operator=(UsbIqWriter&&) = delete;
+
+    /* False if another writer is streaming already. */
+    bool is_open() const { return open_; }
+
+    /* Always takes all of the buffer, whatever didn't fit is counted as dropped. */
+    File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+   private:
+    const bool convert_c16_to_c8;
+    bool open_{false};
+};
+
+#endif /*__USB_IQ_STREAM_H__*/
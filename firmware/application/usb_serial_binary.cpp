@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "usb_serial_binary.hpp"
+#include "usb_serial_frame.hpp"
+#include "usb_serial_device_to_host.h"
+#include "usb_iq_stream.hpp"
+#include "usb_serial_shell_filesystem.hpp"
+
+#include "event_m0.hpp"
+#include "portapack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+using namespace serial_frame;
+
+namespace {
+
+constexpr systime_t ack_timeout = MS2ST(500);
+constexpr systime_t data_timeout = S2ST(5);
+constexpr systime_t idle_timeout = S2ST(30);
+constexpr size_t max_retries = 8;
+constexpr systime_t iq_info_interval = S2ST(1);
+constexpr systime_t iq_idle_poll = MS2ST(2);
+
+void put_u16(uint8_t* const p, const uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+void put_u32(uint8_t* const p, const uint32_t v) {
+    for (size_t i = 0; i < 4; i++)
+        p[i] = v >> (i * 8);
+}
+
+uint32_t get_u32(const uint8_t* const p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+/* Lives on the heap while in binary mode, the shell stack is too small. */
+class Session {
+   public:
+    Session(BaseSequentialStream* chp, EventDispatcher* evtd)
+        : chp{chp}, evtd{evtd} {
+    }
+
+    void run();
+
+   private:
+    BaseSequentialStream* const chp;
+    EventDispatcher* const evtd;
+
+    Decoder decoder{};
+    std::array<uint8_t, 64> input{};
+    size_t input_read{0};
+    size_t input_fill{0};
+
+    Frame frame{};
+    bool frame_ready{false};
+    std::array<uint8_t, max_payload + 1> frame_payload{};
+
+    SendWindow window_{};
+    std::array<uint8_t, max_payload> chunk{};
+    std::array<uint8_t, max_frame_size> output{};
+    std::array<uint8_t, usb_iq_stream::block_size> iq_block{};
+
+    bool receive(const systime_t timeout);
+    void write(const uint8_t* const data, const size_t size);
+    void send(const Type type, const uint8_t sequence, const void* const payload = nullptr, const size_t length = 0);
+    void send_error(const char* const message);
+    void resend_window();
+    std::filesystem::path frame_path();
+
+    template <typename Produce>
+    bool send_stream(Produce produce);
+    template <typename Consume>
+    bool receive_stream(Consume consume);
+
+    void get_file();
+    void put_file();
+    void screen();
+    void send_iq_info(const usb_iq_stream::Status& status);
+    void stream_iq();
+};
+
+bool Session::receive(const systime_t timeout) {
+    const systime_t start = chTimeNow();
+    frame_ready = false;
+
+    while (true) {
+        // Stop at the frame, the bytes after it belong to the next receive().
+        while (input_read < input_fill && !frame_ready) {
+            decoder.feed(&input[input_read++], 1, [this](const Frame& f) {
+                memcpy(frame_payload.data(), f.payload, f.length);
+                frame_payload[f.length] = 0;
+                frame = {f.type, f.sequence, f.length, frame_payload.data()};
+                frame_ready = true;
+            });
+        }
+        if (frame_ready)
+            return true;
+
+        input_read = 0;
+        input_fill = chnReadTimeout((BaseChannel*)chp, input.data(), input.size(), TIME_IMMEDIATE);
+        if (input_fill == 0) {
+            const systime_t elapsed = chTimeNow() - start;
+            if (elapsed >= timeout)
+                return false;
+
+            const msg_t c = chnGetTimeout((BaseChannel*)chp, timeout - elapsed);
+            if (c < Q_OK)
+                return false;
+            input[0] = c;
+            input_fill = 1;
+        }
+    }
+}
+
+void Session::write(const uint8_t* const data, const size_t size) {
+    fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, data, size);
+}
+
+void Session::send(const Type type, const uint8_t sequence, const void* const payload, const size_t length) {
+    write(output.data(), encode(type, sequence, payload, length, output.data()));
+}
+
+void Session::send_error(const char* const message) {
+    send(Type::Error, 0, message, strlen(message));
+}
+
+void Session::resend_window() {
+    for (size_t i = 0; i < window_.pending(); i++)
+        write(window_.at(i).data.data(), window_.at(i).size);
+}
+
+std::filesystem::path Session::frame_path() {
+    return path_from_string8(reinterpret_cast<char*>(frame_payload.data()));
+}
+
+template <typename Produce>
+bool Session::send_stream(Produce produce) {
+    window_.reset();
+    uint32_t total = 0;
+    uint32_t crc = 0;
+    bool ended = false;
+    size_t retries = 0;
+
+    while (true) {
+        while (!ended && !window_.full()) {
+            const int32_t length = produce(chunk.data());
+            if (length < 0) {
+                send_error("read failed");
+                return false;
+            }
+
+            if (length == 0) {
+                uint8_t end[8];
+                put_u32(&end[0], total);
+                put_u32(&end[4], crc);
+                const auto& slot = window_.push(Type::End, end, sizeof(end));
+                write(slot.data.data(), slot.size);
+                ended = true;
+            } else {
+                total += length;
+                crc = crc32(chunk.data(), length, crc);
+                const auto& slot = window_.push(Type::Data, chunk.data(), length);
+                write(slot.data.data(), slot.size);
+            }
+        }
+
+        if (ended && window_.empty())
+            return true;
+
+        if (!receive(ack_timeout)) {
+            if (++retries > max_retries)
+                return false;
+            resend_window();
+            continue;
+        }
+
+        switch (frame.type) {
+            case Type::Ack:
+                if (window_.ack(frame.sequence))
+                    retries = 0;
+                break;
+
+            case Type::Nak:
+                if (window_.ack(frame.sequence))
+                    resend_window();
+                break;
+
+            case Type::Error:
+            case Type::Exit:
+                return false;
+
+            default:
+                break;
+        }
+    }
+}
+
+template <typename Consume>
+bool Session::receive_stream(Consume consume) {
+    uint8_t expected = 0;
+    uint32_t total = 0;
+    uint32_t crc = 0;
+    size_t unacked = 0;
+    bool nak_sent = false;
+
+    send(Type::Ack, expected);  // Ready
+
+    while (receive(data_timeout)) {
+        if (frame.type == Type::Error || frame.type == Type::Exit)
+            return false;
+        if (frame.type != Type::Data && frame.type != Type::End)
+            continue;
+
+        if (frame.sequence != expected) {
+            if (static_cast<uint8_t>(expected - frame.sequence) <= window) {
+                send(Type::Ack, expected);  // A resend of what we have, our ack got lost
+            } else if (!nak_sent) {
+                send(Type::Nak, expected);
+                nak_sent = true;
+            }
+            continue;
+        }
+        nak_sent = false;
+        expected++;
+
+        if (frame.type == Type::End) {
+            if (frame.length != 8 || get_u32(&frame.payload[0]) != total || get_u32(&frame.payload[4]) != crc) {
+                send_error("size or CRC mismatch");
+                return false;
+            }
+            send(Type::Ack, expected);
+            return true;
+        }
+
+        if (!consume(frame.payload, frame.length)) {
+            send_error("write failed");
+            return false;
+        }
+        total += frame.length;
+        crc = crc32(frame.payload, frame.length, crc);
+
+        if (++unacked >= window / 2) {
+            send(Type::Ack, expected);
+            unacked = 0;
+        }
+    }
+    return false;
+}
+
+void Session::get_file() {
+    File file;
+    auto error = file.open(frame_path());
+    if (error) {
+        send_error(error.value().what().c_str());
+        return;
+    }
+
+    send_stream([&file](uint8_t* const data) -> int32_t {
+        auto result = file.read(data, max_payload);
+        return result ? static_cast<int32_t>(*result) : -1;
+    });
+}
+
+void Session::put_file() {
+    File file;
+    auto error = file.create(frame_path());
+    if (error) {
+        send_error(error.value().what().c_str());
+        return;
+    }
+
+    receive_stream([&file](const uint8_t* const data, const size_t length) {
+        auto result = file.write(data, length);
+        return result && *result == length;
+    });
+}
+
+void Session::screen() {
+    // Pixels are read back from the LCD, keep the UI from drawing meanwhile.
+    evtd->enter_shell_working_mode();
+
+    int y = 0;
+    send_stream([&y](uint8_t* const data) -> int32_t {
+        if (y == ui::screen_height)
+            return 0;
+
+        std::array<ui::ColorRGB888, ui::screen_width> row;
+        portapack::display.read_pixels({0, y++, ui::screen_width, 1}, row);
+
+        std::array<uint16_t, ui::screen_width> pixels;
+        for (size_t x = 0; x < pixels.size(); x++)
+            pixels[x] = ui::Color(row[x].r, row[x].g, row[x].b).v;
+        return rle_encode(pixels.data(), pixels.size(), data);
+    });
+
+    evtd->exit_shell_working_mode();
+}
+
+void Session::send_iq_info(const usb_iq_stream::Status& status) {
+    uint8_t info[23];
+    put_u32(&info[0], status.format.frequency);
+    put_u32(&info[4], status.format.frequency >> 32);
+    put_u32(&info[8], status.format.sampling_rate);
+    info[12] = status.format.sample_bytes;
+    put_u16(&info[13], usb_iq_stream::block_size);
+    put_u32(&info[15], status.blocks);
+    put_u32(&info[19], status.dropped);
+    send(Type::IqInfo, 0, info, sizeof(info));
+}
+
+void Session::stream_iq() {
+    uint8_t sequence = 0;
+    auto status = usb_iq_stream::status();
+    systime_t info_time = chTimeNow();
+    send_iq_info(status);
+
+    while (true) {
+        const auto latest = usb_iq_stream::status();
+        if (latest.epoch != status.epoch ||
+            latest.format.sample_bytes != status.format.sample_bytes ||
+            chTimeNow() - info_time >= iq_info_interval) {
+            status = latest;
+            info_time = chTimeNow();
+            send_iq_info(status);
+        }
+
+        uint32_t index = 0;
+        const size_t size = usb_iq_stream::read(iq_block.data(), index);
+        for (size_t offset = 0; offset < size; offset += max_iq_data) {
+            const size_t length = std::min(size - offset, max_iq_data);
+            put_u32(&chunk[0], index);
+            put_u16(&chunk[4], offset);
+            memcpy(&chunk[iq_data_header], &iq_block[offset], length);
+            send(Type::IqData, sequence++, chunk.data(), iq_data_header + length);
+        }
+
+        // Any frame from the host ends the stream, only wait for one while idle.
+        if (receive(size ? TIME_IMMEDIATE : iq_idle_poll))
+            break;
+    }
+
+    send_iq_info(usb_iq_stream::status());
+    send(Type::Ack, frame.sequence);
+}
+
+void Session::run() {
+    while (receive(idle_timeout)) {
+        switch (frame.type) {
+            case Type::Get:
+                get_file();
+                break;
+
+            case Type::Put:
+                put_file();
+                break;
+
+            case Type::Screen:
+                screen();
+                break;
+
+            case Type::Iq:
+                stream_iq();
+                break;
+
+            case Type::Exit:
+                send(Type::Ack, frame.sequence);
+                return;
+
+            case Type::Ack:
+            case Type::Nak:
+            case Type::Error:
+            case Type::Data:
+            case Type::End:
+                break;  // Left over from an aborted request
+
+            default:
+                send_error("unknown request");
+                break;
+        }
+    }
+}
+
+static_assert(max_rle_size(ui::screen_width) <= max_payload, "Screen line doesn't fit a frame");
+
+} /* namespace */
+
+void usb_serial_binary_mode(BaseSequentialStream* chp, EventDispatcher* evtd) {
+    auto session = std::make_unique<Session>(chp, evtd);
+    session->run();
+}
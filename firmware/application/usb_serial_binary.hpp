@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __USB_SERIAL_BINARY_H__
+#define __USB_SERIAL_BINARY_H__
+
+#include "ch.h"
+#include "hal.h"
+
+class EventDispatcher;
+
+/* Serves serial_frame requests on chp until the host sends Exit or goes
+ * quiet, then returns to the text shell. */
+void usb_serial_binary_mode(BaseSequentialStream* chp, EventDispatcher* evtd);
+
+#endif /*__USB_SERIAL_BINARY_H__*/
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "usb_serial_frame.hpp"
+
+#include <cstring>
+
+namespace serial_frame {
+
+static void put_u16(uint8_t* const p, const uint16_t v) {
+    p[0] = v & 0xff;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t* const p, const uint32_t v) {
+    put_u16(p, v & 0xffff);
+    put_u16(p + 2, v >> 16);
+}
+
+static uint32_t get_u32(const uint8_t* const p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint32_t crc32(const void* const data, const size_t length, uint32_t crc) {
+    // Reflected 0x04C11DB7, a nibble at a time: small enough for flash, fast enough for USB FS.
+    static constexpr uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= p[i];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+        crc = (crc >> 4) ^ table[crc & 0x0f];
+    }
+    return ~crc;
+}
+
+size_t encode(
+    const Type type,
+    const uint8_t sequence,
+    const void* const payload,
+    const size_t length,
+    uint8_t* const out) {
+    out[0] = sync_0;
+    out[1] = sync_1;
+    out[2] = static_cast<uint8_t>(type);
+    out[3] = sequence;
+    put_u16(&out[4], length);
+    if (length)
+        memcpy(&out[header_size], payload, length);
+    put_u32(&out[header_size + length], crc32(&out[2], header_size - 2 + length));
+    return header_size + length + trailer_size;
+}
+
+/* Decoder ***************************************************************/
+
+void Decoder::reset() {
+    fill = 0;
+}
+
+void Decoder::drop(const size_t count) {
+    fill -= count;
+    memmove(&buffer[0], &buffer[count], fill);
+}
+
+bool Decoder::parse() {
+    while (fill > 0) {
+        if (buffer[0] != sync_0 || (fill > 1 && buffer[1] != sync_1)) {
+            drop(1);
+            continue;
+        }
+        if (fill < header_size)
+            return false;
+
+        const size_t length = buffer[4] | (buffer[5] << 8);
+        if (length > max_payload) {
+            errors_++;
+            drop(1);
+            continue;
+        }
+
+        const size_t size = header_size + length + trailer_size;
+        if (fill < size)
+            return false;
+
+        if (crc32(&buffer[2], header_size - 2 + length) != get_u32(&buffer[header_size + length])) {
+            errors_++;
+            drop(1);
+            continue;
+        }
+
+        frame_ = {static_cast<Type>(buffer[2]), buffer[3], static_cast<uint16_t>(length), &buffer[header_size]};
+        frame_size = size;
+        return true;
+    }
+    return false;
+}
+
+/* SendWindow ************************************************************/
+
+const SendWindow::Slot& SendWindow::push(const Type type, const void* const payload, const size_t length) {
+    auto& slot = slots[(first + count) % window];
+    slot.size = encode(type, next++, payload, length, slot.data.data());
+    count++;
+    return slot;
+}
+
+bool SendWindow::ack(const uint8_t next_expected) {
+    const uint8_t oldest = next - count;
+    const size_t acked = static_cast<uint8_t>(next_expected - oldest);
+    if (acked > count)
+        return false;
+
+    first = (first + acked) % window;
+    count -= acked;
+    return true;
+}
+
+/* RLE *******************************************************************/
+
+static uint8_t* put_pixel(uint8_t* out, const uint16_t pixel) {
+    put_u16(out, pixel);
+    return out + 2;
+}
+
+size_t rle_encode(const uint16_t* const pixels, const size_t count, uint8_t* const out) {
+    uint8_t* p = out;
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && run < 129 && pixels[i + run] == pixels[i])
+            run++;
+
+        if (run > 1) {
+            *p++ = 126 + run;
+            p = put_pixel(p, pixels[i]);
+            i += run;
+        } else {
+            uint8_t* const control = p++;
+            size_t literal = 0;
+            while (i < count && literal < 128 && !(i + 1 < count && pixels[i + 1] == pixels[i])) {
+                p = put_pixel(p, pixels[i++]);
+                literal++;
+            }
+            *control = literal - 1;
+        }
+    }
+    return p - out;
+}
+
+size_t rle_decode(const uint8_t* const data, const size_t size, uint16_t* const pixels, const size_t count) {
+    size_t i = 0;
+    size_t o = 0;
+    while (i < size) {
+        const uint8_t control = data[i++];
+        const size_t n = (control < 128) ? control + 1 : control - 126;
+        const size_t bytes = (control < 128) ? n * 2 : 2;
+        if (i + bytes > size || o + n > count)
+            return 0;
+
+        for (size_t k = 0; k < n; k++) {
+            const size_t at = (control < 128) ? i + k * 2 : i;
+            pixels[o++] = data[at] | (data[at + 1] << 8);
+        }
+        i += bytes;
+    }
+    return o;
+}
+
+} /* namespace serial_frame */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __USB_SERIAL_FRAME_H__
+#define __USB_SERIAL_FRAME_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Framing of the shell's binary mode, entered with "binmode":
+ *
+ *   'P' 'F' type sequence length(u16) payload[length] crc32(u32)
+ *
+ * Little endian. The CRC is zlib's CRC-32 over type to the end of the
+ * payload. Data and End frames are numbered; the receiver acks with the
+ * next number it expects, at least every window / 2 frames, and naks with
+ * it on a gap. The sender keeps up to window frames in flight and goes
+ * back to the first unacked one on a nak or a timeout.
+ *
+ * Iq is the exception: IqInfo and IqData frames go out as they come, unacked,
+ * until the host sends any frame. The answer to that is a last IqInfo and an
+ * Ack. Blocks the device had to drop leave a gap in the IqData block numbers.
+ */
+namespace serial_frame {
+
+constexpr uint8_t sync_0 = 'P';
+constexpr uint8_t sync_1 = 'F';
+constexpr size_t header_size = 6;
+constexpr size_t trailer_size = 4;
+constexpr size_t max_payload = 512;
+constexpr size_t max_frame_size = header_size + max_payload + trailer_size;
+constexpr size_t window = 4;
+constexpr size_t iq_data_header = 6;
+constexpr size_t max_iq_data = max_payload - iq_data_header;
+
+enum class Type : uint8_t {
+    Ack = 0x01,     // sequence: next one expected
+    Nak = 0x02,     // sequence: next one expected, resend from there
+    Error = 0x03,   // payload: message, ends the request
+    Get = 0x10,     // payload: path; answered by Data frames and End
+    Put = 0x11,     // payload: path; acked, then Data frames and End from the host
+    Screen = 0x12,  // answered by one Data frame of rle() pixels per line, and End
+    Iq = 0x13,      // streams the running capture, see above
+    Exit = 0x1F,    // acked, back to the text shell
+    Data = 0x20,
+    End = 0x21,  // payload: u32 byte count, u32 crc32 of all Data payloads
+    // payload: u64 frequency, u32 sampling rate, u8 bytes per I or Q value (0: no
+    // capture running), u16 block size, u32 blocks so far, u32 blocks dropped
+    IqInfo = 0x22,
+    // payload: u32 block number, u16 offset in the block, up to max_iq_data bytes
+    IqData = 0x23,
+};
+
+struct Frame {
+    Type type;
+    uint8_t sequence;
+    uint16_t length;
+    const uint8_t* payload;
+};
+
+/* zlib compatible, continue a running CRC by passing it back in. */
+uint32_t crc32(const void* const data, const size_t length, const uint32_t crc = 0);
+
+/* Writes a frame to out, which needs length + header_size + trailer_size bytes. */
+size_t encode(
+    const Type type,
+    const uint8_t sequence,
+    const void* const payload,
+    const size_t length,
+    uint8_t* const out);
+
+/* Picks frames out of a byte stream. Anything that isn't a complete frame
+ * with a good CRC is skipped a byte at a time until the next sync. */
+class Decoder {
+   public:
+    /* Calls on_frame(const Frame&) for each frame completed by data. The
+     * payload only lives for the duration of the call. */
+    template <typename OnFrame>
+    void feed(const uint8_t* const data, const size_t size, OnFrame on_frame) {
+        for (size_t i = 0; i < size; i++) {
+            buffer[fill++] = data[i];
+            while (parse()) {
+                on_frame(frame_);
+                drop(frame_size);
+            }
+        }
+    }
+
+    /* Frames dropped for a bad length or CRC. */
+    uint32_t errors() const { return errors_; }
+
+    void reset();
+
+   private:
+    std::array<uint8_t, max_frame_size> buffer{};
+    size_t fill{0};
+    size_t frame_size{0};
+    uint32_t errors_{0};
+    Frame frame_{};
+
+    bool parse();
+    void drop(const size_t count);
+};
+
+/* Go back N bookkeeping for the sending side: frames stay encoded until acked. */
+class SendWindow {
+   public:
+    struct Slot {
+        std::array<uint8_t, max_frame_size> data;
+        size_t size;
+    };
+
+    bool full() const { return count == window; }
+    bool empty() const { return count == 0; }
+
+    /* Unacked frames, oldest first. */
+    size_t pending() const { return count; }
+    const Slot& at(const size_t index) const { return slots[(first + index) % window]; }
+
+    /* Frames payload with the next sequence number, call only when not full(). */
+    const Slot& push(const Type type, const void* const payload, const size_t length);
+
+    /* Releases frames before next_expected, false if it isn't one in flight or the next. */
+    bool ack(const uint8_t next_expected);
+
+    uint8_t next_sequence() const { return next; }
+
+    /* Forgets everything in flight, numbering restarts at 0. */
+    void reset() {
+        first = 0;
+        count = 0;
+        next = 0;
+    }
+
+   private:
+    std::array<Slot, window> slots{};
+    size_t first{0};
+    size_t count{0};
+    uint8_t next{0};
+};
+
+/* PackBits over 16 bit pixels: a control byte c < 128 is followed by c + 1
+ * literal pixels, c >= 128 by one pixel repeated c - 126 times. out needs
+ * max_rle_size(count) bytes. */
+constexpr size_t max_rle_size(const size_t count) {
+    return count * 2 + (count + 127) / 128;
+}
+
+size_t rle_encode(const uint16_t* const pixels, const size_t count, uint8_t* const out);
+
+/* Returns the pixels written, at most count; 0 on malformed input. */
+size_t rle_decode(const uint8_t* const data, const size_t size, uint16_t* const pixels, const size_t count);
+
+} /* namespace serial_frame */
+
+#endif /*__USB_SERIAL_FRAME_H__*/
@@ -48,6 +48,7 @@
 
 #include "ui_navigation.hpp"
 #include "usb_serial_shell_filesystem.hpp"
+#include "usb_serial_binary.hpp"
 
 #include "portapack_persistent_memory.hpp"
 
@@ -978,6 +979,64 @@ static void cmd_sysinfo(BaseSequentialStream* chp, int argc, char* argv[]) {
     return;
 }
 
+static void cmd_m4profile(BaseSequentialStream* chp, int argc, char* argv[]) {
+    const char* usage =
+        "usage: m4profile [on|off|reset]\r\n"
+        "without arguments, prints cycles per call of each M4 stage\r\n";
+    auto& profile = shared_memory.m4_profile;
+
+    if (argc == 1) {
+        if (strcmp(argv[0], "on") == 0) {
+            profile.reset_requested = true;
+            profile.enabled = true;
+        } else if (strcmp(argv[0], "off") == 0) {
+            profile.enabled = false;
+        } else if (strcmp(argv[0], "reset") == 0) {
+            profile.reset_requested = true;
+        } else {
+            chprintf(chp, usage);
+            return;
+        }
+        chprintf(chp, "ok\r\n");
+        return;
+    } else if (argc > 1) {
+        chprintf(chp, usage);
+        return;
+    }
+
+    cycle_profile::Profile copy{};
+    if (!cycle_profile::snapshot(profile, copy)) {
+        chprintf(chp, "error: profile busy\r\n");
+        return;
+    }
+    if (!copy.enabled) {
+        chprintf(chp, "profiler is off, start it with 'm4profile on'\r\n");
+        return;
+    }
+
+    std::string info = "budget: " + to_string_dec_uint(copy.budget_cycles) + " cycles/buffer\r\n" +
+                       "scope       count      min      avg      max  histogram (1/8 budget, over)\r\n";
+    for (size_t i = 0; i < cycle_profile::scope_count; i++) {
+        const auto& stats = copy.scopes[i];
+        if (stats.count == 0) {
+            continue;
+        }
+
+        info += cycle_profile::scope_names[i];
+        info += std::string(10 - strlen(cycle_profile::scope_names[i]), ' ');
+        info += to_string_dec_uint(stats.count, 7) + " " +
+                to_string_dec_uint(stats.min, 8) + " " +
+                to_string_dec_uint(stats.average(), 8) + " " +
+                to_string_dec_uint(stats.max, 8) + " ";
+        for (const auto bin : stats.histogram) {
+            info += " " + to_string_dec_uint(bin);
+        }
+        info += "\r\n";
+    }
+
+    fillOBuffer(&((SerialUSBDriver*)chp)->oqueue, (const uint8_t*)info.c_str(), info.length());
+}
+
 static void cmd_radioinfo(BaseSequentialStream* chp, int argc, char* argv[]) {
     const char* usage = "usage: radioinfo\r\n";
     (void)argv;
@@ -1165,6 +1224,16 @@ static void cmd_setfreq(BaseSequentialStream* chp, int argc, char* argv[]) {
     chprintf(chp, "ok\r\n");
 }
 
+// switches to serial_frame framing until the host sends Exit, see usb_serial_frame.hpp.
+static void cmd_binmode(BaseSequentialStream* chp, int argc, char* argv[]) {
+    (void)argc;
+    (void)argv;
+
+    chprintf(chp, "ok\r\n");
+    usb_serial_binary_mode(chp, getEventDispatcherInstance());
+    chprintf(chp, "ok\r\n");
+}
+
 static const ShellCommand commands[] = {
     {"reboot", cmd_reboot},
     {"dfu", cmd_dfu},
@@ -1192,12 +1261,14 @@ static const ShellCommand commands[] = {
     {"gotorientation", cmd_gotorientation},
     {"gotenv", cmd_gotenv},
     {"sysinfo", cmd_sysinfo},
+    {"m4profile", cmd_m4profile},
     {"radioinfo", cmd_radioinfo},
     {"pmemreset", cmd_pmemreset},
     {"settingsreset", cmd_settingsreset},
     {"sendpocsag", cmd_sendpocsag},
     {"asyncmsg", cmd_asyncmsg},
     {"setfreq", cmd_setfreq},
+    {"binmode", cmd_binmode},
     {NULL, NULL}};
 
 static const ShellConfig shell_cfg1 = {
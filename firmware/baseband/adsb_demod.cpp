@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "adsb_demod.hpp"
+
+#include <hal.h>
+
+#include "simd_portable.hpp"
+
+namespace adsb {
+
+void Demodulator::reset() {
+    for (auto& m : history)
+        m = 0;
+    head = 0;
+    rises = 0;
+    falls = 0;
+    prev_mag = 0;
+
+    frame.clear();
+    decoding = false;
+    bit_count = 0;
+    sample_count = 0;
+}
+
+void Demodulator::execute(const buffer_c8_t& buffer) {
+    // Two C8 samples per word, laid out as re0 im0 re1 im1 (buffer.count is even).
+    const auto words = reinterpret_cast<const uint32_t*>(buffer.p);
+
+    for (size_t i = 0; i < buffer.count / 2; i++) {
+        const uint32_t w = words[i];
+        const uint32_t re = __SXTB16(w, 0);  // re1:re0
+        const uint32_t im = __SXTB16(w, 8);  // im1:im0
+
+        // Regroup as im:re per sample, then a dual multiply-add squares both halves.
+        const uint32_t s0 = __PKHBT(re, im, 16);
+        const uint32_t s1 = __PKHTB(im, re, 16);
+
+        process(__SMUAD(s0, s0));
+        process(__SMUAD(s1, s1));
+    }
+}
+
+inline void Demodulator::process(const uint32_t mag) {
+    // 1 bit == 2 samples, the transition defines the bit value.
+    // i.e. hi->lo == 1, lo->hi == 0
+    if (decoding) {
+        if ((sample_count & 1) == 1) {
+            byte = (byte << 1) | ((prev_mag > mag) ? 1 : 0);
+            bit_count++;
+
+            if ((bit_count & 0x7) == 0) {
+                frame.push_byte(byte);
+
+                if (bit_count == 8) {
+                    // Only keep DF11 all-call replies and DF17/18 extended squitters.
+                    const uint8_t df = byte >> 3;
+                    if (df == 11 || df == 17 || df == 18) {
+                        frame_bits = ADSBFrame::length_for_DF(df) * 8;
+                    } else {
+                        decoding = false;
+                        frame.clear();
+                    }
+                } else if (bit_count == frame_bits) {
+                    end_frame();
+                }
+            }
+        }
+
+        sample_count++;
+    }
+
+    // Continue looking for a preamble, even while in a frame.
+    head = (head + 1) & history_mask;
+    history[head] = mag;
+    rises = (rises << 1) | ((mag > prev_mag) ? 1 : 0);
+    falls = (falls << 1) | ((mag < prev_mag) ? 1 : 0);
+
+    if (((rises & rise_mask) == rise_mask) && ((falls & fall_mask) == fall_mask))
+        check_preamble();
+
+    prev_mag = mag;
+}
+
+void Demodulator::check_preamble() {
+    // The edges match, the space after the first pulse pair must also
+    // stay below the first pulse.
+    const uint32_t m1 = window(1);
+    if (window(4) >= m1 || window(5) >= m1 || window(6) >= m1 || window(7) >= m1)
+        return;
+
+    // The samples between the two spikes must be < than the average
+    // of the high spikes level. We don't test bits too near to
+    // the high levels as signals can be out of phase so part of the
+    // energy can be in the near samples.
+    const uint32_t this_amp = m1 + window(3) + window(8) + window(10);
+    const uint32_t high = this_amp / 9;  // TBD: Why 9?
+    if (window(5) >= high || window(6) >= high ||
+        // Similarly samples in the range 11-13 must be low, as it is the
+        // space between the preamble and real data. Again we don't test
+        // bits too near to high levels, see above.
+        window(12) >= high || window(13) >= high || window(14) >= high)
+        return;
+
+    // New preamble, or higher power than the frame being decoded.
+    if (!decoding || this_amp > amp) {
+        decoding = true;
+        amp = this_amp;
+        sample_count = 0;
+        bit_count = 0;
+        frame_bits = 0;
+        frame.clear();
+        stats.preambles++;
+    }
+}
+
+void Demodulator::end_frame() {
+    decoding = false;
+    stats.frames++;
+
+    if (frame.check_CRC())
+        stats.frames_valid++;
+    else if (frame.correct_errors())
+        stats.frames_corrected++;
+
+    // Bad frames are passed on as well, the application counts them.
+    frame_handler(frame, amp);
+}
+
+} /* namespace adsb */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __ADSB_DEMOD_H__
+#define __ADSB_DEMOD_H__
+
+#include "dsp_types.hpp"
+#include "adsb_frame.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+namespace adsb {
+
+/* Mode S PPM demodulator for 2 Msps C8 baseband, i.e. two samples per bit.
+ *
+ * Magnitudes go into a small circular buffer instead of a shift register,
+ * and each sample also updates two bit masks recording whether it rose or
+ * fell with respect to its predecessor. The pulse/gap shape of the preamble
+ * is then a single masked compare against those words, so the remaining
+ * level checks only run on the rare samples where the edges line up. */
+class Demodulator {
+   public:
+    using FrameHandlerFunc = std::function<void(const ADSBFrame& frame, const uint32_t amp)>;
+
+    struct Statistics {
+        size_t preambles{0};         // preambles that started a frame
+        size_t frames{0};            // frames handed over, good or bad
+        size_t frames_valid{0};      // frames with a good CRC as received
+        size_t frames_corrected{0};  // frames repaired from the CRC syndrome
+    };
+
+    Demodulator(FrameHandlerFunc frame_handler)
+        : frame_handler{std::move(frame_handler)} {
+    }
+
+    void reset();
+    void execute(const buffer_c8_t& buffer);
+
+    const Statistics& statistics() const { return stats; }
+
+   private:
+    static constexpr size_t preamble_length = 16;  // 8us
+    static constexpr size_t history_length = 32;   // power of two, > preamble_length
+    static constexpr size_t history_mask = history_length - 1;
+
+    /* Edge masks, bit n set for the sample n samples before the newest.
+     * Preamble    0123456789ABCDEF(G)
+     *             _-_-____-_-_____
+     * needs rises into 1, 3, A and falls into 2, 4, 9, B. */
+    static constexpr uint32_t rise_mask = (1 << (preamble_length - 1)) | (1 << (preamble_length - 3)) | (1 << (preamble_length - 10));
+    static constexpr uint32_t fall_mask = (1 << (preamble_length - 2)) | (1 << (preamble_length - 4)) | (1 << (preamble_length - 9)) | (1 << (preamble_length - 11));
+
+    FrameHandlerFunc frame_handler;
+
+    uint16_t history[history_length]{};
+    size_t head{0};
+    uint32_t rises{0};
+    uint32_t falls{0};
+    uint32_t prev_mag{0};
+
+    ADSBFrame frame{};
+    bool decoding{false};
+    uint32_t amp{0};
+    size_t frame_bits{0};
+    size_t bit_count{0};
+    size_t sample_count{0};
+    uint8_t byte{0};
+
+    Statistics stats{};
+
+    void process(const uint32_t mag);
+    void check_preamble();
+    void end_frame();
+
+    /* Magnitude k samples into the 17 sample preamble window, 16 being the newest. */
+    uint32_t window(const size_t k) const {
+        return history[(head + k - preamble_length) & history_mask];
+    }
+};
+
+} /* namespace adsb */
+
+#endif /*__ADSB_DEMOD_H__*/
@@ -26,6 +26,7 @@
 #include "portapack_shared_memory.hpp"
 
 #include "audio_dma.hpp"
+#include "cycle_profiler.hpp"
 
 #include "message.hpp"
 
@@ -44,12 +45,14 @@ void AudioOutput::configure(const iir_biquad_config_t& hpf_config, const iir_biq
 }
 
 void AudioOutput::write_unprocessed(const buffer_s16_t& audio) {
+    cycle_profile::Stopwatch stopwatch{};
     block_buffer_s16.feed(
         audio,
         [this](const buffer_s16_t& buffer) {
             audio_present = true;
             fill_audio_buffer(buffer, audio_present);
         });
+    stopwatch.lap(cycle_profile::Scope::Audio);
 }
 
 void AudioOutput::write(const buffer_s16_t& audio) {
@@ -61,11 +64,13 @@ void AudioOutput::write(const buffer_s16_t& audio) {
 }
 
 void AudioOutput::write(const buffer_f32_t& audio) {
+    cycle_profile::Stopwatch stopwatch{};
     block_buffer.feed(
         audio,
         [this](const buffer_f32_t& buffer) {
             this->on_block(buffer);
         });
+    stopwatch.lap(cycle_profile::Scope::Audio);
 }
 
 void AudioOutput::on_block(const buffer_f32_t& audio) {
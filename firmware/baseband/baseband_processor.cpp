@@ -25,7 +25,22 @@
 
 #include "message.hpp"
 
+template <typename Collector>
+static void follow_retune(Collector& collector, const buffer_c16_t& channel) {
+    const uint32_t epoch = shared_memory.retune_epoch;
+    if (epoch != collector.epoch()) {
+        // This buffer may still hold samples from before the retune.
+        const uint64_t rate = channel.sampling_rate;
+        collector.restart(
+            epoch,
+            channel.count + rate * shared_memory.retune_settle_us / 1000000,
+            rate * shared_memory.retune_window_us / 1000000);
+    }
+}
+
 void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
+    follow_retune(channel_stats, channel);
+
     channel_stats.feed(
         channel,
         [](const ChannelStatistics& statistics) {
@@ -33,3 +48,21 @@ void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
             shared_memory.application_queue.push(channel_stats_message);
         });
 }
+
+void BasebandProcessor::feed_channel_bank(ChannelBankCollector& bank, const buffer_c16_t& channel) {
+    if (shared_memory.retune_epoch != bank.epoch()) {
+        bank.configure(
+            const_cast<const int32_t*>(shared_memory.retune_channel_offsets),
+            shared_memory.retune_channel_count,
+            shared_memory.retune_channel_spacing,
+            channel.sampling_rate);
+    }
+    follow_retune(bank, channel);
+
+    bank.feed(
+        channel,
+        [](const MultiChannelStatistics& statistics) {
+            const MultiChannelStatisticsMessage message{statistics};
+            shared_memory.application_queue.push(message);
+        });
+}
@@ -24,6 +24,7 @@
 
 #include "dsp_types.hpp"
 
+#include "channel_bank_collector.hpp"
 #include "channel_stats_collector.hpp"
 
 #include "message.hpp"
@@ -38,6 +39,7 @@ class BasebandProcessor {
 
    protected:
     void feed_channel_stats(const buffer_c16_t& channel);
+    void feed_channel_bank(ChannelBankCollector& bank, const buffer_c16_t& channel);
 
    private:
     ChannelStatsCollector channel_stats{};
@@ -32,6 +32,7 @@
 using namespace lpc43xx;
 
 #include "portapack_shared_memory.hpp"
+#include "cycle_profiler.hpp"
 
 #include "utility.hpp"
 
@@ -88,6 +89,8 @@ void BasebandThread::run() {
     baseband::dma::enable(direction());
     baseband_sgpio.streaming_enable();
 
+    cycle_profile::start();
+
     while (!chThdShouldTerminate()) {
         // TODO: Place correct sampling rate into buffer returned here:
         const auto buffer_tmp = baseband::dma::wait_for_buffer();
@@ -110,7 +113,10 @@ void BasebandThread::run() {
             }
 
             if (baseband_processor_) {
+                cycle_profile::begin_buffer(buffer.count, sampling_rate_);
+                cycle_profile::Stopwatch stopwatch{};
                 baseband_processor_->execute(buffer);
+                stopwatch.lap(cycle_profile::Scope::Buffer);
             }
         }
     }
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "btle_phy.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace btle {
+
+void Dewhitener::configure(const uint8_t channel) {
+    // The channel index sits bit reversed in the top six bits, above a 1.
+    uint8_t lfsr = 0x02;
+    for (size_t i = 0; i < 6; i++) {
+        if (channel & (1 << i))
+            lfsr |= 0x80 >> i;
+    }
+
+    for (auto& byte : sequence_) {
+        byte = 0;
+        for (uint8_t mask = 1; mask; mask <<= 1) {
+            if (lfsr & 0x80) {
+                lfsr ^= 0x11;
+                byte |= mask;
+            }
+            lfsr <<= 1;
+        }
+    }
+}
+
+void Dewhitener::apply(uint8_t* const data, const size_t offset, const size_t length) const {
+    if (offset >= max_length)
+        return;
+
+    const size_t end = std::min(length, max_length - offset);
+    const uint8_t* const whitening = &sequence_[offset];
+    size_t i = 0;
+    for (; i + 4 <= end; i += 4) {
+        uint32_t word, mask;
+        memcpy(&word, &data[i], sizeof(word));
+        memcpy(&mask, &whitening[i], sizeof(mask));
+        word ^= mask;
+        memcpy(&data[i], &word, sizeof(word));
+    }
+    for (; i < end; i++)
+        data[i] ^= whitening[i];
+}
+
+namespace {
+
+constexpr uint32_t crc24_polynomial_reflected = 0xDA6000;
+
+struct Crc24Tables {
+    uint32_t t[4][256];
+};
+
+constexpr Crc24Tables make_crc24_tables() {
+    Crc24Tables tables{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (size_t bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ crc24_polynomial_reflected : crc >> 1;
+        tables.t[0][i] = crc;
+    }
+    // t[n][i]: byte i followed by n zero bytes.
+    for (size_t n = 1; n < 4; n++) {
+        for (uint32_t i = 0; i < 256; i++) {
+            const uint32_t previous = tables.t[n - 1][i];
+            tables.t[n][i] = tables.t[0][previous & 0xFF] ^ (previous >> 8);
+        }
+    }
+    return tables;
+}
+
+constexpr Crc24Tables crc24_tables = make_crc24_tables();
+
+} /* namespace */
+
+uint32_t crc24(const uint8_t* const data, const size_t length, const uint32_t init) {
+    const auto& t = crc24_tables.t;
+    uint32_t crc = init & 0xFFFFFF;
+    size_t i = 0;
+
+    for (; i + 4 <= length; i += 4) {
+        uint32_t word;  // Little endian, the first byte meets the low bits
+        memcpy(&word, &data[i], sizeof(word));
+        crc ^= word;
+        crc = t[3][crc & 0xFF] ^ t[2][(crc >> 8) & 0xFF] ^ t[1][(crc >> 16) & 0xFF] ^ t[0][crc >> 24];
+    }
+    for (; i < length; i++)
+        crc = t[0][(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return crc & 0xFFFFFF;
+}
+
+} /* namespace btle */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __BTLE_PHY_H__
+#define __BTLE_PHY_H__
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace btle {
+
+constexpr uint32_t advertising_access_address = 0x8E89BED6;
+
+/* Finds the access address in the demodulated bit stream. Bits arrive LSB
+ * first and shift into the top of a 32 bit register, which holds the
+ * address as a plain number once it is all in. A match is a Hamming
+ * distance of at most max_errors, one popcount per bit instead of a 32
+ * step compare. */
+class AccessAddressCorrelator {
+   public:
+    constexpr AccessAddressCorrelator(
+        const uint32_t access_address = advertising_access_address,
+        const uint32_t max_errors = 1)
+        : access_address{access_address},
+          max_errors{max_errors} {
+    }
+
+    void reset() {
+        bits = 0;
+        count = 0;
+    }
+
+    /* True when the 32 bits up to and including bit match. */
+    bool feed(const uint32_t bit) {
+        bits = (bits >> 1) | (bit << 31);
+        if (count < 32) {
+            if (++count < 32)
+                return false;
+        }
+        return static_cast<uint32_t>(__builtin_popcount(bits ^ access_address)) <= max_errors;
+    }
+
+    /* Bits that differ from the access address, for the last match. */
+    uint32_t errors() const { return __builtin_popcount(bits ^ access_address); }
+
+   private:
+    uint32_t access_address;
+    uint32_t max_errors;
+    uint32_t bits{0};
+    uint32_t count{0};
+};
+
+/* Data whitening, x^7 + x^4 + 1 seeded from the channel index. The
+ * sequence only depends on the channel, so it is worked out once per
+ * channel and XORed over the PDU four bytes at a time. */
+class Dewhitener {
+   public:
+    /* Longest advertising PDU: 2 header bytes, 37 payload bytes, 3 CRC bytes. */
+    static constexpr size_t max_length = 42;
+
+    void configure(const uint8_t channel);
+
+    /* XORs length bytes of data with the sequence from offset into the PDU on. */
+    void apply(uint8_t* const data, const size_t offset, const size_t length) const;
+
+    const uint8_t* sequence() const { return sequence_.data(); }
+
+   private:
+    std::array<uint8_t, (max_length + 3) & ~3> sequence_{};
+};
+
+/* The link layer CRC-24, x^24 + x^10 + x^9 + x^6 + x^4 + x^3 + x + 1, over
+ * bytes as received (LSB first). init is the CRC init bit reversed, which
+ * also makes the result compare straight against the received CRC bytes
+ * read little endian. Slicing by 4: one table lookup per byte but four
+ * bytes per step. */
+uint32_t crc24(const uint8_t* const data, const size_t length, const uint32_t init);
+
+} /* namespace btle */
+
+#endif /*__BTLE_PHY_H__*/
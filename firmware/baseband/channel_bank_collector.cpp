@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "channel_bank_collector.hpp"
+
+#include "utility.hpp"
+
+#include <hal.h>
+#include "simd_portable.hpp"
+
+#include <cmath>
+#include <complex>
+
+void ChannelBankCollector::configure(
+    const int32_t* const offsets,
+    const size_t count,
+    const uint32_t channel_spacing,
+    const uint32_t sampling_rate) {
+    constexpr float pi = 3.14159265358979f;
+
+    channel_count = std::min(count, max_channels);
+
+    const uint32_t spacing = std::max<uint32_t>(channel_spacing, 1);
+    length = std::clamp<size_t>((sampling_rate + spacing / 2) / spacing, min_block_length, max_block_length);
+
+    // Runs in the baseband thread on a retune, so rotate instead of calling sin/cos per tap.
+    for (size_t c = 0; c < channel_count; c++) {
+        const float w = -2.0f * pi * offsets[c] / sampling_rate;
+        const std::complex<float> step{std::cos(w), std::sin(w)};
+        std::complex<float> phasor{1.0f, 0.0f};
+        for (size_t n = 0; n < length; n++) {
+            const int32_t re = std::lround(phasor.real() * 32767.0f);
+            const int32_t im = std::lround(phasor.imag() * 32767.0f);
+            phasors[c][n] = (static_cast<uint32_t>(re) & 0xffff) | (static_cast<uint32_t>(im) << 16);
+            phasor *= step;
+        }
+    }
+}
+
+void ChannelBankCollector::restart(const uint32_t new_epoch, const size_t skip_samples, const size_t window_samples) {
+    epoch_ = new_epoch;
+    skip = skip_samples;
+    window = window_samples;
+    accum_re.fill(0);
+    accum_im.fill(0);
+    max_mag_sq.fill(0);
+    position = 0;
+    blocks = 0;
+    count = 0;
+}
+
+void ChannelBankCollector::accumulate(const complex16_t* p, size_t n) {
+    const uint32_t* src = reinterpret_cast<const uint32_t*>(p);
+
+    while (n) {
+        // Blocks straddle buffers, run all channels over what's left of this one.
+        const size_t run = std::min(n, length - position);
+
+        for (size_t c = 0; c < channel_count; c++) {
+            const uint32_t* w = &phasors[c][position];
+            int64_t re = accum_re[c];
+            int64_t im = accum_im[c];
+            for (size_t i = 0; i < run; i++) {
+                re = __SMLSLD(src[i], w[i], re);
+                im = __SMLALDX(src[i], w[i], im);
+            }
+            accum_re[c] = re;
+            accum_im[c] = im;
+        }
+
+        src += run;
+        n -= run;
+        position += run;
+        if (position == length) {
+            end_block();
+        }
+    }
+}
+
+void ChannelBankCollector::end_block() {
+    for (size_t c = 0; c < channel_count; c++) {
+        const float re = accum_re[c];
+        const float im = accum_im[c];
+        max_mag_sq[c] = std::max(max_mag_sq[c], re * re + im * im);
+    }
+    accum_re.fill(0);
+    accum_im.fill(0);
+    position = 0;
+    blocks++;
+}
+
+MultiChannelStatistics ChannelBankCollector::statistics() const {
+    // A full scale tone in the middle of a channel reads 0dB.
+    const float full_scale = 32768.0f * 32767.0f * length;
+    const float k = 1.0f / (full_scale * full_scale);
+
+    MultiChannelStatistics result{};
+    for (size_t c = 0; c < channel_count; c++) {
+        result.max_db[c] = mag2_to_dbv_norm(std::max(max_mag_sq[c] * k, 1e-12f));
+    }
+    result.channel_count = channel_count;
+    result.count = count;
+    result.epoch = epoch_;
+    return result;
+}
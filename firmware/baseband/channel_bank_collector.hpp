@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __CHANNEL_BANK_COLLECTOR_H__
+#define __CHANNEL_BANK_COLLECTOR_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/* Measures the level of several channels in one capture. Each channel is
+ * mixed to DC with a phasor table and integrated over blocks of
+ * fs / channel_spacing samples, i.e. one DFT bin per channel whose nulls
+ * fall on the neighbouring channels. Reports the strongest block of each
+ * channel per window, on the same scale as ChannelStatsCollector.
+ */
+class ChannelBankCollector {
+   public:
+    static constexpr size_t max_channels = MultiChannelStatistics::max_channels;
+    static constexpr size_t min_block_length = 8;
+    static constexpr size_t max_block_length = 64;
+
+    /* Takes effect with the next restart(). */
+    void configure(
+        const int32_t* const offsets,
+        const size_t count,
+        const uint32_t channel_spacing,
+        const uint32_t sampling_rate);
+
+    bool enabled() const { return channel_count != 0; }
+    size_t block_length() const { return length; }
+
+    template <typename Callback>
+    void feed(const buffer_c16_t& src, Callback callback) {
+        if (!enabled()) return;
+
+        const size_t skipped = std::min(skip, src.count);
+        skip -= skipped;
+
+        accumulate(&src.p[skipped], src.count - skipped);
+        count += src.count - skipped;
+
+        const size_t samples_per_update = window ? window : src.sampling_rate * update_interval;
+
+        if (blocks && count >= samples_per_update) {
+            callback(statistics());
+
+            max_mag_sq.fill(0);
+            blocks = 0;
+            count = 0;
+            window = 0;
+        }
+    }
+
+    /* See ChannelStatsCollector::restart(). */
+    void restart(const uint32_t new_epoch, const size_t skip_samples, const size_t window_samples);
+
+    uint32_t epoch() const { return epoch_; }
+
+   private:
+    static constexpr float update_interval{0.1f};
+
+    void accumulate(const complex16_t* p, size_t n);
+    void end_block();
+    MultiChannelStatistics statistics() const;
+
+    /* Q15 e^-jwn, real part in the low half like complex16_t. */
+    std::array<std::array<uint32_t, max_block_length>, max_channels> phasors{};
+    std::array<int64_t, max_channels> accum_re{};
+    std::array<int64_t, max_channels> accum_im{};
+    std::array<float, max_channels> max_mag_sq{};
+    size_t channel_count{0};
+    size_t length{max_block_length};
+    size_t position{0};
+    size_t blocks{0};
+    size_t count{0};
+    size_t skip{0};
+    size_t window{0};
+    uint32_t epoch_{0};
+};
+
+#endif /*__CHANNEL_BANK_COLLECTOR_H__*/
@@ -26,6 +26,7 @@
 #include "message.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 
@@ -35,7 +36,10 @@ class ChannelStatsCollector {
    public:
     template <typename Callback>
     void feed(const buffer_c16_t& src, Callback callback) {
-        void* src_p = src.p;
+        const size_t skipped = std::min(skip, src.count);
+        skip -= skipped;
+
+        void* src_p = &src.p[skipped];
         while (src_p < &src.p[src.count]) {
             const uint32_t sample = *__SIMD32(src_p)++;
             const uint32_t mag_sq = __SMUAD(sample, sample);
@@ -43,24 +47,41 @@ class ChannelStatsCollector {
                 max_squared = mag_sq;
             }
         }
-        count += src.count;
+        count += src.count - skipped;
 
-        const size_t samples_per_update = src.sampling_rate * update_interval;
+        const size_t samples_per_update = window ? window : src.sampling_rate * update_interval;
 
-        if (count >= samples_per_update) {
+        if (count && count >= samples_per_update) {
             const float max_squared_f = max_squared;
             const int32_t max_db = mag2_to_dbv_norm(max_squared_f * (1.0f / (32768.0f * 32768.0f)));
-            callback({max_db, count});
+            callback({max_db, count, epoch_});
 
             max_squared = 0;
             count = 0;
+            window = 0;
         }
     }
 
+    /* Drops the current window and starts over after skip_samples.
+     * When window_samples isn't 0, the first report covers that many
+     * samples instead of the usual interval. */
+    void restart(const uint32_t new_epoch, const size_t skip_samples, const size_t window_samples) {
+        epoch_ = new_epoch;
+        skip = skip_samples;
+        window = window_samples;
+        max_squared = 0;
+        count = 0;
+    }
+
+    uint32_t epoch() const { return epoch_; }
+
    private:
     static constexpr float update_interval{0.1f};
     uint32_t max_squared{0};
     size_t count{0};
+    size_t skip{0};
+    size_t window{0};
+    uint32_t epoch_{0};
 };
 
 #endif /*__CHANNEL_STATS_COLLECTOR_H__*/
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "cycle_profiler.hpp"
+
+#include "hackrf_hal.hpp"
+
+#include <algorithm>
+
+namespace cycle_profile {
+
+static void clear(Profile& profile) {
+    for (auto& stats : profile.scopes) {
+        stats = {};
+        stats.min = UINT32_MAX;
+    }
+}
+
+void start() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    auto& profile = shared_memory.m4_profile;
+    chSysLock();
+    profile.sequence++;
+    __DMB();
+    clear(profile);
+    profile.budget_cycles = 0;
+    __DMB();
+    profile.sequence++;
+    chSysUnlock();
+}
+
+void begin_buffer(const size_t sample_count, const uint32_t sampling_rate) {
+    auto& profile = shared_memory.m4_profile;
+    if (!profile.enabled || (sampling_rate == 0)) {
+        return;
+    }
+
+    const uint32_t budget = static_cast<uint64_t>(sample_count) * hackrf::one::base_m4_clk_f / sampling_rate;
+    if (profile.reset_requested || (budget != profile.budget_cycles)) {
+        chSysLock();
+        profile.sequence++;
+        __DMB();
+        clear(profile);
+        profile.budget_cycles = budget;
+        profile.reset_requested = false;
+        __DMB();
+        profile.sequence++;
+        chSysUnlock();
+    }
+}
+
+void record(const Scope scope, const uint32_t cycles) {
+    auto& profile = shared_memory.m4_profile;
+    if (profile.budget_cycles == 0) {
+        return;
+    }
+
+    const size_t bin = (cycles < profile.budget_cycles)
+                           ? (cycles * budget_bins / profile.budget_cycles)
+                           : budget_bins;
+
+    /* Stages on the event dispatcher thread can preempt the baseband thread. */
+    chSysLock();
+    profile.sequence++;
+    __DMB();
+    auto& stats = profile.scopes[static_cast<size_t>(scope)];
+    stats.count++;
+    stats.total += cycles;
+    stats.min = std::min(stats.min, cycles);
+    stats.max = std::max(stats.max, cycles);
+    stats.histogram[bin]++;
+    __DMB();
+    profile.sequence++;
+    chSysUnlock();
+}
+
+} /* namespace cycle_profile */
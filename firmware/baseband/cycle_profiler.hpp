@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __CYCLE_PROFILER_H__
+#define __CYCLE_PROFILER_H__
+
+#include "cycle_profile.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include <ch.h>
+
+namespace cycle_profile {
+
+/* Starts the cycle counter and clears the profile for a new processor. */
+void start();
+
+/* Called per baseband buffer, before the processor runs. */
+void begin_buffer(const size_t sample_count, const uint32_t sampling_rate);
+
+void record(const Scope scope, const uint32_t cycles);
+
+inline uint32_t cycles_now() {
+    return DWT->CYCCNT;
+}
+
+/* Measures consecutive stages of a function: each lap() records the cycles
+ * since the previous lap (or construction) against a scope. Costs a
+ * counter read while the profiler is disabled.
+ */
+class Stopwatch {
+   public:
+    Stopwatch()
+        : last{cycles_now()} {
+    }
+
+    void lap(const Scope scope) {
+        const uint32_t now = cycles_now();
+        if (shared_memory.m4_profile.enabled) {
+            record(scope, now - last);
+        }
+        last = now;
+    }
+
+   private:
+    uint32_t last;
+};
+
+} /* namespace cycle_profile */
+
+#endif /*__CYCLE_PROFILER_H__*/
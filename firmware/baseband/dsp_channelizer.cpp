@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dsp_channelizer.hpp"
+#include "dsp_fft_radix4.hpp"
+
+#include <hal.h>
+#include "simd_portable.hpp"
+
+#include <cmath>
+
+namespace dsp {
+namespace channelize {
+
+PolyphaseChannelizer::PolyphaseChannelizer() {
+    constexpr float pi = 3.14159265358979f;
+    constexpr float half_span = taps_count / 2.0f;
+
+    // Windowed sinc cut off at the channel edges, fs / (2 * channels_count).
+    std::array<float, taps_count> h{};
+    float sum = 0.0f;
+    for (size_t k = 0; k < taps_count; k++) {
+        const float t = (static_cast<float>(k) - half_span + 0.5f) / channels_count;
+        const float sinc = (std::fabs(t) < 1e-6f) ? 1.0f : std::sin(pi * t) / (pi * t);
+
+        // Blackman window over the filter span.
+        const float w = (k + 0.5f) / taps_count;
+        const float window = 0.42f - 0.5f * std::cos(2.0f * pi * w) + 0.08f * std::cos(4.0f * pi * w);
+
+        h[k] = sinc * window;
+        sum += h[k];
+    }
+
+    // DC gain of channels_count, the Q15 FFT scales by 1 / channels_count.
+    for (size_t k = 0; k < taps_count; k++) {
+        taps[k] = static_cast<int16_t>(std::lround(h[k] / sum * channels_count * 32767.0f));
+    }
+}
+
+void PolyphaseChannelizer::reset() {
+    history.fill({0, 0});
+    history_pos = 0;
+    fill = 0;
+}
+
+size_t PolyphaseChannelizer::channel_for(const int32_t offset, const uint32_t sampling_rate) {
+    const int64_t scaled = static_cast<int64_t>(offset) * channels_count;
+    const int32_t half = sampling_rate / 2;
+    const int32_t c = (scaled + (scaled < 0 ? -half : half)) / static_cast<int64_t>(sampling_rate);
+    return static_cast<size_t>(c) & (channels_count - 1);
+}
+
+void PolyphaseChannelizer::frame() {
+    // history[history_pos] is the oldest sample, weighted by taps[0].
+    const complex16_t* const window = &history[history_pos];
+
+    for (size_t k = 0; k < channels_count; k++) {
+        int32_t re = 0;
+        int32_t im = 0;
+        for (size_t p = 0; p < taps_per_channel; p++) {
+            const int32_t t = taps[k + p * channels_count];
+            const auto s = window[k + p * channels_count];
+            re += t * s.real();
+            im += t * s.imag();
+        }
+        channels[k] = {
+            static_cast<int16_t>(__SSAT(re >> 15, 16)),
+            static_cast<int16_t>(__SSAT(im >> 15, 16))};
+    }
+
+    dsp::fft::forward(channels.data(), channels_count);
+}
+
+} /* namespace channelize */
+} /* namespace dsp */
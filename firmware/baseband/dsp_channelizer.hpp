@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __DSP_CHANNELIZER_H__
+#define __DSP_CHANNELIZER_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "dsp_types.hpp"
+
+namespace dsp {
+namespace channelize {
+
+/* Critically sampled polyphase filter bank. Splits the input into
+ * channels_count channels of fs / channels_count each, decimated by
+ * channels_count. Every channels_count input samples, the last taps_count
+ * samples are weighted by the prototype low-pass, folded into
+ * channels_count points and transformed with the radix-4 FFT.
+ *
+ * Channel c is centered on c * fs / channels_count, with c >= channels_count / 2
+ * being the negative frequencies like FFT bins. A tone in the middle of a
+ * channel comes out at its input amplitude, neighbouring channels cross at
+ * -6dB.
+ */
+class PolyphaseChannelizer {
+   public:
+    static constexpr size_t channels_count = 64;
+    static constexpr size_t taps_per_channel = 8;
+    static constexpr size_t taps_count = channels_count * taps_per_channel;
+
+    PolyphaseChannelizer();
+
+    void reset();
+
+    /* Calls fn(const complex16_t* channels) for each output frame. */
+    template <typename Fn>
+    void execute(const buffer_c16_t& src, Fn fn) {
+        for (size_t i = 0; i < src.count; i++) {
+            history[history_pos] = src.p[i];
+            history[history_pos + taps_count] = src.p[i];
+            if (++history_pos == taps_count) history_pos = 0;
+
+            if (++fill == channels_count) {
+                fill = 0;
+                frame();
+                fn(channels.data());
+            }
+        }
+    }
+
+    /* Channel index for a frequency offset, rounded to the closest channel. */
+    static size_t channel_for(const int32_t offset, const uint32_t sampling_rate);
+
+   private:
+    void frame();
+
+    std::array<int16_t, taps_count> taps{};
+
+    /* Last taps_count input samples, written twice so that the window
+     * starting at any position is contiguous. */
+    std::array<complex16_t, taps_count * 2> history{};
+    size_t history_pos{0};
+    size_t fill{0};
+
+    std::array<complex16_t, channels_count> channels{};
+};
+
+} /* namespace channelize */
+} /* namespace dsp */
+
+#endif /*__DSP_CHANNELIZER_H__*/
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dsp_resample.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dsp {
+namespace resample {
+
+/* Fraction of the input rate passed, keeps the transition band below the
+ * input Nyquist frequency so its images are attenuated. */
+constexpr float cutoff = 0.45f;
+
+PolyphaseInterpolator::PolyphaseInterpolator() {
+    constexpr float pi = 3.14159265358979f;
+    constexpr float half_span = taps_count / 2.0f;
+
+    /* Phase p interpolates at fraction p / phases_count between history taps
+     * taps_count / 2 - 1 and taps_count / 2. */
+    for (size_t p = 0; p < phases_count; p++) {
+        const float fraction = static_cast<float>(p) / phases_count;
+
+        std::array<float, taps_count> h{};
+        float sum = 0.0f;
+        for (size_t k = 0; k < taps_count; k++) {
+            const float t = static_cast<float>(k) - (half_span - 1.0f) - fraction;
+            const float x = 2.0f * cutoff * t;
+            const float sinc = (std::fabs(x) < 1e-6f) ? 1.0f : std::sin(pi * x) / (pi * x);
+
+            // Blackman window over the filter span.
+            const float w = (t + half_span) / (2.0f * half_span);
+            const float window = 0.42f - 0.5f * std::cos(2.0f * pi * w) + 0.08f * std::cos(4.0f * pi * w);
+
+            h[k] = sinc * window;
+            sum += h[k];
+        }
+
+        // Unity gain at DC for every phase.
+        for (size_t k = 0; k < taps_count; k++) {
+            bank[p][k] = static_cast<int16_t>(std::lround(h[k] / sum * 32767.0f));
+        }
+    }
+}
+
+void PolyphaseInterpolator::configure(const uint32_t input_rate, const uint32_t output_rate) {
+    step = (output_rate > 0) ? ((static_cast<uint64_t>(input_rate) << 16) / output_rate) : one;
+    step = std::min(step, one * static_cast<uint32_t>(max_step));
+    reset();
+}
+
+void PolyphaseInterpolator::reset() {
+    history.fill(0);
+    history_pos = 0;
+    held = 0;
+    position = 0;
+}
+
+size_t PolyphaseInterpolator::input_needed(const size_t output_count) const {
+    return (position + static_cast<uint64_t>(output_count) * step) >> 16;
+}
+
+buffer_s16_t PolyphaseInterpolator::execute(
+    const buffer_s16_t& src,
+    const buffer_s16_t& dst) {
+    const int16_t* in = src.p;
+
+    for (size_t i = 0; i < dst.count; i++) {
+        const int16_t* const z = &history[history_pos];
+        const auto& h = bank[(position & (one - 1)) >> (16 - phases_log2)];
+
+        int32_t accum = 0;
+        for (size_t k = 0; k < taps_count; k++) {
+            accum += z[k] * h[k];
+        }
+        dst.p[i] = std::max<int32_t>(std::min<int32_t>((accum + (1 << 14)) >> 15, 32767), -32768);
+
+        position += step;
+        for (; position >= one; position -= one) {
+            const int16_t sample = *in++;
+            history[history_pos] = sample;
+            history[history_pos + taps_count] = sample;
+            history_pos = (history_pos + 1) & (taps_count - 1);
+        }
+    }
+
+    return {dst.p, dst.count, static_cast<uint32_t>((static_cast<uint64_t>(src.sampling_rate) << 16) / step)};
+}
+
+buffer_s16_t PolyphaseInterpolator::hold(
+    const buffer_s16_t& src,
+    const buffer_s16_t& dst) {
+    // The last input consumed is output until the position moves past the next one.
+    const int16_t* in = src.p;
+
+    for (size_t i = 0; i < dst.count; i++) {
+        dst.p[i] = held;
+
+        position += step;
+        const size_t consumed = position >> 16;
+        position &= one - 1;
+        if (consumed) {
+            in += consumed;
+            held = in[-1];
+        }
+    }
+
+    return {dst.p, dst.count, static_cast<uint32_t>((static_cast<uint64_t>(src.sampling_rate) << 16) / step)};
+}
+
+void PCMReader::decode(int16_t* const dst, const size_t count) const {
+    const uint8_t* const p = data.data();
+
+    if (channels == 1 && bytes_per_sample == 1) {
+        for (size_t n = 0; n < count; n++)
+            dst[n] = (p[n] - 0x80) * 256;
+    } else if (channels == 1 && bytes_per_sample == 2) {
+        for (size_t n = 0; n < count; n++)
+            dst[n] = static_cast<int16_t>(p[n * 2] | (p[n * 2 + 1] << 8));
+    } else {
+        const size_t frame_size = bytes_per_sample * channels;
+        for (size_t n = 0; n < count; n++) {
+            int32_t sum = 0;
+            for (size_t c = 0; c < channels; c++) {
+                const uint8_t* const s = &p[n * frame_size + c * bytes_per_sample];
+                if (bytes_per_sample == 1)
+                    sum += (s[0] - 0x80) * 256;
+                else
+                    sum += static_cast<int16_t>(s[bytes_per_sample - 2] | (s[bytes_per_sample - 1] << 8));
+            }
+            dst[n] = sum / static_cast<int32_t>(channels);
+        }
+    }
+}
+
+} /* namespace resample */
+} /* namespace dsp */
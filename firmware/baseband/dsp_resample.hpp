@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __DSP_RESAMPLE_H__
+#define __DSP_RESAMPLE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+
+#include "dsp_types.hpp"
+
+namespace dsp {
+namespace resample {
+
+/* Interpolates real audio to a higher, arbitrary rate with a polyphase
+ * windowed-sinc filter bank. The output position advances by a 16.16 step
+ * in input samples; the top bits of its fraction select the filter phase.
+ * The cutoff is relative to the input rate, so one bank serves any pair of
+ * rates as long as the output rate is the higher one.
+ *
+ * hold() follows the same position with a zero-order hold instead. It costs
+ * a fraction of execute() and is what AudioTX uses unless asked for the
+ * filter. Inputs up to max_step times the output rate are decimated by
+ * dropping samples.
+ */
+class PolyphaseInterpolator {
+   public:
+    static constexpr size_t taps_count = 8;
+    static constexpr size_t phases_log2 = 5;
+    static constexpr size_t phases_count = 1U << phases_log2;
+    static constexpr size_t max_step = 2;
+
+    PolyphaseInterpolator();
+
+    void configure(const uint32_t input_rate, const uint32_t output_rate);
+    void reset();
+
+    /* Input samples the next output_count outputs will consume, at most
+     * max_step * output_count. */
+    size_t input_needed(const size_t output_count) const;
+
+    /* src.count must be input_needed(dst.count). */
+    buffer_s16_t execute(
+        const buffer_s16_t& src,
+        const buffer_s16_t& dst);
+
+    buffer_s16_t hold(
+        const buffer_s16_t& src,
+        const buffer_s16_t& dst);
+
+   private:
+    static constexpr uint32_t one = 1U << 16;
+
+    std::array<std::array<int16_t, taps_count>, phases_count> bank{};
+
+    /* Last taps_count input samples, written twice so that the window
+     * starting at any position is contiguous. */
+    std::array<int16_t, taps_count * 2> history{};
+    size_t history_pos{0};
+
+    int16_t held{0};  // Output of hold()
+
+    uint32_t step{one};
+    uint32_t position{0};
+};
+
+/* Reads little endian PCM frames from a stream in blocks and converts them
+ * to mono int16: 8 bit unsigned, or 16 bit and up of which only the top 16
+ * bits are used. Channels are averaged. */
+class PCMReader {
+   public:
+    static constexpr size_t max_bytes_per_sample = 4;
+    static constexpr size_t max_channels = 2;
+
+    void configure(const size_t bytes_per_sample, const size_t channels) {
+        this->bytes_per_sample = std::min(std::max<size_t>(bytes_per_sample, 1), max_bytes_per_sample);
+        this->channels = std::min(std::max<size_t>(channels, 1), max_channels);
+    }
+
+    /* Fills dst with count frames, looping the read over the block. Frames
+     * past the end of the stream are silence. Returns the frames read. */
+    template <typename Stream>
+    size_t read(Stream& stream, int16_t* const dst, const size_t count) {
+        const size_t frame_size = bytes_per_sample * channels;
+        const size_t block_frames = data.size() / frame_size;
+
+        size_t frames_read = 0;
+        while (frames_read < count) {
+            const size_t wanted = std::min(count - frames_read, block_frames);
+            const size_t n = stream.read(data.data(), wanted * frame_size) / frame_size;
+            decode(&dst[frames_read], n);
+            frames_read += n;
+            if (n < wanted)
+                break;
+        }
+
+        std::fill(&dst[frames_read], &dst[count], 0);
+        return frames_read;
+    }
+
+   private:
+    std::array<uint8_t, 512> data{};
+    size_t bytes_per_sample{1};
+    size_t channels{1};
+
+    void decode(int16_t* const dst, const size_t count) const;
+};
+
+} /* namespace resample */
+} /* namespace dsp */
+
+#endif /*__DSP_RESAMPLE_H__*/
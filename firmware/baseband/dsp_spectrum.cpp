@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dsp_spectrum.hpp"
+#include "dsp_fft_radix4.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dsp {
+namespace spectrum {
+
+PowerAverager::PowerAverager() {
+    set_window(Window::Hann);
+}
+
+void PowerAverager::set_window(const Window window) {
+    constexpr float pi = 3.14159265358979f;
+
+    float sum_w = 0.0f;
+    for (size_t i = 0; i < window_half.size(); i++) {
+        const float x = 2.0f * pi * (i + 0.5f) / fft_size;
+        float w = 1.0f;
+        switch (window) {
+            case Window::Hann:
+                w = 0.5f - 0.5f * std::cos(x);
+                break;
+
+            case Window::BlackmanHarris:
+                w = 0.35875f - 0.48829f * std::cos(x) + 0.14128f * std::cos(2.0f * x) - 0.01168f * std::cos(3.0f * x);
+                break;
+
+            case Window::Rectangular:
+            default:
+                break;
+        }
+        window_half[i] = static_cast<int16_t>(std::lround(w * 32767.0f));
+        sum_w += 2.0f * window_half[i] / 32768.0f;
+    }
+
+    // The Q15 FFT scales by 1 / fft_size, a full scale tone on a bin comes
+    // out at 32768 times the window's coherent gain.
+    const float gain = 32768.0f * sum_w / fft_size;
+    scale = 1.0f / (gain * gain);
+}
+
+void PowerAverager::accumulate(const complex8_t* const src) {
+    // complex8 times Q15 is Q22, down to Q15 with full scale kept.
+    for (size_t i = 0; i < fft_size / 2; i++) {
+        const int32_t w = window_half[i];
+        const complex8_t a = src[i];
+        const complex8_t b = src[fft_size - 1 - i];
+        frame[i] = {
+            static_cast<int16_t>((a.real() * w) >> 7),
+            static_cast<int16_t>((a.imag() * w) >> 7)};
+        frame[fft_size - 1 - i] = {
+            static_cast<int16_t>((b.real() * w) >> 7),
+            static_cast<int16_t>((b.imag() * w) >> 7)};
+    }
+
+    dsp::fft::forward(frame);
+
+    for (size_t k = 0; k < fft_size; k++) {
+        const int32_t re = frame[k].real();
+        const int32_t im = frame[k].imag();
+        const uint32_t p = static_cast<uint32_t>(re * re) + static_cast<uint32_t>(im * im);
+        sum[k] += p;
+        peak[k] = std::max(peak[k], p);
+    }
+    frames_++;
+}
+
+void PowerAverager::clear() {
+    sum.fill(0);
+    peak.fill(0);
+    frames_ = 0;
+}
+
+float PowerAverager::power(const size_t bin, const Detector detector) const {
+    if (frames_ == 0) return 0.0f;
+
+    if (detector == Detector::Peak) {
+        return peak[bin] * scale;
+    }
+    return static_cast<float>(sum[bin]) / frames_ * scale;
+}
+
+uint8_t display_level(const float power) {
+    constexpr float mag_scale = 5.0f;
+    const int32_t v = (mag2_to_dbv_norm(power) - display_top_db) * mag_scale + 255.0f;
+    return std::max<int32_t>(0, std::min<int32_t>(255, v));
+}
+
+} /* namespace spectrum */
+} /* namespace dsp */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __DSP_SPECTRUM_H__
+#define __DSP_SPECTRUM_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+namespace dsp {
+namespace spectrum {
+
+/* Averaged power spectrum over fft_size sample frames. Each frame is
+ * weighted by a window kept as the first half of a symmetric Q15 table,
+ * transformed with the Q15 radix-4 FFT, and its power per bin is summed
+ * and max-held in integers until clear(). Frames may overlap, the caller
+ * picks where each one starts.
+ */
+class PowerAverager {
+   public:
+    static constexpr size_t fft_size = 256;
+
+    /* Rough M4 cycles of one accumulate(): window, FFT and power. */
+    static constexpr uint32_t frame_cycles = 12000;
+
+    using Window = WidebandSpectrumConfigMessage::Window;
+    using Detector = WidebandSpectrumConfigMessage::Detector;
+
+    PowerAverager();
+
+    void set_window(const Window window);
+
+    /* Accumulates the frame of fft_size samples starting at src. */
+    void accumulate(const complex8_t* const src);
+
+    void clear();
+
+    size_t frames() const { return frames_; }
+
+    /* Mean or peak power of a bin in natural FFT order since the last
+     * clear(), relative to a full scale tone centred on a bin. */
+    float power(const size_t bin, const Detector detector) const;
+
+   private:
+    std::array<int16_t, fft_size / 2> window_half{};
+    float scale{0.0f};
+
+    std::array<complex16_t, fft_size> frame{};
+    std::array<uint64_t, fft_size> sum{};
+    std::array<uint32_t, fft_size> peak{};
+    size_t frames_{0};
+};
+
+/* Maps a power from power() to the 0..255 spectrum scale, 5 per dB.
+ * 255 sits display_top_db below full scale so the noise floor of an 8 bit
+ * capture, about -60 dB per bin for 1 LSB of noise, stays above 0. */
+constexpr float display_top_db = -15.0f;
+
+uint8_t display_level(const float power);
+
+} /* namespace spectrum */
+} /* namespace dsp */
+
+#endif /*__DSP_SPECTRUM_H__*/
@@ -25,6 +25,7 @@
 #include "lpc43xx_cpp.hpp"
 #include "message_queue.hpp"
 #include "portapack_shared_memory.hpp"
+#include "cycle_profiler.hpp"
 
 #include <cstdint>
 #include <array>
@@ -79,12 +80,16 @@ eventmask_t EventDispatcher::wait() {
 }
 
 void EventDispatcher::dispatch(const eventmask_t events) {
+    cycle_profile::Stopwatch stopwatch{};
+
     if (events & EVT_MASK_BASEBAND) {
         handle_baseband_queue();
+        stopwatch.lap(cycle_profile::Scope::Messages);
     }
 
     if (events & EVT_MASK_SPECTRUM) {
         handle_spectrum();
+        stopwatch.lap(cycle_profile::Scope::Spectrum);
     }
 }
 
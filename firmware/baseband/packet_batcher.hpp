@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __PACKET_BATCHER_H__
+#define __PACKET_BATCHER_H__
+
+#include "message.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include <ch.h>
+
+/* Collects decoded packet messages into a PacketBatchMessage. The batch goes
+ * to the M0 when the next message doesn't fit, or once its oldest message
+ * has waited flush_timeout. Call update() from execute() to check the time.
+ */
+class PacketBatcher {
+   public:
+    static constexpr systime_t flush_timeout = MS2ST(50);
+
+    template <typename T>
+    void push(const T& message) {
+        static_assert(std::is_base_of<Message, T>::value, "type is not based on Message");
+        static_assert(PacketBatchMessage::entry_size(sizeof(T)) <= sizeof(PacketBatchMessage::data), "message too large to batch");
+
+        const auto now = chTimeNow();
+        if (!batch.append(message, sizeof(T), now)) {
+            flush();
+            batch.append(message, sizeof(T), now);
+        }
+        if (batch.count == 1) {
+            oldest = now;
+        }
+    }
+
+    void update() {
+        if (!batch.empty() && ((chTimeNow() - oldest) >= flush_timeout)) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (!batch.empty()) {
+            shared_memory.application_queue.push(batch, batch.size());
+            batch.clear();
+        }
+    }
+
+   private:
+    PacketBatchMessage batch{};
+    systime_t oldest{0};
+};
+
+#endif /*__PACKET_BATCHER_H__*/
@@ -27,12 +27,11 @@
 #include "baseband_thread.hpp"
 #include "rssi_thread.hpp"
 
-#include "adsb_frame.hpp"
+#include "adsb_demod.hpp"
+#include "packet_batcher.hpp"
 
 using namespace adsb;
 
-#define ADSB_PREAMBLE_LENGTH 16
-
 class ADSBRXProcessor : public BasebandProcessor {
    public:
     void execute(const buffer_c8_t& buffer) override;
@@ -40,18 +39,17 @@ class ADSBRXProcessor : public BasebandProcessor {
 
    private:
     static constexpr size_t baseband_fs = 2'000'000;
-    static constexpr size_t msg_len = 112;
 
-    ADSBFrame frame{};
     bool configured{false};
-    bool decoding{false};
 
-    uint32_t prev_mag{0};
-    int32_t amp{0};
-    size_t bit_count{0};
-    size_t sample_count{0};
+    PacketBatcher batcher{};
+
+    Demodulator demod{
+        [this](const ADSBFrame& frame, const uint32_t amp) {
+            this->on_frame(frame, amp);
+        }};
 
-    uint32_t shifter[ADSB_PREAMBLE_LENGTH + 1];
+    void on_frame(const ADSBFrame& frame, const uint32_t amp);
 
     void on_beep_message(const AudioBeepMessage& message);
 
@@ -23,6 +23,7 @@
 
 #include "audio_output.hpp"
 #include "audio_dma.hpp"
+#include "cycle_profiler.hpp"
 
 #include "event_m4.hpp"
 
@@ -33,19 +34,24 @@ void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
+    cycle_profile::Stopwatch stopwatch{};
+
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+    feed_channel_bank(channel_bank, decim_0_out);
     const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
 
     channel_spectrum.feed(decim_1_out, channel_filter_low_f, channel_filter_high_f, channel_filter_transition);
 
     const auto decim_2_out = decim_2.execute(decim_1_out, dst_buffer);
     const auto channel_out = channel_filter.execute(decim_2_out, dst_buffer);
+    stopwatch.lap(cycle_profile::Scope::Decimate);
 
     // TODO: Feed channel_stats post-decimation data?
     feed_channel_stats(channel_out);
 
     auto audio = demodulate(channel_out);
     audio_compressor.execute_in_place(audio);
+    stopwatch.lap(cycle_profile::Scope::Demodulate);
     audio_output.write(audio);
 }
 
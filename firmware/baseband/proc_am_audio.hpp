@@ -55,6 +55,7 @@ class NarrowbandAMAudio : public BasebandProcessor {
         audio.size()};
 
     dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0{};
+    ChannelBankCollector channel_bank{};
     dsp::decimate::FIRC16xR16x32Decim8 decim_1{};
     dsp::decimate::FIRAndDecimateComplex decim_2{};
     dsp::decimate::FIRAndDecimateComplex channel_filter{};
@@ -26,54 +26,51 @@
 #include "event_m4.hpp"
 #include "audio_dma.hpp"
 
+#include <algorithm>
 #include <cstdint>
 
 void AudioTXProcessor::execute(const buffer_c8_t& buffer) {
     if (!configured) return;
 
+    // One block read from the stream and one resampler run per buffer.
+    const size_t audio_count = std::min(buffer.count / hold_factor, audio_block.size());
+    const auto audio_in = fetch_audio(resampler.input_needed(audio_count));
+    if (interpolate)
+        resampler.execute(audio_in, {audio_block.data(), audio_count, audio_fs});
+    else
+        resampler.hold(audio_in, {audio_block.data(), audio_count, audio_fs});
+
     buffer_s16_t audio_buffer{audio_data, AUDIO_OUTPUT_BUFFER_SIZE, sampling_rate};
-    int16_t audio_sample_s16;
-
-    // Zero-order hold (poop)
-    for (size_t i = 0; i < buffer.count; i++) {
-        resample_acc += resample_inc;
-        if (resample_acc >= 0x10000) {
-            resample_acc -= 0x10000;
-            if (stream) {
-                audio_sample = 0;
-                stream->read(&audio_sample, bytes_per_sample);  // assumes little endian when reading 1 byte
-                samples_read++;
-            }
-        }
 
-        if (bytes_per_sample == 1) {
-            sample = audio_sample - 0x80;
-            audio_sample_s16 = sample * 256;
-        } else {
-            audio_sample_s16 = (int16_t)audio_sample;
+    // Each audio sample drives hold_factor baseband samples.
+    size_t i = 0;
+    for (size_t a = 0; a < audio_count; a++) {
+        const int16_t audio_sample_s16 = audio_block[a];
+
+        for (size_t h = 0; h < hold_factor; h++, i++) {
             sample = audio_sample_s16 / 256;
-        }
 
-        // Output to speaker too
-        if (!tone_key_enabled) {
-            uint32_t imod32 = i & (AUDIO_OUTPUT_BUFFER_SIZE - 1);
-            audio_data[imod32] = audio_sample_s16;
-            if (imod32 == (AUDIO_OUTPUT_BUFFER_SIZE - 1))
-                audio_output.write_unprocessed(audio_buffer);
-        }
+            // Output to speaker too
+            if (!tone_key_enabled) {
+                uint32_t imod32 = i & (AUDIO_OUTPUT_BUFFER_SIZE - 1);
+                audio_data[imod32] = audio_sample_s16;
+                if (imod32 == (AUDIO_OUTPUT_BUFFER_SIZE - 1))
+                    audio_output.write_unprocessed(audio_buffer);
+            }
 
-        sample = tone_gen.process(sample);
+            sample = tone_gen.process(sample);
 
-        // FM
-        delta = sample * fm_delta;
+            // FM
+            delta = sample * fm_delta;
 
-        phase += delta;
-        sphase = phase + (64 << 24);
+            phase += delta;
+            sphase = phase + (64 << 24);
 
-        re = sine_table_i8[(sphase & 0xFF000000U) >> 24];
-        im = sine_table_i8[(phase & 0xFF000000U) >> 24];
+            re = sine_table_i8[(sphase & 0xFF000000U) >> 24];
+            im = sine_table_i8[(phase & 0xFF000000U) >> 24];
 
-        buffer.p[i] = {(int8_t)re, (int8_t)im};
+            buffer.p[i] = {(int8_t)re, (int8_t)im};
+        }
     }
 
     progress_samples += buffer.count;
@@ -86,6 +83,18 @@ void AudioTXProcessor::execute(const buffer_c8_t& buffer) {
     }
 }
 
+buffer_s16_t AudioTXProcessor::fetch_audio(const size_t frames) {
+    const size_t count = std::min(frames, audio_input.size());
+
+    // A stream underrun plays as silence.
+    if (stream)
+        samples_read += pcm_reader.read(*stream, audio_input.data(), count);
+    else
+        std::fill_n(audio_input.begin(), count, 0);
+
+    return {audio_input.data(), count, sampling_rate};
+}
+
 void AudioTXProcessor::on_message(const Message* const message) {
     switch (message->id) {
         case Message::ID::AudioTXConfig:
@@ -115,8 +124,9 @@ void AudioTXProcessor::audio_config(const AudioTXConfigMessage& message) {
     fm_delta = message.deviation_hz * (0xFFFFFFULL / baseband_fs);
     tone_gen.configure(message.tone_key_delta, message.tone_key_mix_weight);
     progress_interval_samples = message.divider;
-    resample_acc = 0;
-    bytes_per_sample = message.bits_per_sample / 8;
+    resampler.reset();
+    pcm_reader.configure(message.bits_per_sample / 8, message.channels);
+    interpolate = message.interpolate;
     audio_output.configure(false);
 
     tone_key_enabled = (message.tone_key_delta != 0);
@@ -135,7 +145,7 @@ void AudioTXProcessor::replay_config(const ReplayConfigMessage& message) {
 }
 
 void AudioTXProcessor::sample_rate_config(const SampleRateConfigMessage& message) {
-    resample_inc = (((uint64_t)message.sample_rate) << 16) / baseband_fs;  // 16.16 fixed point message.sample_rate
+    resampler.configure(message.sample_rate, audio_fs);
     sampling_rate = message.sample_rate;
 }
 
@@ -29,6 +29,9 @@
 #include "stream_output.hpp"
 #include "audio_output.hpp"
 #include "audio_dma.hpp"
+#include "dsp_resample.hpp"
+
+#include <array>
 
 #define AUDIO_OUTPUT_BUFFER_SIZE 32
 
@@ -41,19 +44,31 @@ class AudioTXProcessor : public BasebandProcessor {
    private:
     static constexpr size_t baseband_fs = 1536000;
 
+    /* Audio is resampled to baseband_fs / hold_factor (192kHz), each
+     * sample then drives hold_factor baseband samples. */
+    static constexpr size_t hold_factor = 8;
+    static constexpr size_t audio_fs = baseband_fs / hold_factor;
+    static constexpr size_t audio_block_size = 2048 / hold_factor;
+
     std::unique_ptr<StreamOutput> stream{};
 
     ToneGen tone_gen{};
 
-    uint32_t resample_inc{}, resample_acc{};
     uint32_t fm_delta{0};
     uint32_t phase{0}, sphase{0};
-    uint32_t audio_sample{};
     int32_t sample{0}, delta{};
     int8_t re{0}, im{0};
-    uint8_t bytes_per_sample{1};
     uint32_t sampling_rate{48000};
 
+    dsp::resample::PolyphaseInterpolator resampler{};
+    dsp::resample::PCMReader pcm_reader{};
+    bool interpolate{false};
+
+    /* Frames fetched from the stream once per buffer, converted to mono
+     * int16, and the same at audio_fs. */
+    std::array<int16_t, audio_block_size * dsp::resample::PolyphaseInterpolator::max_step> audio_input{};
+    std::array<int16_t, audio_block_size> audio_block{};
+
     int16_t audio_data[AUDIO_OUTPUT_BUFFER_SIZE];
     AudioOutput audio_output{};
 
@@ -63,6 +78,8 @@ class AudioTXProcessor : public BasebandProcessor {
     uint32_t samples_read{0};
     bool tone_key_enabled{false};
 
+    buffer_s16_t fetch_audio(const size_t frames);
+
     void sample_rate_config(const SampleRateConfigMessage& message);
     void audio_config(const AudioTXConfigMessage& message);
     void replay_config(const ReplayConfigMessage& message);
@@ -27,6 +27,8 @@
 
 #include "event_m4.hpp"
 
+#include <algorithm>
+
 uint32_t BTLERxProcessor::crc_init_reorder(uint32_t crc_init) {
     int i;
     uint32_t crc_init_tmp, crc_init_input, crc_init_input_tmp;
@@ -53,32 +55,10 @@ uint32_t BTLERxProcessor::crc_init_reorder(uint32_t crc_init) {
     return (crc_init_tmp);
 }
 
-uint_fast32_t BTLERxProcessor::crc_update(uint_fast32_t crc, const void* data, size_t data_len) {
-    const unsigned char* d = (const unsigned char*)data;
-    unsigned int tbl_idx;
-
-    while (data_len--) {
-        tbl_idx = (crc ^ *d) & 0xff;
-        crc = (crc_table[tbl_idx] ^ (crc >> 8)) & 0xffffff;
-
-        d++;
-    }
-
-    return crc & 0xffffff;
-}
-
-uint_fast32_t BTLERxProcessor::crc24_byte(uint8_t* byte_in, int num_byte, uint32_t init_hex) {
-    uint_fast32_t crc = init_hex;
-
-    crc = crc_update(crc, byte_in, num_byte);
-
-    return (crc);
-}
-
 bool BTLERxProcessor::crc_check(uint8_t* tmp_byte, int body_len, uint32_t crc_init) {
     int crc24_checksum;
 
-    crc24_checksum = crc24_byte(tmp_byte, body_len, crc_init);  // 0x555555 --> 0xaaaaaa. maybe because byte order
+    crc24_checksum = btle::crc24(tmp_byte, body_len, crc_init);  // 0x555555 --> 0xaaaaaa. maybe because byte order
     checksumReceived = 0;
     checksumReceived = ((checksumReceived << 8) | tmp_byte[body_len + 2]);
     checksumReceived = ((checksumReceived << 8) | tmp_byte[body_len + 1]);
@@ -87,14 +67,6 @@ bool BTLERxProcessor::crc_check(uint8_t* tmp_byte, int body_len, uint32_t crc_in
     return (crc24_checksum != checksumReceived);
 }
 
-void BTLERxProcessor::scramble_byte(uint8_t* byte_in, int num_byte, const uint8_t* scramble_table_byte, uint8_t* byte_out) {
-    int i;
-
-    for (i = 0; i < num_byte; i++) {
-        byte_out[i] = byte_in[i] ^ scramble_table_byte[i];
-    }
-}
-
 int BTLERxProcessor::verify_payload_byte(int num_payload_byte, ADV_PDU_TYPE pdu_type) {
     // Should at least have 6 bytes for the MAC Address.
     // Also ensuring that there is at least 1 byte of data.
@@ -122,120 +94,61 @@ int BTLERxProcessor::verify_payload_byte(int num_payload_byte, ADV_PDU_TYPE pdu_
     return 0;
 }
 
-void BTLERxProcessor::handleBeginState() {
-    int num_symbol_left = dst_buffer.count / SAMPLE_PER_SYMBOL;  // One buffer sample consist of I and Q.
-
-    static uint8_t demod_buf_access[SAMPLE_PER_SYMBOL][LEN_DEMOD_BUF_ACCESS];
-
-    uint32_t uint32_tmp = DEFAULT_ACCESS_ADDR;
-    uint8_t accessAddrBits[LEN_DEMOD_BUF_ACCESS];
-
-    uint32_t accesssAddress = 0;
-
-    // Filling up addressBits with the access address we are looking to find.
-    for (int i = 0; i < 32; i++) {
-        accessAddrBits[i] = 0x01 & uint32_tmp;
-        uint32_tmp = (uint32_tmp >> 1);
-    }
-
-    const int demod_buf_len = LEN_DEMOD_BUF_ACCESS;  // For AA
-    int demod_buf_offset = 0;
-    int hit_idx = (-1);
-    bool unequal_flag = false;
-
-    memset(demod_buf_access, 0, SAMPLE_PER_SYMBOL * demod_buf_len);
-
-    for (int i = 0; i < num_symbol_left * SAMPLE_PER_SYMBOL; i += SAMPLE_PER_SYMBOL) {
-        int sp = ((demod_buf_offset - demod_buf_len + 1) & (demod_buf_len - 1));
+uint8_t BTLERxProcessor::demod_bit(const int i) const {
+    // Sample and compare with the previous one.
+    const complex16_t s0 = (i > 0) ? dst_buffer.p[i - 1] : last_sample;
+    const complex16_t s1 = dst_buffer.p[i];
 
-        for (int j = 0; j < SAMPLE_PER_SYMBOL; j++) {
-            // Sample and compare with the adjacent next sample.
-            int I0 = dst_buffer.p[i + j].real();
-            int Q0 = dst_buffer.p[i + j].imag();
-            int I1 = dst_buffer.p[i + j + 1].real();
-            int Q1 = dst_buffer.p[i + j + 1].imag();
+    int I0 = s0.real();
+    int Q0 = s0.imag();
+    int I1 = s1.real();
+    int Q1 = s1.imag();
 
-            int phase_idx = j;
-
-            demod_buf_access[phase_idx][demod_buf_offset] = (I0 * Q1 - I1 * Q0) > 0 ? 1 : 0;
-
-            int k = sp;
-            unequal_flag = false;
-
-            accesssAddress = 0;
-
-            for (int p = 0; p < demod_buf_len; p++) {
-                if (demod_buf_access[phase_idx][k] != accessAddrBits[p]) {
-                    unequal_flag = true;
-                    hit_idx = (-1);
-                    break;
-                }
-
-                accesssAddress = (accesssAddress & (~(1 << p))) | (demod_buf_access[phase_idx][k] << p);
-
-                k = ((k + 1) & (demod_buf_len - 1));
-            }
-
-            if (unequal_flag == false) {
-                hit_idx = (i + j - (demod_buf_len - 1) * SAMPLE_PER_SYMBOL);
-                break;
-            }
-        }
-
-        if (unequal_flag == false) {
-            break;
-        }
+    return (I0 * Q1 - I1 * Q0) > 0 ? 1 : 0;
+}
 
-        demod_buf_offset = ((demod_buf_offset + 1) & (demod_buf_len - 1));
+void BTLERxProcessor::receive_bit(const uint8_t bit) {
+    if (bit_index == 0) {
+        rb_buf[packet_index] = bit;
+    } else {
+        rb_buf[packet_index] |= bit << bit_index;
     }
 
-    if (hit_idx == -1) {
-        // Process more samples.
+    if (++bit_index < 8) {
         return;
     }
+    bit_index = 0;
+    packet_index++;
 
-    symbols_eaten += hit_idx;
-
-    symbols_eaten += (8 * NUM_ACCESS_ADDR_BYTE * SAMPLE_PER_SYMBOL);  // move to the beginning of PDU header
-
-    num_symbol_left = num_symbol_left - symbols_eaten;
-
-    parseState = Parse_State_PDU_Header;
+    if (parseState == Parse_State_PDU_Header && packet_index == 2) {
+        handlePDUHeaderState();
+    } else if (parseState == Parse_State_PDU_Payload && packet_index == payload_len + 5) {
+        handlePDUPayloadState();
+    }
 }
 
-void BTLERxProcessor::handlePDUHeaderState() {
-    int num_demod_byte = 2;  // PDU header has 2 octets
+void BTLERxProcessor::handleBeginState(const int i) {
+    auto& correlator = correlators[i % SAMPLE_PER_SYMBOL];
 
-    symbols_eaten += 8 * num_demod_byte * SAMPLE_PER_SYMBOL;
-
-    if (symbols_eaten > (int)dst_buffer.count) {
+    if (!correlator.feed(demod_bit(i))) {
         return;
     }
 
-    // Jump back down to the beginning of PDU header.
-    sample_idx = symbols_eaten - (8 * num_demod_byte * SAMPLE_PER_SYMBOL);
-
+    // The PDU header starts with the next symbol at this sample phase.
+    for (auto& c : correlators) {
+        c.reset();
+    }
+    next_bit_sample = i + SAMPLE_PER_SYMBOL;
     packet_index = 0;
+    bit_index = 0;
 
-    for (int i = 0; i < num_demod_byte; i++) {
-        rb_buf[packet_index] = 0;
-
-        for (int j = 0; j < 8; j++) {
-            int I0 = dst_buffer.p[sample_idx].real();
-            int Q0 = dst_buffer.p[sample_idx].imag();
-            int I1 = dst_buffer.p[sample_idx + 1].real();
-            int Q1 = dst_buffer.p[sample_idx + 1].imag();
-
-            bit_decision = (I0 * Q1 - I1 * Q0) > 0 ? 1 : 0;
-            rb_buf[packet_index] = rb_buf[packet_index] | (bit_decision << j);
-
-            sample_idx += SAMPLE_PER_SYMBOL;
-        }
+    parseState = Parse_State_PDU_Header;
+}
 
-        packet_index++;
-    }
+void BTLERxProcessor::handlePDUHeaderState() {
+    int num_demod_byte = 2;  // PDU header has 2 octets
 
-    scramble_byte(rb_buf, num_demod_byte, scramble_table[channel_number], rb_buf);
+    dewhitener.apply(rb_buf, 0, num_demod_byte);
 
     pdu_type = (ADV_PDU_TYPE)(rb_buf[0] & 0x0F);
     // uint8_t tx_add = ((rb_buf[0] & 0x40) != 0);
@@ -254,35 +167,16 @@ void BTLERxProcessor::handlePDUHeaderState() {
 void BTLERxProcessor::handlePDUPayloadState() {
     int i;
     int num_demod_byte = (payload_len + 3);
-    symbols_eaten += 8 * num_demod_byte * SAMPLE_PER_SYMBOL;
 
-    if (symbols_eaten > (int)dst_buffer.count) {
-        return;
-    }
-
-    for (i = 0; i < num_demod_byte; i++) {
-        rb_buf[packet_index] = 0;
-
-        for (int j = 0; j < 8; j++) {
-            int I0 = dst_buffer.p[sample_idx].real();
-            int Q0 = dst_buffer.p[sample_idx].imag();
-            int I1 = dst_buffer.p[sample_idx + 1].real();
-            int Q1 = dst_buffer.p[sample_idx + 1].imag();
-
-            bit_decision = (I0 * Q1 - I1 * Q0) > 0 ? 1 : 0;
-            rb_buf[packet_index] = rb_buf[packet_index] | (bit_decision << j);
-
-            sample_idx += SAMPLE_PER_SYMBOL;
-        }
-
-        packet_index++;
-    }
-
-    scramble_byte(rb_buf + 2, num_demod_byte, scramble_table[channel_number] + 2, rb_buf + 2);
+    dewhitener.apply(rb_buf + 2, 2, num_demod_byte);
 
     // Check CRC
     bool crc_flag = crc_check(rb_buf, payload_len + 2, crc_init_internal);
-    // pkt_count++;
+    if (crc_flag) {
+        crc_errors++;
+    } else {
+        packets++;
+    }
 
     // This should be the flag that determines if the data should be sent to the application layer.
     bool sendPacket = false;
@@ -315,19 +209,54 @@ void BTLERxProcessor::handlePDUPayloadState() {
             }
 
             blePacketData.dataLen = i;
+            blePacketData.channel = channel_number;
 
-            BLEPacketMessage data_message{&blePacketData};
-
-            shared_memory.application_queue.push(data_message);
+            const BLEPacketMessage data_message{blePacketData};
+            batcher.push(data_message);
         }
     }
 
     parseState = Parse_State_Begin;
 }
 
+void BTLERxProcessor::reset_parser() {
+    for (auto& correlator : correlators) {
+        correlator = btle::AccessAddressCorrelator{DEFAULT_ACCESS_ADDR, MAX_ACCESS_ADDR_ERRORS};
+    }
+    parseState = Parse_State_Begin;
+}
+
+// A packet being read when the M0 retunes would end on the new channel: drop
+// it, with the rest of this buffer and the settle time that follows.
+void BTLERxProcessor::follow_retune() {
+    const uint32_t epoch = shared_memory.retune_epoch;
+    if (epoch == retune_epoch)
+        return;
+
+    retune_epoch = epoch;
+    const uint64_t rate = decim_fs;
+    skip_samples = dst_buffer.count + rate * shared_memory.retune_settle_us / 1000000;
+    reset_parser();
+}
+
+void BTLERxProcessor::send_statistics() {
+    statistics_buffers = 0;
+    if (packets == 0 && crc_errors == 0)
+        return;
+
+    // Counts the queue can't take are carried into the next interval.
+    const BTLERxStatisticsMessage message{channel_number, packets, crc_errors};
+    if (shared_memory.application_queue.push(message)) {
+        packets = 0;
+        crc_errors = 0;
+    }
+}
+
 void BTLERxProcessor::execute(const buffer_c8_t& buffer) {
     if (!configured) return;
 
+    batcher.update();
+
     // Pulled this implementation from channel_stats_collector.c to time slice a specific packet's dB.
     uint32_t max_squared = 0;
 
@@ -348,21 +277,28 @@ void BTLERxProcessor::execute(const buffer_c8_t& buffer) {
     // Decimated by 4 to achieve 2048/4 = 512 samples at 1 sample per symbol.
     decim_0.execute(buffer, dst_buffer);
     feed_channel_stats(dst_buffer);
+    follow_retune();
 
-    symbols_eaten = 0;
-
-    // Handle parsing based on parseState
-    if (parseState == Parse_State_Begin) {
-        handleBeginState();
+    if (++statistics_buffers == statistics_interval) {
+        send_statistics();
     }
 
-    if (parseState == Parse_State_PDU_Header) {
-        handlePDUHeaderState();
+    // Bit by bit, so packets may cross buffers and several may share one.
+    const int count = dst_buffer.count;
+    const int first = std::min<uint32_t>(skip_samples, count);
+    skip_samples -= first;
+
+    for (int i = first; i < count; i++) {
+        if (parseState == Parse_State_Begin) {
+            handleBeginState(i);
+        } else if (i == next_bit_sample) {
+            next_bit_sample += SAMPLE_PER_SYMBOL;
+            receive_bit(demod_bit(i));
+        }
     }
 
-    if (parseState == Parse_State_PDU_Payload) {
-        handlePDUPayloadState();
-    }
+    next_bit_sample -= count;
+    last_sample = dst_buffer.p[count - 1];
 }
 
 void BTLERxProcessor::on_message(const Message* const message) {
@@ -371,9 +307,15 @@ void BTLERxProcessor::on_message(const Message* const message) {
 }
 
 void BTLERxProcessor::configure(const BTLERxConfigureMessage& message) {
+    // Counts so far belong to the previous channel.
+    send_statistics();
+
     channel_number = message.channel_number;
     decim_0.configure(taps_BTLE_1M_PHY_decim_0.taps);
 
+    dewhitener.configure(channel_number);
+    reset_parser();
+
     configured = true;
 
     crc_init_internal = crc_init_reorder(crc_initalVale);
@@ -34,16 +34,14 @@ CaptureProcessor::CaptureProcessor() {
 }
 
 void CaptureProcessor::execute(const buffer_c8_t& buffer) {
-    auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-    auto out_buffer = decim_1.execute(decim_0_out, dst_buffer);
+    // When the stream's active buffer has room for the whole output block,
+    // the last decimation stage writes straight into it and no copy is made.
+    const size_t out_count = buffer.count / (decim_0.decimation_factor() * decim_1.decimation_factor());
+    void* const stream_dst = stream ? stream->acquire(out_count * sizeof(complex16_t)) : nullptr;
 
-    if (stream) {
-        const size_t bytes_to_write = sizeof(*out_buffer.p) * out_buffer.count;
-        const size_t written = stream->write(out_buffer.p, bytes_to_write);
-        if (written != bytes_to_write) {
-            // TODO: Send an error message to the app?
-        }
-    }
+    const auto out_buffer = decimate(
+        buffer,
+        stream_dst ? buffer_c16_t{static_cast<complex16_t*>(stream_dst), out_count} : dst_buffer);
 
     feed_channel_stats(out_buffer);
 
@@ -53,6 +51,26 @@ void CaptureProcessor::execute(const buffer_c8_t& buffer) {
         channel_spectrum.feed(out_buffer, channel_filter_low_f,
                               channel_filter_high_f, channel_filter_transition);
     }
+
+    // Committed last, the M0 may convert a full buffer in place.
+    const size_t bytes_to_write = sizeof(*out_buffer.p) * out_buffer.count;
+    if (stream_dst) {
+        stream->commit(bytes_to_write);
+    } else if (stream) {
+        const size_t written = stream->write(out_buffer.p, bytes_to_write);
+        if (written != bytes_to_write) {
+            // TODO: Send an error message to the app?
+        }
+    }
+}
+
+buffer_c16_t CaptureProcessor::decimate(const buffer_c8_t& buffer, const buffer_c16_t& out_dst) {
+    if (decim_1.is<NoopDecim>())
+        return decim_0.execute(buffer, out_dst);
+
+    // Both stages, the first one into the work buffer.
+    const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+    return decim_1.execute(decim_0_out, out_dst);
 }
 
 void CaptureProcessor::on_signal_message(const RequestSignalMessage& message) {
@@ -65,6 +65,11 @@ class MultiDecimator {
             decimator_);
     }
 
+    template <typename Decimator>
+    bool is() const {
+        return std::holds_alternative<Decimator>(decimator_);
+    }
+
     size_t decimation_factor() const {
         return std::visit(
             [](auto&& arg) -> size_t {
@@ -130,6 +135,8 @@ class CaptureProcessor : public BasebandProcessor {
         baseband_fs, this, baseband::Direction::Receive, /*auto_start*/ false};
     RSSIThread rssi_thread{};
 
+    buffer_c16_t decimate(const buffer_c8_t& buffer, const buffer_c16_t& out_dst);
+
     void sample_rate_config(const SampleRateConfigMessage& message);
     void capture_config(const CaptureConfigMessage& message);
 };
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "proc_channelizer.hpp"
+
+#include "dsp_fir_taps.hpp"
+#include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+
+void ChannelizerProcessor::execute(const buffer_c8_t& buffer) {
+    if (!configured) return;
+
+    const auto channel = decim_0.execute(buffer, dst_buffer);
+    feed_channel_stats(channel);
+
+    out_count = 0;
+    channelizer.execute(channel, [this](const complex16_t* const channels) {
+        on_frame(channels);
+    });
+
+    if (stream && out_count) {
+        stream->write(out.data(), out_count * sizeof(complex16_t));
+    }
+}
+
+void ChannelizerProcessor::on_frame(const complex16_t* const channels) {
+    for (size_t i = 0; i < selected_count; i++) {
+        const auto sample = channels[selected[i]];
+        const uint32_t mag_sq = static_cast<uint32_t>(sample.real() * sample.real()) + static_cast<uint32_t>(sample.imag() * sample.imag());
+        max_mag_sq[i] = std::max(max_mag_sq[i], mag_sq);
+        out[out_count++] = sample;
+    }
+
+    if (++frames >= frames_per_update) {
+        MultiChannelStatistics statistics{};
+        for (size_t i = 0; i < selected_count; i++) {
+            statistics.max_db[i] = mag2_to_dbv_norm(std::max(max_mag_sq[i] * (1.0f / (32768.0f * 32768.0f)), 1e-12f));
+        }
+        statistics.channel_count = selected_count;
+        statistics.count = frames * Channelizer::channels_count;
+        statistics.epoch = shared_memory.retune_epoch;
+
+        const MultiChannelStatisticsMessage message{statistics};
+        shared_memory.application_queue.push(message);
+
+        max_mag_sq.fill(0);
+        frames = 0;
+    }
+}
+
+void ChannelizerProcessor::on_message(const Message* const message) {
+    switch (message->id) {
+        case Message::ID::ChannelizerConfig:
+            configure(*reinterpret_cast<const ChannelizerConfigMessage*>(message));
+            break;
+
+        case Message::ID::CaptureConfig:
+            capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ChannelizerProcessor::configure(const ChannelizerConfigMessage& message) {
+    baseband_fs = message.sampling_rate;
+    baseband_thread.set_sampling_rate(baseband_fs);
+
+    decim_0.configure(taps_channelizer_decim_0.taps);
+    channelizer.reset();
+
+    selected_count = std::min(message.selected_count, max_selected);
+    for (size_t i = 0; i < selected_count; i++) {
+        selected[i] = message.selected[i] & (Channelizer::channels_count - 1);
+    }
+
+    const size_t frame_rate = baseband_fs / decimation / Channelizer::channels_count;
+    frames_per_update = std::max<size_t>(frame_rate * update_interval, 1);
+    max_mag_sq.fill(0);
+    frames = 0;
+
+    configured = true;
+}
+
+void ChannelizerProcessor::capture_config(const CaptureConfigMessage& message) {
+    if (message.config)
+        stream = std::make_unique<StreamInput>(message.config);
+    else
+        stream.reset();
+}
+
+int main() {
+    EventDispatcher event_dispatcher{std::make_unique<ChannelizerProcessor>()};
+    event_dispatcher.run();
+    return 0;
+}
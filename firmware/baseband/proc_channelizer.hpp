@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __PROC_CHANNELIZER_H__
+#define __PROC_CHANNELIZER_H__
+
+#include "baseband_processor.hpp"
+#include "baseband_thread.hpp"
+#include "rssi_thread.hpp"
+
+#include "dsp_channelizer.hpp"
+#include "dsp_decimate.hpp"
+#include "stream_input.hpp"
+#include "message.hpp"
+
+#include <array>
+#include <memory>
+
+/* Splits the capture into 64 equal channels. The selected ones are
+ * reported as MultiChannelStatistics and, when capturing, written to the
+ * stream interleaved: one complex16 per selected channel per frame.
+ */
+class ChannelizerProcessor : public BasebandProcessor {
+   public:
+    void execute(const buffer_c8_t& buffer) override;
+    void on_message(const Message* const message) override;
+
+   private:
+    using Channelizer = dsp::channelize::PolyphaseChannelizer;
+
+    static constexpr float update_interval{0.1f};
+    static constexpr size_t max_selected = ChannelizerConfigMessage::max_selected;
+    static constexpr size_t decimation = 4;
+    static constexpr size_t max_frames = 2048 / decimation / Channelizer::channels_count;
+
+    size_t baseband_fs = 3200000;
+
+    std::array<complex16_t, 512> dst{};
+    const buffer_c16_t dst_buffer{
+        dst.data(),
+        dst.size()};
+
+    dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0{};
+    Channelizer channelizer{};
+
+    std::array<uint8_t, max_selected> selected{};
+    size_t selected_count{0};
+    std::array<uint32_t, max_selected> max_mag_sq{};
+    size_t frames{0};
+    size_t frames_per_update{1};
+
+    /* Selected channels of the frames of one buffer, for the stream. */
+    std::array<complex16_t, max_frames * max_selected> out{};
+    size_t out_count{0};
+
+    std::unique_ptr<StreamInput> stream{};
+    bool configured{false};
+
+    /* NB: Threads should be the last members in the class definition. */
+    BasebandThread baseband_thread{baseband_fs, this, baseband::Direction::Receive};
+    RSSIThread rssi_thread{};
+
+    void on_frame(const complex16_t* const channels);
+    void configure(const ChannelizerConfigMessage& message);
+    void capture_config(const CaptureConfigMessage& message);
+};
+
+#endif /*__PROC_CHANNELIZER_H__*/
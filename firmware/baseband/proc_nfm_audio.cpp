@@ -25,6 +25,7 @@
 #include "portapack_shared_memory.hpp"
 
 #include "audio_dma.hpp"
+#include "cycle_profiler.hpp"
 
 #include "event_m4.hpp"
 
@@ -38,18 +39,23 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
+    cycle_profile::Stopwatch stopwatch{};
+
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+    feed_channel_bank(channel_bank, decim_0_out);
     const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
 
     channel_spectrum.feed(decim_1_out, channel_filter_low_f, channel_filter_high_f, channel_filter_transition);
 
     const auto channel_out = channel_filter.execute(decim_1_out, dst_buffer);
+    stopwatch.lap(cycle_profile::Scope::Decimate);
 
     feed_channel_stats(channel_out);
 
     if (!pitch_rssi_enabled) {
         // Normal mode, output demodulated audio
         auto audio = demod.execute(channel_out, audio_buffer);
+        stopwatch.lap(cycle_profile::Scope::Demodulate);
         audio_output.write(audio);
 
         if (ctcss_detect_enabled) {
@@ -66,6 +66,7 @@ class NarrowbandFMAudio : public BasebandProcessor {
         sizeof(tone) / sizeof(int16_t)};
 
     dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0{};
+    ChannelBankCollector channel_bank{};
     dsp::decimate::FIRC16xR16x32Decim8 decim_1{};
     dsp::decimate::FIRAndDecimateComplex channel_filter{};
     int32_t channel_filter_low_f = 0;
@@ -300,6 +300,8 @@ void CodewordExtractor::pad_idle() {
 void POCSAGProcessor::execute(const buffer_c8_t& buffer) {
     if (!configured) return;
 
+    batcher.update();
+
     // buffer has 2048 samples
     // decim0 out: 2048/8 = 256 samples
     // decim1 out: 256/8 = 32 samples
@@ -415,7 +417,7 @@ void POCSAGProcessor::send_packet() {
     packet.set(word_extractor.batch());
 
     POCSAGPacketMessage message(packet);
-    shared_memory.application_queue.push(message);
+    batcher.push(message);
 }
 
 void POCSAGProcessor::on_beep_message(const AudioBeepMessage& message) {
@@ -35,6 +35,7 @@
 #include "dsp_demodulate.hpp"
 #include "dsp_iir_config.hpp"
 #include "message.hpp"
+#include "packet_batcher.hpp"
 #include "pocsag.hpp"
 #include "pocsag_packet.hpp"
 #include "portapack_shared_memory.hpp"
@@ -261,6 +262,8 @@ class POCSAGProcessor : public BasebandProcessor {
     /* Processes audio into bits. */
     BitExtractor bit_extractor{bits};
 
+    PacketBatcher batcher{};
+
     /* Processes bits into codewords. */
     CodewordExtractor word_extractor{
         bits, [this](CodewordExtractor&) {
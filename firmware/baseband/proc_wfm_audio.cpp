@@ -27,6 +27,7 @@
 #include "dsp_fft.hpp"
 #include "event_m4.hpp"
 #include "audio_dma.hpp"
+#include "cycle_profiler.hpp"
 
 #include <cstdint>
 
@@ -35,8 +36,11 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
+    cycle_profile::Stopwatch stopwatch{};
+
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
     const auto channel = decim_1.execute(decim_0_out, dst_buffer);
+    stopwatch.lap(cycle_profile::Scope::Decimate);
 
     // TODO: Feed channel_stats post-decimation data?
     feed_channel_stats(channel);
@@ -65,6 +69,7 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
      * -> 4th order CIC decimation by 2, gain of 1
      * -> 96kHz int16_t[64] */
     auto audio_2fs = audio_dec_2.execute(audio_4fs, work_audio_buffer);
+    stopwatch.lap(cycle_profile::Scope::Demodulate);
 
     // Input: 96kHz int16_t[64]
     // audio_spectrum_decimator piles up 256 samples before doing FFT computation
@@ -23,43 +23,80 @@
 #include "audio_dma.hpp"
 
 #include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+
+#include "lpc43xx_cpp.hpp"
+using namespace lpc43xx;
 
 #include <cstdint>
 #include <cstddef>
 
+#include <algorithm>
 #include <array>
 
 void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
     // 2048 complex8_t samples per buffer.
     // 102.4us per buffer. 20480 instruction cycles per buffer.
+    // Frames are paid for from a cycle budget, so high sampling rates and
+    // heavy overlap average fewer frames instead of starving the other threads.
 
     if (!configured) return;
 
-    if (phase == 0) {
-        std::fill(spectrum.begin(), spectrum.end(), 0);
+    const uint32_t budget = buffer.count * budget_cycles_per_second / baseband_fs;
+    if (sweep.active()) {
+        sweep.execute(buffer, budget);
+        return;
     }
 
-    for (size_t i = 0; i < spectrum.size(); i++) {
-        // TODO: Removed window-presum windowing, due to lack of available code RAM.
-        // TODO: Apply window to improve spectrum bin sidelobes.
-        spectrum[i] += buffer.p[i + 0];
-        spectrum[i] += buffer.p[i + 1024];
+    credit = std::min(credit + budget, budget + frame_cycles);
+
+    for (size_t offset = 0; offset + fft_size <= buffer.count && credit >= frame_cycles; offset += hop) {
+        averager.accumulate(&buffer.p[offset]);
+        credit -= frame_cycles;
     }
 
     if (phase == trigger) {
-        const buffer_c16_t buffer_c16{
-            spectrum.data(),
-            spectrum.size(),
-            buffer.sampling_rate};
-        channel_spectrum.feed(
-            buffer_c16,
-            0, 0, 0);
+        if (averager.frames()) {
+            channel_spectrum.feed_power(
+                buffer.sampling_rate,
+                [this](const size_t bin) { return averager.power(bin, detector); });
+        }
+        averager.clear();
         phase = 0;
     } else {
         phase++;
     }
 }
 
+void WidebandSpectrum::configure(const WidebandSpectrumConfigMessage& message) {
+    baseband_fs = message.sampling_rate;
+    trigger = message.trigger;
+    averager.set_window(message.window);
+    averager.clear();
+    hop = fft_size >> std::min<size_t>(message.overlap_log2, 2);
+    detector = message.detector;
+    baseband_thread.set_sampling_rate(baseband_fs);
+    credit = 0;
+    phase = 0;
+    configured = true;
+}
+
+uint32_t WidebandSpectrum::SharedMemorySweepLink::request(const uint16_t step) {
+    const uint32_t request = shared_memory.sweep_request + 1;
+    shared_memory.sweep_step = step;
+    shared_memory.sweep_request = request;
+    creg::m4txevent::assert_event();
+    return request;
+}
+
+bool WidebandSpectrum::SharedMemorySweepLink::tuned(const uint32_t request) const {
+    return shared_memory.sweep_tuned == request;
+}
+
+bool WidebandSpectrum::SharedMemorySweepLink::post(const SweepBatchMessage& message) {
+    return shared_memory.application_queue.push(message);
+}
+
 void WidebandSpectrum::on_signal_message(const RequestSignalMessage& message) {
     if (message.signal == RequestSignalMessage::Signal::BeepStopRequest) {
         audio::dma::beep_stop();
@@ -84,8 +121,6 @@ void WidebandSpectrum::on_message(const Message* const msg) {
             break;
     }
 
-    const WidebandSpectrumConfigMessage message = *reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg);
-
     switch (msg->id) {
         case Message::ID::UpdateSpectrum:
         case Message::ID::SpectrumStreamingConfig:
@@ -93,11 +128,11 @@ void WidebandSpectrum::on_message(const Message* const msg) {
             break;
 
         case Message::ID::WidebandSpectrumConfig:
-            baseband_fs = message.sampling_rate;
-            trigger = message.trigger;
-            baseband_thread.set_sampling_rate(baseband_fs);
-            phase = 0;
-            configured = true;
+            configure(*reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg));
+            break;
+
+        case Message::ID::SweepConfig:
+            sweep.configure(*reinterpret_cast<const SweepConfigMessage*>(msg), baseband_fs);
             break;
 
         default:
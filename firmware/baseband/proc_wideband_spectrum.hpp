@@ -27,6 +27,8 @@
 #include "rssi_thread.hpp"
 
 #include "spectrum_collector.hpp"
+#include "dsp_spectrum.hpp"
+#include "sweep_engine.hpp"
 
 #include "message.hpp"
 
@@ -40,15 +42,36 @@ class WidebandSpectrum : public BasebandProcessor {
     void on_message(const Message* const message) override;
 
    private:
+    static constexpr size_t fft_size = dsp::spectrum::PowerAverager::fft_size;
+
+    static constexpr uint32_t frame_cycles = dsp::spectrum::PowerAverager::frame_cycles;
+
+    /* Share of the 200MHz M4 the frames may use. */
+    static constexpr uint64_t budget_cycles_per_second = 100000000;
+
     bool configured = false;
     size_t baseband_fs = 20000000;
 
+    void configure(const WidebandSpectrumConfigMessage& message);
     void on_beep_message(const AudioBeepMessage& message);
     void on_signal_message(const RequestSignalMessage& message);
 
+    /* Sweep handshake over shared memory, see SharedMemory::sweep_request. */
+    class SharedMemorySweepLink : public SweepLink {
+       public:
+        uint32_t request(const uint16_t step) override;
+        bool tuned(const uint32_t request) const override;
+        bool post(const SweepBatchMessage& message) override;
+    };
+
     SpectrumCollector channel_spectrum{};
+    dsp::spectrum::PowerAverager averager{};
+    SharedMemorySweepLink sweep_link{};
+    SweepEngine sweep{averager, sweep_link};
 
-    std::array<complex16_t, 256> spectrum{};
+    WidebandSpectrumConfigMessage::Detector detector{WidebandSpectrumConfigMessage::Detector::Average};
+    size_t hop = fft_size / 2;
+    uint32_t credit = 0;
     size_t phase = 0, trigger = 127;
 
     /* NB: Threads should be the last members in the class definition. */
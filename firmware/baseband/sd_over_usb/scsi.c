@@ -22,47 +22,50 @@
 
 #include "scsi.h"
 #include "diskio.h"
+#include "scsi_transfer.h"
 #include <libopencm3/lpc43xx/scu.h>
 #include <libopencm3/lpc43xx/rgu.h>
 #include <libopencm3/lpc43xx/wwdt.h>
 
-volatile bool usb_bulk_block_done = false;
+static void usb_bulk_transfer_cb(void* user_data, unsigned int bytes_transferred) {
+    *(volatile bool*)user_data = true;
 
-void usb_bulk_block_cb(void* user_data, unsigned int bytes_transferred) {
-    usb_bulk_block_done = true;
-
-    (void)user_data;
     (void)bytes_transferred;
 }
 
-void usb_send_bulk(void* const data, const uint32_t maximum_length) {
-    usb_bulk_block_done = false;
+void usb_bulk_start_send(uint8_t* const data, const uint32_t length, volatile bool* const done) {
+    *done = false;
 
     usb_transfer_schedule_block(
         &usb_endpoint_bulk_in,
         data,
-        maximum_length,
-        usb_bulk_block_cb,
-        NULL);
-
-    while (!usb_bulk_block_done)
-        ;
+        length,
+        usb_bulk_transfer_cb,
+        (void*)done);
 }
 
-void usb_receive_bulk(void* const data, const uint32_t maximum_length) {
-    usb_bulk_block_done = false;
+void usb_bulk_start_receive(uint8_t* const data, const uint32_t length, volatile bool* const done) {
+    *done = false;
 
     usb_transfer_schedule_block(
         &usb_endpoint_bulk_out,
         data,
-        maximum_length,
-        usb_bulk_block_cb,
-        NULL);
+        length,
+        usb_bulk_transfer_cb,
+        (void*)done);
+}
 
-    while (!usb_bulk_block_done)
+void usb_bulk_wait(volatile bool* const done) {
+    while (!*done)
         ;
 }
 
+void usb_send_bulk(void* const data, const uint32_t maximum_length) {
+    volatile bool done;
+    usb_bulk_start_send(data, maximum_length, &done);
+    usb_bulk_wait(&done);
+}
+
 void usb_send_csw(msd_cbw_t* msd_cbw_data, uint8_t status) {
     msd_csw_t csw = {
         .signature = MSD_CSW_SIGNATURE,
@@ -149,11 +152,12 @@ uint8_t read_capacity10(msd_cbw_t* msd_cbw_data) {
 uint8_t request_sense(msd_cbw_t* msd_cbw_data) {
     (void)msd_cbw_data;
 
+    const scsi_sense_t sense = scsi_transfer_take_sense();
     scsi_sense_response_t ret = {
-        .byte = {0x70, 0, SCSI_SENSE_KEY_GOOD, 0,
+        .byte = {0x70, 0, sense.key, 0,
                  0, 0, 0, 8,
                  0, 0, 0, 0,
-                 SCSI_ASENSE_NO_ADDITIONAL_INFORMATION, SCSI_ASENSEQ_NO_QUALIFIER, 0, 0,
+                 sense.asc, sense.ascq, 0, 0,
                  0, 0}};
 
     memcpy(&usb_bulk_buffer[0], &ret, sizeof(scsi_sense_response_t));
@@ -208,26 +212,19 @@ static data_request_t decode_data_request(const uint8_t* cmd) {
     return req;
 }
 
+/* Data goes through the two halves of the bulk buffer below the CBW. */
+static uint8_t* const data_buffers[2] = {
+    &usb_bulk_buffer[0],
+    &usb_bulk_buffer[SCSI_TRANSFER_BYTES]};
+
 uint8_t data_read10(msd_cbw_t* msd_cbw_data) {
     data_request_t req = decode_data_request(msd_cbw_data->cmd_data);
-
-    for (size_t block_index = 0; block_index < req.blk_cnt; block_index++) {
-        read_block(req.first_lba + block_index, &usb_bulk_buffer[0], 1 /* n blocks */);
-        usb_send_bulk(&usb_bulk_buffer[0], 512);
-    }
-
-    return 0;
+    return scsi_transfer_read(req.first_lba, req.blk_cnt, data_buffers);
 }
 
 uint8_t data_write10(msd_cbw_t* msd_cbw_data) {
     data_request_t req = decode_data_request(msd_cbw_data->cmd_data);
-
-    for (size_t block_index = 0; block_index < req.blk_cnt; block_index++) {
-        usb_receive_bulk(&usb_bulk_buffer[0], 512);
-        write_block(req.first_lba + block_index, &usb_bulk_buffer[0], 1 /* n blocks */);
-    }
-
-    return 0;
+    return scsi_transfer_write(req.first_lba, req.blk_cnt, data_buffers);
 }
 
 void scsi_command(msd_cbw_t* msd_cbw_data) {
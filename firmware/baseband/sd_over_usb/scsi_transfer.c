@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "scsi_transfer.h"
+#include "diskio.h"
+
+static scsi_sense_t sense = {0, 0, 0};
+
+static void set_medium_error(const uint8_t asc) {
+    sense.key = SCSI_TRANSFER_SENSE_KEY_MEDIUM_ERROR;
+    sense.asc = asc;
+    sense.ascq = 0;
+}
+
+scsi_sense_t scsi_transfer_take_sense(void) {
+    const scsi_sense_t taken = sense;
+    sense.key = 0;
+    sense.asc = 0;
+    sense.ascq = 0;
+    return taken;
+}
+
+static uint32_t chunk_blocks(const uint32_t remaining) {
+    return remaining < SCSI_TRANSFER_BLOCKS ? remaining : SCSI_TRANSFER_BLOCKS;
+}
+
+uint8_t scsi_transfer_read(uint32_t first_lba, uint32_t blk_cnt, uint8_t* const buffers[2]) {
+    volatile bool sent = true;
+    uint8_t status = 0;
+    size_t slot = 0;
+
+    while (blk_cnt > 0) {
+        const uint32_t n = chunk_blocks(blk_cnt);
+
+        /* The previous chunk is still going out of the other buffer. */
+        if (read_block(first_lba, buffers[slot], n))
+            status = 1;
+
+        usb_bulk_wait(&sent);
+        usb_bulk_start_send(buffers[slot], n * SCSI_BLOCK_SIZE, &sent);
+
+        first_lba += n;
+        blk_cnt -= n;
+        slot ^= 1;
+    }
+
+    usb_bulk_wait(&sent);
+
+    if (status)
+        set_medium_error(SCSI_TRANSFER_ASENSE_UNRECOVERED_READ_ERROR);
+    return status;
+}
+
+uint8_t scsi_transfer_write(uint32_t first_lba, uint32_t blk_cnt, uint8_t* const buffers[2]) {
+    volatile bool received = true;
+    uint8_t status = 0;
+    size_t slot = 0;
+
+    if (blk_cnt > 0)
+        usb_bulk_start_receive(buffers[slot], chunk_blocks(blk_cnt) * SCSI_BLOCK_SIZE, &received);
+
+    while (blk_cnt > 0) {
+        const uint32_t n = chunk_blocks(blk_cnt);
+        usb_bulk_wait(&received);
+
+        /* Let the next chunk come into the other buffer meanwhile. */
+        if (blk_cnt > n)
+            usb_bulk_start_receive(buffers[slot ^ 1], chunk_blocks(blk_cnt - n) * SCSI_BLOCK_SIZE, &received);
+
+        if (write_block(first_lba, buffers[slot], n))
+            status = 1;
+
+        first_lba += n;
+        blk_cnt -= n;
+        slot ^= 1;
+    }
+
+    if (status)
+        set_medium_error(SCSI_TRANSFER_ASENSE_WRITE_ERROR);
+    return status;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SCSI_TRANSFER_H__
+#define __SCSI_TRANSFER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCSI_BLOCK_SIZE 512
+
+/* Blocks per SD command and per bulk transfer. Two such chunks take turns
+ * in the bulk buffer under the CBW; one SDIO transaction could take twice
+ * as many. */
+#define SCSI_TRANSFER_BLOCKS 16
+#define SCSI_TRANSFER_BYTES (SCSI_TRANSFER_BLOCKS * SCSI_BLOCK_SIZE)
+
+/* MEDIUM ERROR sense a failed chunk leaves for REQUEST SENSE. */
+#define SCSI_TRANSFER_SENSE_KEY_MEDIUM_ERROR 0x03
+#define SCSI_TRANSFER_ASENSE_UNRECOVERED_READ_ERROR 0x11
+#define SCSI_TRANSFER_ASENSE_WRITE_ERROR 0x0C
+
+typedef struct {
+    uint8_t key;
+    uint8_t asc;
+    uint8_t ascq;
+} scsi_sense_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* READ(10)/WRITE(10) data phases. Each chunk is one multi-block SD command
+ * (CMD18/CMD25), run while the bulk endpoint moves the other buffer. The
+ * whole length is always transferred so the host stays in step; the result
+ * is the CSW status, 1 if the card failed any chunk. */
+uint8_t scsi_transfer_read(uint32_t first_lba, uint32_t blk_cnt, uint8_t* const buffers[2]);
+uint8_t scsi_transfer_write(uint32_t first_lba, uint32_t blk_cnt, uint8_t* const buffers[2]);
+
+/* Sense of the last failed command, reset to no sense once taken. */
+scsi_sense_t scsi_transfer_take_sense(void);
+
+/* Bulk endpoint side, in scsi.c. Only one transfer is queued at a time,
+ * *done is cleared when it starts and set once it completes. */
+void usb_bulk_start_send(uint8_t* const data, const uint32_t length, volatile bool* const done);
+void usb_bulk_start_receive(uint8_t* const data, const uint32_t length, volatile bool* const done);
+void usb_bulk_wait(volatile bool* const done);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SCSI_TRANSFER_H__ */
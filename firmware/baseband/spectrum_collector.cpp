@@ -22,6 +22,8 @@
 #include "spectrum_collector.hpp"
 
 #include "dsp_fft.hpp"
+#include "dsp_fft_radix4.hpp"
+#include "dsp_spectrum.hpp"
 
 #include "utility.hpp"
 #include "event_m4.hpp"
@@ -93,13 +95,27 @@ void SpectrumCollector::feed(
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
     // Called from baseband processing thread.
     if (streaming && !channel_spectrum_request_update) {
-        fft_swap(data, channel_spectrum);
+        for (size_t i = 0; i < channel_spectrum.size(); i++) {
+            channel_spectrum[i] = data.p[i];
+        }
         channel_spectrum_sampling_rate = data.sampling_rate;
+        channel_spectrum_is_power = false;
         channel_spectrum_request_update = true;
         EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
     }
 }
 
+void SpectrumCollector::post_power(const uint32_t sampling_rate) {
+    // Called from baseband processing thread, channel_spectrum holds power in its real parts.
+    channel_spectrum_sampling_rate = sampling_rate;
+    channel_filter_low_frequency = 0;
+    channel_filter_high_frequency = 0;
+    channel_filter_transition = 0;
+    channel_spectrum_is_power = true;
+    channel_spectrum_request_update = true;
+    EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
+}
+
 template <typename T>
 static typename T::value_type spectrum_window_none(const T& s, const size_t i) {
     constexpr size_t length = sizeof(s) / sizeof(s[0]);
@@ -132,7 +148,9 @@ void SpectrumCollector::update() {
     // Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
     if (streaming && channel_spectrum_request_update) {
         /* Decimated buffer is full. Compute spectrum. */
-        fft_c_preswapped(channel_spectrum, 0, 8);
+        if (!channel_spectrum_is_power) {
+            dsp::fft::forward(channel_spectrum);
+        }
 
         ChannelSpectrum spectrum;
         spectrum.sampling_rate = channel_spectrum_sampling_rate;
@@ -140,12 +158,16 @@ void SpectrumCollector::update() {
         spectrum.channel_filter_high_frequency = channel_filter_high_frequency;
         spectrum.channel_filter_transition = channel_filter_transition;
         for (size_t i = 0; i < spectrum.db.size(); i++) {
+            if (channel_spectrum_is_power) {
+                spectrum.db[i] = dsp::spectrum::display_level(channel_spectrum[i].real());
+                continue;
+            }
             const auto corrected_sample = spectrum_window_hamming_3(channel_spectrum, i);
-            const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
+            const float mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
             const float db = mag2_to_dbv_norm(mag2);
             constexpr float mag_scale = 5.0f;
-            const unsigned int v = (db * mag_scale) + 255.0f;
-            spectrum.db[i] = std::max(0U, std::min(255U, v));
+            const int32_t v = (db * mag_scale) + 255.0f;
+            spectrum.db[i] = std::max<int32_t>(0, std::min<int32_t>(255, v));
         }
         fifo.in(spectrum);
     }
@@ -47,6 +47,19 @@ class SpectrumCollector {
         const int32_t filter_high_frequency,
         const int32_t filter_transition);
 
+    /* Posts a spectrum the caller already computed, power(bin) relative to
+     * full scale and in natural FFT order. update() skips its FFT. */
+    template <typename PowerFn>
+    void feed_power(const uint32_t sampling_rate, PowerFn power) {
+        // Called from baseband processing thread.
+        if (streaming && !channel_spectrum_request_update) {
+            for (size_t i = 0; i < channel_spectrum.size(); i++) {
+                channel_spectrum[i] = {power(i), 0.0f};
+            }
+            post_power(sampling_rate);
+        }
+    }
+
    private:
     BlockDecimator<complex16_t, 256> channel_spectrum_decimator{1};
     ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k]{};
@@ -54,6 +67,7 @@ class SpectrumCollector {
 
     volatile bool channel_spectrum_request_update{false};
     bool streaming{false};
+    bool channel_spectrum_is_power{false};
     std::array<std::complex<float>, 256> channel_spectrum{};
     uint32_t channel_spectrum_sampling_rate{0};
     int32_t channel_filter_low_frequency{0};
@@ -61,6 +75,7 @@ class SpectrumCollector {
     int32_t channel_filter_transition{0};
 
     void post_message(const buffer_c16_t& data);
+    void post_power(const uint32_t sampling_rate);
 
     void set_state(const SpectrumStreamingConfigMessage& message);
     void start();
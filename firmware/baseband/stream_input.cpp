@@ -55,16 +55,10 @@ size_t StreamInput::write(const void* const data, const size_t length) {
         written += active_buffer->write(&p[written], remaining);
 
         if (active_buffer->is_full()) {
-            if (!fifo_buffers_full.in(active_buffer)) {
-                // FIFO is full of buffers, there's no place for this one.
-                // Bail out of the loop, and try submitting the buffer in the
-                // next pass.
-                // This should never happen if the number of buffers is less
-                // than the capacity of the FIFO.
+            if (!submit_active_buffer()) {
+                // Try submitting the buffer in the next pass.
                 break;
             }
-            active_buffer = nullptr;
-            creg::m4txevent::assert_event();
         }
     }
 
@@ -73,3 +67,36 @@ size_t StreamInput::write(const void* const data, const size_t length) {
 
     return written;
 }
+
+void* StreamInput::acquire(const size_t length) {
+    if (!active_buffer) {
+        if (!fifo_buffers_empty.out(active_buffer))
+            return nullptr;
+    }
+
+    // A block that doesn't fit the rest of the buffer goes through write().
+    if (active_buffer->available() < length)
+        return nullptr;
+
+    return active_buffer->tail();
+}
+
+void StreamInput::commit(const size_t length) {
+    active_buffer->set_size(active_buffer->size() + length);
+    config->baseband_bytes_received += length;
+
+    if (active_buffer->is_full())
+        submit_active_buffer();
+}
+
+bool StreamInput::submit_active_buffer() {
+    if (!fifo_buffers_full.in(active_buffer)) {
+        // FIFO is full of buffers, there's no place for this one.
+        // This should never happen if the number of buffers is less
+        // than the capacity of the FIFO.
+        return false;
+    }
+    active_buffer = nullptr;
+    creg::m4txevent::assert_event();
+    return true;
+}
@@ -41,6 +41,13 @@ class StreamInput {
 
     size_t write(const void* const data, const size_t length);
 
+    /* Zero-copy alternative to write(): returns space for length bytes in
+     * the active buffer to produce samples into, then commit() hands them
+     * over. Returns nullptr if there's no such space, in which case the
+     * caller should fall back to write(), which also accounts for drops. */
+    void* acquire(const size_t length);
+    void commit(const size_t length);
+
    private:
     static constexpr size_t buffer_count_max_log2 = 3;
     static constexpr size_t buffer_count_max = 1U << buffer_count_max_log2;
@@ -53,6 +60,8 @@ class StreamInput {
     StreamBuffer* active_buffer{nullptr};
     CaptureConfig* const config{nullptr};
     std::unique_ptr<uint8_t[]> data{};
+
+    bool submit_active_buffer();
 };
 
 #endif /*__STREAM_INPUT_H__*/
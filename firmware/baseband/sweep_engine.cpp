@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "sweep_engine.hpp"
+
+#include "utility.hpp"
+
+#include <algorithm>
+
+void SweepEngine::configure(const SweepConfigMessage& message, const uint32_t sampling_rate) {
+    first_frequency = message.first_frequency;
+    step_size = message.step;
+    step_count = message.step_count;
+    capture_size = fft_size * std::max<size_t>(1, std::min<size_t>(message.frames_per_step, SweepConfigMessage::max_frames_per_step));
+    settle_samples = static_cast<uint64_t>(sampling_rate) * message.settle_us / 1000000;
+    generation = message.generation;
+
+    averager.clear();
+    captured = 0;
+    transformed = 0;
+    credit = 0;
+
+    // Batches of the previous plan the M0 still holds are dropped by it, as
+    // their messages carry the old generation.
+    for (auto& batch : batches) {
+        batch.count = 0;
+        batch.busy = false;
+    }
+    batch_index = 0;
+    batch_filled = 0;
+    post_pending = false;
+
+    if (active()) {
+        request(0);
+    }
+}
+
+void SweepEngine::request(const uint16_t next_step) {
+    step = next_step;
+    tuned = false;
+    requested = link.request(next_step);
+}
+
+void SweepEngine::execute(const buffer_c8_t& buffer, const uint32_t budget) {
+    if (!active()) return;
+
+    credit = std::min(credit + budget, budget + frame_cycles);
+
+    if (post_pending) {
+        post();
+    }
+
+    if (!tuned && link.tuned(requested)) {
+        // This buffer may still hold samples from before the retune.
+        tuned = true;
+        skip = buffer.count + settle_samples;
+    }
+
+    if (tuned) {
+        capture(buffer);
+    }
+
+    transform();
+}
+
+void SweepEngine::capture(const buffer_c8_t& buffer) {
+    const size_t skipped = std::min(skip, buffer.count);
+    skip -= skipped;
+    if (skip) return;
+
+    // The store is free once the previous step is published, and this
+    // step needs room in a batch the M0 isn't reading.
+    if (captured == capture_size || batches[batch_index].busy || batch_filled == SweepBatch::max_spectra) return;
+
+    const size_t n = std::min(capture_size - captured, buffer.count - skipped);
+    std::copy_n(&buffer.p[skipped], n, &store[captured]);
+    captured += n;
+
+    if (captured == capture_size) {
+        captured_step = step;
+        transformed = 0;
+        request((step + 1 == step_count) ? 0 : step + 1);
+    }
+}
+
+void SweepEngine::transform() {
+    while (captured == capture_size && transformed < captured && credit >= frame_cycles) {
+        averager.accumulate(&store[transformed]);
+        transformed += fft_size;
+        credit -= frame_cycles;
+    }
+
+    if (captured == capture_size && transformed == captured) {
+        publish();
+        captured = 0;
+        transformed = 0;
+    }
+}
+
+void SweepEngine::publish() {
+    auto& spectrum = batches[batch_index].spectra[batch_filled++];
+    spectrum.center_frequency = first_frequency + static_cast<int64_t>(captured_step) * step_size;
+    spectrum.step = captured_step;
+
+    // Same scale as WidebandSpectrum.
+    for (size_t i = 0; i < spectrum.db.size(); i++) {
+        spectrum.db[i] = dsp::spectrum::display_level(averager.power(i, dsp::spectrum::PowerAverager::Detector::Average));
+    }
+    averager.clear();
+
+    // Flush at the end of each pass too, so the last slices aren't held back.
+    if (batch_filled == SweepBatch::max_spectra || captured_step + 1 == step_count) {
+        post();
+    }
+}
+
+void SweepEngine::post() {
+    auto& batch = batches[batch_index];
+    batch.count = batch_filled;
+
+    // Marked before the push, the M0 may be done with it before push returns.
+    batch.busy = true;
+    const SweepBatchMessage message{&batch, generation};
+    post_pending = !link.post(message);
+    if (post_pending) {
+        batch.busy = false;
+        return;
+    }
+
+    batch_index ^= 1;
+    batch_filled = 0;
+}
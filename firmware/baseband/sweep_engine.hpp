@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SWEEP_ENGINE_H__
+#define __SWEEP_ENGINE_H__
+
+#include "dsp_types.hpp"
+#include "dsp_spectrum.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* The engine's end of the handshake with the M0, kept apart so the engine
+ * can be driven off the target. */
+class SweepLink {
+   public:
+    virtual ~SweepLink() = default;
+
+    /* Asks the M0 to tune a step, returns the request's number. */
+    virtual uint32_t request(const uint16_t step) = 0;
+
+    /* True once the M0 is tuned for the request. */
+    virtual bool tuned(const uint32_t request) const = 0;
+
+    /* False when the application queue is full. */
+    virtual bool post(const SweepBatchMessage& message) = 0;
+};
+
+/* Steps through a SweepConfigMessage plan without waiting on the M0 UI.
+ * Once a step's frames are captured the next step is requested right away,
+ * so they are transformed while the M0 retunes and the synthesizers settle.
+ * Spectra go back in SweepBatch pairs: the M4 fills one while the M0 reads
+ * the other, and the sweep holds off when both are in use. A batch that
+ * can't be posted is kept and posted again on the next buffer.
+ */
+class SweepEngine {
+   public:
+    SweepEngine(dsp::spectrum::PowerAverager& averager, SweepLink& link)
+        : averager{averager},
+          link{link} {
+    }
+
+    void configure(const SweepConfigMessage& message, const uint32_t sampling_rate);
+
+    bool active() const { return step_count != 0; }
+
+    /* budget is the M4 cycles this buffer may spend on frames. */
+    void execute(const buffer_c8_t& buffer, const uint32_t budget);
+
+   private:
+    static constexpr size_t fft_size = dsp::spectrum::PowerAverager::fft_size;
+    static constexpr uint32_t frame_cycles = dsp::spectrum::PowerAverager::frame_cycles;
+
+    dsp::spectrum::PowerAverager& averager;
+    SweepLink& link;
+
+    int64_t first_frequency{0};
+    uint32_t step_size{0};
+    uint16_t step_count{0};
+    size_t capture_size{fft_size};
+    size_t settle_samples{0};
+    uint32_t generation{0};
+
+    uint16_t step{0};
+    uint32_t requested{0};
+    bool tuned{false};
+    size_t skip{0};
+
+    std::array<complex8_t, fft_size * SweepConfigMessage::max_frames_per_step> store{};
+    size_t captured{0};
+    size_t transformed{0};
+    uint16_t captured_step{0};
+    uint32_t credit{0};
+
+    std::array<SweepBatch, 2> batches{};
+    size_t batch_index{0};
+    size_t batch_filled{0};
+    bool post_pending{false};
+
+    void request(const uint16_t next_step);
+    void capture(const buffer_c8_t& buffer);
+    void transform();
+    void publish();
+    void post();
+};
+
+#endif /*__SWEEP_ENGINE_H__*/
@@ -22,6 +22,128 @@
 
 #include "adsb_frame.hpp"
 
+#include <array>
+
 namespace adsb {
 
+namespace {
+
+constexpr uint32_t crc_poly = 0xFFF409;  // x^24 term implied
+constexpr size_t frame_bits_max = ADSBFrame::long_length * 8;
+constexpr size_t df_bits = 5;
+
+constexpr std::array<uint32_t, 256> make_crc_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i << 16;
+        for (size_t b = 0; b < 8; b++)
+            c = (c & 0x800000) ? ((c << 1) ^ crc_poly) : (c << 1);
+        table[i] = c & 0xFFFFFF;
+    }
+    return table;
+}
+
+constexpr auto crc_table = make_crc_table();
+
+constexpr uint32_t crc24_constexpr(const uint8_t* data, const size_t length) {
+    uint32_t c = 0;
+    for (size_t i = 0; i < length; i++)
+        c = ((c << 8) & 0xFFFFFF) ^ crc_table[((c >> 16) ^ data[i]) & 0xFF];
+    return c;
+}
+
+/* Syndrome of a single flipped bit for every bit position of a 112 bit frame,
+ * packed as (syndrome << 8) | position and sorted so it can be searched.
+ * A 56 bit frame behaves like the last 56 bits of a 112 bit one. */
+constexpr std::array<uint32_t, frame_bits_max> make_syndrome_table() {
+    std::array<uint32_t, frame_bits_max> table{};
+    for (size_t bit = 0; bit < frame_bits_max; bit++) {
+        uint8_t frame[ADSBFrame::long_length]{};
+        frame[bit >> 3] = 0x80 >> (bit & 7);
+
+        const auto n = ADSBFrame::long_length;
+        const uint32_t parity = (frame[n - 3] << 16) | (frame[n - 2] << 8) | frame[n - 1];
+        table[bit] = ((crc24_constexpr(frame, n - 3) ^ parity) << 8) | bit;
+    }
+
+    // Insertion sort, constexpr friendly and only run at compile time.
+    for (size_t i = 1; i < table.size(); i++) {
+        const auto v = table[i];
+        size_t j = i;
+        for (; j > 0 && table[j - 1] > v; j--)
+            table[j] = table[j - 1];
+        table[j] = v;
+    }
+    return table;
+}
+
+constexpr auto syndrome_table = make_syndrome_table();
+
+/* Returns the bit position with this single bit syndrome, or -1. */
+int find_syndrome(const uint32_t syndrome) {
+    size_t first = 0;
+    size_t last = syndrome_table.size();
+    while (first < last) {
+        const size_t middle = (first + last) / 2;
+        const uint32_t s = syndrome_table[middle] >> 8;
+        if (s == syndrome)
+            return syndrome_table[middle] & 0xFF;
+        else if (s < syndrome)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return -1;
+}
+
+void flip_bit(uint8_t* data, const size_t bit) {
+    data[bit >> 3] ^= 0x80 >> (bit & 7);
+}
+
+} /* namespace */
+
+uint32_t crc24(const uint8_t* data, const size_t length) {
+    return crc24_constexpr(data, length);
+}
+
+uint32_t crc_syndrome(const uint8_t* data, const size_t length) {
+    const uint32_t parity = (data[length - 3] << 16) | (data[length - 2] << 8) | data[length - 1];
+    return crc24(data, length - 3) ^ parity;
+}
+
+int correct_bit_errors(uint8_t* data, const size_t length, const size_t max_bit_errors) {
+    const uint32_t syndrome = crc_syndrome(data, length);
+    if (syndrome == 0)
+        return 0;
+
+    // Table positions of the first bit of this frame, and of the first bit past the DF field.
+    const int offset = frame_bits_max - (length * 8);
+    const int first_bit = offset + df_bits;
+
+    const int bit = find_syndrome(syndrome);
+    if (bit >= first_bit) {
+        flip_bit(data, bit - offset);
+        return 1;
+    }
+
+    if (max_bit_errors < 2)
+        return -1;
+
+    // Two errors: the syndrome is the XOR of both single bit syndromes.
+    for (const auto entry : syndrome_table) {
+        const int bit1 = entry & 0xFF;
+        if (bit1 < first_bit)
+            continue;
+
+        const int bit2 = find_syndrome(syndrome ^ (entry >> 8));
+        if (bit2 > bit1) {
+            flip_bit(data, bit1 - offset);
+            flip_bit(data, bit2 - offset);
+            return 2;
+        }
+    }
+
+    return -1;
+}
+
 } /* namespace adsb */
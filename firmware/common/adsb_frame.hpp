@@ -25,15 +25,40 @@
 
 #include <cstring>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 
 namespace adsb {
 
+/* Mode S CRC-24 (generator 0x1FFF409) over length bytes. */
+uint32_t crc24(const uint8_t* data, const size_t length);
+
+/* CRC of the first length - 3 bytes XORed with the parity in the last 3,
+ * zero for an intact frame with no address/interrogator overlay. */
+uint32_t crc_syndrome(const uint8_t* data, const size_t length);
+
+/* Flips up to max_bit_errors bits (1 or 2) so that the syndrome becomes zero.
+ * The DF field is never touched since it decides the frame length.
+ * Returns the number of bits corrected, or -1 if the frame can't be fixed. */
+int correct_bit_errors(uint8_t* data, const size_t length, const size_t max_bit_errors);
+
 alignas(4) const uint8_t adsb_preamble[16] = {1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0};
 alignas(4) const char icao_id_lut[65] = "#ABCDEFGHIJKLMNOPQRSTUVWXYZ##### ###############0123456789######";
 
 class ADSBFrame {
    public:
+    static constexpr size_t short_length = 7;  // 56 bits, DF0-DF15
+    static constexpr size_t long_length = 14;  // 112 bits, DF16-DF24
+
+    /* Frame length in bytes implied by the downlink format. */
+    static constexpr size_t length_for_DF(const uint8_t df) {
+        return (df & 0x10) ? long_length : short_length;
+    }
+
+    size_t length() const {
+        return length_for_DF(raw_data[0] >> 3);
+    }
+
     uint8_t get_DF() {
         return (raw_data[0] >> 3);
     }
@@ -78,22 +103,24 @@ class ADSBFrame {
     }
 
     void make_CRC() {
-        uint32_t computed_CRC = compute_CRC();
+        const size_t n = length();
+        uint32_t computed_CRC = crc24(raw_data, n - 3);
 
         // Insert CRC in frame
-        raw_data[11] = (computed_CRC >> 16) & 0xFF;
-        raw_data[12] = (computed_CRC >> 8) & 0xFF;
-        raw_data[13] = computed_CRC & 0xFF;
+        raw_data[n - 3] = (computed_CRC >> 16) & 0xFF;
+        raw_data[n - 2] = (computed_CRC >> 8) & 0xFF;
+        raw_data[n - 1] = computed_CRC & 0xFF;
     }
 
     bool check_CRC() {
-        uint32_t computed_CRC = compute_CRC();
-
-        if ((raw_data[11] != ((computed_CRC >> 16) & 0xFF)) ||
-            (raw_data[12] != ((computed_CRC >> 8) & 0xFF)) ||
-            (raw_data[13] != (computed_CRC & 0xFF))) return false;
+        return crc_syndrome(raw_data, length()) == 0;
+    }
 
-        return true;
+    /* Repairs single bit errors, and double bit errors in 112 bit frames
+     * where the CRC leaves enough margin. Returns true if the CRC now checks. */
+    bool correct_errors() {
+        const size_t n = length();
+        return correct_bit_errors(raw_data, n, (n == long_length) ? 2 : 1) >= 0;
     }
 
     bool empty() {
@@ -106,29 +133,6 @@ class ADSBFrame {
     alignas(4) uint8_t index{0};
     alignas(4) uint8_t raw_data[14]{};  // 112 bits at most
     uint32_t rx_timestamp{};
-
-    uint32_t compute_CRC() {
-        uint8_t adsb_crc[14] = {0};  // Temp buffer
-        uint8_t b, c, s, bitn;
-        const uint32_t crc_poly = 0x1205FFF;
-
-        // Copy frame data
-        memcpy(adsb_crc, raw_data, 11);
-
-        // Compute CRC
-        for (c = 0; c < 11; c++) {
-            for (b = 0; b < 8; b++) {
-                if ((adsb_crc[c] << b) & 0x80) {
-                    for (s = 0; s < 25; s++) {
-                        bitn = (c * 8) + b + s;
-                        if ((crc_poly >> s) & 1) adsb_crc[bitn >> 3] ^= (0x80 >> (bitn & 7));
-                    }
-                }
-            }
-        }
-
-        return (adsb_crc[11] << 16) + (adsb_crc[12] << 8) + adsb_crc[13];
-    }
 };
 
 } /* namespace adsb */
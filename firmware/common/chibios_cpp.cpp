@@ -25,26 +25,53 @@
 
 #include <ch.h>
 
-void* operator new(size_t size) {
+static size_t heap_allocated_bytes = 0;
+static size_t heap_high_water_bytes = 0;
+
+/* Size of the block as recorded by the heap, rounded up from the request. */
+static size_t heap_block_size(void* p) {
+    return (reinterpret_cast<union heap_header*>(p) - 1)->h.size;
+}
+
+static void* heap_alloc(size_t size) {
     void* p = chHeapAlloc(0x0, size);
     if (p == nullptr)
         chDbgPanic("Out of Memory");
+
+    chSysLock();
+    heap_allocated_bytes += heap_block_size(p);
+    if (heap_allocated_bytes > heap_high_water_bytes)
+        heap_high_water_bytes = heap_allocated_bytes;
+    chSysUnlock();
+
     return p;
 }
 
-void* operator new[](size_t size) {
-    void* p = chHeapAlloc(0x0, size);
+static void heap_free(void* p) {
     if (p == nullptr)
-        chDbgPanic("Out of Memory");
-    return p;
+        return;
+
+    chSysLock();
+    heap_allocated_bytes -= heap_block_size(p);
+    chSysUnlock();
+
+    chHeapFree(p);
+}
+
+void* operator new(size_t size) {
+    return heap_alloc(size);
+}
+
+void* operator new[](size_t size) {
+    return heap_alloc(size);
 }
 
 void operator delete(void* p) noexcept {
-    chHeapFree(p);
+    heap_free(p);
 }
 
 void operator delete[](void* p) noexcept {
-    chHeapFree(p);
+    heap_free(p);
 }
 
 void operator delete(void* ptr, std::size_t) noexcept {
@@ -66,9 +93,23 @@ size_t heap_size() {
 
 size_t heap_used() {
     const auto core_free = chCoreStatus();
-    size_t heap_free = 0;
-    chHeapStatus(NULL, &heap_free);
-    return heap_size() - (core_free + heap_free);
+    size_t pool_free = 0;
+    chHeapStatus(NULL, &pool_free);
+    return heap_size() - (core_free + pool_free);
+}
+
+size_t heap_allocated() {
+    return heap_allocated_bytes;
+}
+
+size_t heap_high_water() {
+    return heap_high_water_bytes;
+}
+
+void heap_reset_high_water() {
+    chSysLock();
+    heap_high_water_bytes = heap_allocated_bytes;
+    chSysUnlock();
 }
 
 } /* namespace chibios */
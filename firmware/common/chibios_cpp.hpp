@@ -38,6 +38,12 @@ namespace chibios {
 size_t heap_size();
 size_t heap_used();
 
+/* Bytes currently allocated through operator new, and the peak of that
+ * since boot or since the last reset. */
+size_t heap_allocated();
+size_t heap_high_water();
+void heap_reset_high_water();
+
 } /* namespace chibios */
 
 #endif /*__CHIBIOS_CPP_H__*/
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __CYCLE_PROFILE_H__
+#define __CYCLE_PROFILE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Cycle counts of the M4 processing stages, measured with the DWT cycle
+ * counter and kept in shared memory for the M0. The M4 is the only writer,
+ * the M0 requests changes through the enabled and reset_requested flags.
+ */
+namespace cycle_profile {
+
+enum class Scope : uint8_t {
+    Buffer = 0, /* All of BasebandProcessor::execute() */
+    Decimate,
+    Demodulate,
+    Audio,
+    Spectrum,
+    Messages,
+    Count
+};
+
+constexpr size_t scope_count = static_cast<size_t>(Scope::Count);
+
+constexpr std::array<const char*, scope_count> scope_names{{
+    "buffer",
+    "decim",
+    "demod",
+    "audio",
+    "spectrum",
+    "messages",
+}};
+
+/* Bins are eighths of the per-buffer cycle budget, the last one counts
+ * runs over budget. */
+constexpr size_t budget_bins = 8;
+constexpr size_t histogram_bins = budget_bins + 1;
+
+struct ScopeStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    std::array<uint32_t, histogram_bins> histogram;
+
+    uint32_t average() const {
+        return count ? (total / count) : 0;
+    }
+};
+
+struct Profile {
+    volatile bool enabled;
+    volatile bool reset_requested;
+
+    /* Incremented before and after each update by the M4, odd meanwhile. */
+    volatile uint32_t sequence;
+
+    /* Cycles available per baseband buffer at the current sampling rate. */
+    uint32_t budget_cycles;
+    std::array<ScopeStats, scope_count> scopes;
+};
+
+/* Copies a consistent view of the profile, retrying while the M4 writes. */
+inline bool snapshot(const Profile& profile, Profile& copy) {
+    for (size_t attempt = 0; attempt < 8; attempt++) {
+        const uint32_t sequence = profile.sequence;
+        if (sequence & 1) {
+            continue;
+        }
+        __asm__ volatile("" ::: "memory");
+        copy.budget_cycles = profile.budget_cycles;
+        copy.scopes = profile.scopes;
+        __asm__ volatile("" ::: "memory");
+        if (profile.sequence == sequence) {
+            copy.enabled = profile.enabled;
+            return true;
+        }
+    }
+    return false;
+}
+
+} /* namespace cycle_profile */
+
+#endif /*__CYCLE_PROFILE_H__*/
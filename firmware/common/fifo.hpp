@@ -27,9 +27,18 @@
 #include <cstring>
 #include <memory>
 
+#if !defined(__arm__)
+#include <atomic>
+#endif
+
 #include <hal.h>
 
-/* FIFO implementation inspired by Linux kfifo. */
+/* FIFO implementation inspired by Linux kfifo.
+ *
+ * Safe without locking for one writer and one reader, which may be on
+ * different cores: the writer only advances _in and the reader only
+ * advances _out, with barriers ordering the data against the indices.
+ */
 
 template <typename T>
 class FIFO {
@@ -105,6 +114,22 @@ class FIFO {
         return len;
     }
 
+    /* As in_r(), for a reader that sleeps while the FIFO is empty. Sets wake
+     * if the reader had already consumed everything before this record, so
+     * it may have seen the FIFO empty and needs a wakeup. Records written
+     * while the reader is still busy don't; it drains until empty anyway.
+     */
+    size_t in_r(const void* const buf, const size_t len, bool& wake) {
+        const size_t start = _in;
+        const size_t result = in_r(buf, len);
+
+        // Order the _in store against the _out load, pairing with the
+        // barrier after the reader advances _out.
+        smp_mb();
+        wake = (result != 0) && (_out == start);
+        return result;
+    }
+
     bool out(T& val) {
         if (is_empty()) {
             return false;
@@ -128,8 +153,10 @@ class FIFO {
             return false;
         }
 
+        smp_rmb();
         size_t len = peek_n();
         _out += len + recsize();
+        smp_mb();
         return true;
     }
 
@@ -137,6 +164,7 @@ class FIFO {
         if (is_empty()) {
             return 0;
         }
+        smp_rmb();
 
         size_t n;
         len = out_copy_r((T*)buf, len, &n);
@@ -147,10 +175,12 @@ class FIFO {
         if (is_empty()) {
             return 0;
         }
+        smp_rmb();
 
         size_t n;
         len = out_copy_r((T*)buf, len, &n);
         _out += n + recsize();
+        smp_mb();
         return len;
     }
 
@@ -171,8 +201,20 @@ class FIFO {
         return 2;
     }
 
-    void smp_wmb() {
+    static void smp_mb() {
+#if defined(__arm__)
         __DMB();
+#else
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    static void smp_wmb() {
+        smp_mb();
+    }
+
+    static void smp_rmb() {
+        smp_mb();
     }
 
     size_t peek_n() {
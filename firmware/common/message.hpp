@@ -126,6 +126,12 @@ class Message {
         BatteryStateData = 68,
         ProtoViewData = 69,
         FreqChangeCommand = 70,
+        PacketBatch = 71,
+        MultiChannelStatistics = 72,
+        ChannelizerConfig = 73,
+        SweepConfig = 74,
+        SweepBatch = 75,
+        BTLERxStatistics = 76,
         MAX
     };
 
@@ -177,12 +183,15 @@ class BasebandStatisticsMessage : public Message {
 struct ChannelStatistics {
     int32_t max_db;
     size_t count;
+    uint32_t epoch;  // SharedMemory::retune_epoch the samples were taken after.
 
     constexpr ChannelStatistics(
         int32_t max_db = -120,
-        size_t count = 0)
+        size_t count = 0,
+        uint32_t epoch = 0)
         : max_db{max_db},
-          count{count} {
+          count{count},
+          epoch{epoch} {
     }
 };
 
@@ -197,6 +206,50 @@ class ChannelStatisticsMessage : public Message {
     ChannelStatistics statistics;
 };
 
+/* Levels of the channels measured at once around one tune, see
+ * ChannelBankCollector and SharedMemory::retune_channel_offsets. */
+struct MultiChannelStatistics {
+    static constexpr size_t max_channels = 16;
+
+    std::array<int16_t, max_channels> max_db{};
+    size_t channel_count{0};
+    size_t count{0};
+    uint32_t epoch{0};
+};
+
+class MultiChannelStatisticsMessage : public Message {
+   public:
+    constexpr MultiChannelStatisticsMessage(
+        const MultiChannelStatistics& statistics)
+        : Message{ID::MultiChannelStatistics},
+          statistics{statistics} {
+    }
+
+    MultiChannelStatistics statistics;
+};
+
+/* Channel numbers are PolyphaseChannelizer indexes: channel c is centered
+ * on c * sampling_rate / 256 from the tuned frequency + sampling_rate / 4,
+ * with c >= 32 being below it. */
+class ChannelizerConfigMessage : public Message {
+   public:
+    static constexpr size_t max_selected = MultiChannelStatistics::max_channels;
+
+    constexpr ChannelizerConfigMessage(
+        const uint32_t sampling_rate,
+        const std::array<uint8_t, max_selected>& selected,
+        const size_t selected_count)
+        : Message{ID::ChannelizerConfig},
+          sampling_rate{sampling_rate},
+          selected{selected},
+          selected_count{selected_count} {
+    }
+
+    uint32_t sampling_rate;  // Decimated by 4 by the FS/4 front end
+    std::array<uint8_t, max_selected> selected;
+    size_t selected_count;  // Channels reported and streamed to the capture path
+};
+
 class DisplayFrameSyncMessage : public Message {
    public:
     constexpr DisplayFrameSyncMessage()
@@ -268,16 +321,36 @@ class SpectrumStreamingConfigMessage : public Message {
 
 class WidebandSpectrumConfigMessage : public Message {
    public:
+    enum class Window : uint8_t {
+        Rectangular = 0,
+        Hann = 1,
+        BlackmanHarris = 2,
+    };
+
+    enum class Detector : uint8_t {
+        Average = 0,
+        Peak = 1,
+    };
+
     constexpr WidebandSpectrumConfigMessage(
         size_t sampling_rate,
-        size_t trigger)
+        size_t trigger,
+        Window window = Window::Hann,
+        uint8_t overlap_log2 = 1,
+        Detector detector = Detector::Average)
         : Message{ID::WidebandSpectrumConfig},
           sampling_rate{sampling_rate},
-          trigger{trigger} {
+          trigger{trigger},
+          window{window},
+          overlap_log2{overlap_log2},
+          detector{detector} {
     }
 
     size_t sampling_rate{0};
-    size_t trigger{0};
+    size_t trigger{0};  // A spectrum is sent every trigger + 1 buffers.
+    Window window{Window::Hann};
+    uint8_t overlap_log2{1};  // Frames overlap by 1 - 1 / 2^overlap_log2, up to 2.
+    Detector detector{Detector::Average};
 };
 
 struct AudioSpectrum {
@@ -319,6 +392,135 @@ class ChannelSpectrumConfigMessage : public Message {
     ChannelSpectrumFIFO* fifo{nullptr};
 };
 
+/* Frequency plan of the WidebandSpectrum sweep mode. The M4 asks the M0 for
+ * each step through shared memory, drops settle_us after every retune and
+ * averages frames_per_step frames per step. A step_count of 0 stops it. */
+class SweepConfigMessage : public Message {
+   public:
+    static constexpr size_t max_frames_per_step = 4;
+
+    constexpr SweepConfigMessage(
+        const int64_t first_frequency,
+        const uint32_t step,
+        const uint16_t step_count,
+        const uint8_t frames_per_step,
+        const uint16_t settle_us,
+        const uint32_t generation)
+        : Message{ID::SweepConfig},
+          first_frequency{first_frequency},
+          step{step},
+          step_count{step_count},
+          frames_per_step{frames_per_step},
+          settle_us{settle_us},
+          generation{generation} {
+    }
+
+    int64_t first_frequency;  // Center of step 0
+    uint32_t step;
+    uint16_t step_count;
+    uint8_t frames_per_step;
+    uint16_t settle_us;
+    uint32_t generation;  // Echoed in the SweepBatchMessages of this plan
+};
+
+struct SweepSpectrum {
+    int64_t center_frequency;
+    uint16_t step;
+    std::array<uint8_t, 256> db;  // Same scale and bin order as ChannelSpectrum
+};
+
+struct SweepBatch {
+    static constexpr size_t max_spectra = 4;
+
+    std::array<SweepSpectrum, max_spectra> spectra;
+    size_t count;
+
+    // Set by the M4 when posted, cleared by the M0 once it is done with it.
+    volatile bool busy;
+};
+
+class SweepBatchMessage : public Message {
+   public:
+    constexpr SweepBatchMessage(
+        SweepBatch* const batch,
+        const uint32_t generation)
+        : Message{ID::SweepBatch},
+          batch{batch},
+          generation{generation} {
+    }
+
+    SweepBatch* const batch;
+
+    /* Of the SweepConfigMessage the batch was swept for. Batches of an
+     * earlier plan may already be reused by the M4 and must not be touched. */
+    const uint32_t generation;
+};
+
+/* Several packet messages from a decoder in one queue record, so bursts take
+ * one push and one M0 wakeup. Each entry is a complete message (e.g. an
+ * ADSBFrameMessage) with the M4 time it was decoded. The M0 dispatcher
+ * unpacks the entries, so handlers still see the individual messages.
+ */
+class PacketBatchMessage : public Message {
+   public:
+    struct Entry {
+        uint32_t timestamp;  // M4 system time, ticks
+        uint16_t size;       // Size of the message that follows
+        uint16_t reserved;
+    };
+
+    /* Entries are padded to keep messages 8 byte aligned. */
+    static constexpr size_t entry_size(const size_t message_size) {
+        return (sizeof(Entry) + message_size + 7) & ~size_t(7);
+    }
+
+    PacketBatchMessage()
+        : Message{ID::PacketBatch} {
+    }
+
+    bool append(const Message& message, const size_t size, const uint32_t timestamp) {
+        const size_t needed = entry_size(size);
+        if ((used + needed) > sizeof(data)) {
+            return false;
+        }
+
+        const Entry entry{timestamp, static_cast<uint16_t>(size), 0};
+        memcpy(&data[used], &entry, sizeof(entry));
+        memcpy(&data[used + sizeof(entry)], &message, size);
+        used += needed;
+        count++;
+        return true;
+    }
+
+    template <typename Fn>
+    void for_each(Fn fn) {
+        size_t offset = 0;
+        for (size_t i = 0; i < count; i++) {
+            const auto entry = reinterpret_cast<const Entry*>(&data[offset]);
+            fn(reinterpret_cast<Message*>(&data[offset + sizeof(Entry)]), entry->timestamp);
+            offset += entry_size(entry->size);
+        }
+    }
+
+    void clear() {
+        count = 0;
+        used = 0;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    /* Bytes to push, leaving out the unused tail. */
+    size_t size() const {
+        return sizeof(*this) - sizeof(data) + used;
+    }
+
+    uint16_t count{0};
+    uint16_t used{0};
+    alignas(8) uint8_t data[MAX_SIZE - 8];
+};
+
 class AISPacketMessage : public Message {
    public:
     constexpr AISPacketMessage(
@@ -443,17 +645,37 @@ struct BlePacketData {
     uint8_t macAddress[6];
     uint8_t data[40];
     uint8_t dataLen;
+    uint8_t channel;  // Received on
 };
 
 class BLEPacketMessage : public Message {
    public:
     constexpr BLEPacketMessage(
-        BlePacketData* packet)
+        const BlePacketData& packet)
         : Message{ID::BlePacket},
           packet{packet} {
     }
 
-    BlePacketData* packet{nullptr};
+    BlePacketData packet;
+};
+
+/* From the BLE RX baseband about twice a second and before it changes
+ * channel, counts since the previous one. */
+class BTLERxStatisticsMessage : public Message {
+   public:
+    constexpr BTLERxStatisticsMessage(
+        const uint8_t channel,
+        const uint32_t packets,
+        const uint32_t crc_errors)
+        : Message{ID::BTLERxStatistics},
+          channel{channel},
+          packets{packets},
+          crc_errors{crc_errors} {
+    }
+
+    uint8_t channel;
+    uint32_t packets;     // With a good CRC
+    uint32_t crc_errors;  // Sane header but a bad CRC
 };
 
 class CodedSquelchMessage : public Message {
@@ -660,6 +882,15 @@ class StreamBuffer {
         return capacity_;
     }
 
+    /* Free space after the data written so far, for filling in place. */
+    void* tail() const {
+        return &data_[used_];
+    }
+
+    size_t available() const {
+        return capacity_ - used_;
+    }
+
     void set_size(const size_t value) {
         used_ = value;
     }
@@ -693,7 +924,7 @@ struct CaptureConfig {
             return 0;
         } else {
             const size_t percent = baseband_bytes_dropped * 100U / baseband_bytes_received;
-            return std::max(1U, percent);
+            return std::max<size_t>(1, percent);
         }
     }
 };
@@ -943,7 +1174,9 @@ class AudioTXConfigMessage : public Message {
         const bool am_enabled,
         const bool dsb_enabled,
         const bool usb_enabled,
-        const bool lsb_enabled)
+        const bool lsb_enabled,
+        const uint8_t channels = 1,
+        const bool interpolate = false)
         : Message{ID::AudioTXConfig},
           divider(divider),
           deviation_hz(deviation_hz),
@@ -955,7 +1188,9 @@ class AudioTXConfigMessage : public Message {
           am_enabled(am_enabled),
           dsb_enabled(dsb_enabled),
           usb_enabled(usb_enabled),
-          lsb_enabled(lsb_enabled) {
+          lsb_enabled(lsb_enabled),
+          channels(channels),
+          interpolate(interpolate) {
     }
 
     const uint32_t divider;
@@ -969,6 +1204,8 @@ class AudioTXConfigMessage : public Message {
     const bool dsb_enabled;
     const bool usb_enabled;
     const bool lsb_enabled;
+    const uint8_t channels;  // Interleaved channels in the stream, mixed to mono
+    const bool interpolate;  // Polyphase filter instead of a zero-order hold
 };
 
 class SigGenConfigMessage : public Message {
@@ -24,6 +24,20 @@
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+void MessageQueue::begin_write() {
+    chSysLock();
+}
+
+void MessageQueue::end_write() {
+    chSysUnlock();
+}
+
+void MessageQueue::wait_empty() {
+    while (!is_empty()) {
+        chThdSleepMilliseconds(1);
+    }
+}
+
 #if defined(LPC43XX_M0)
 void MessageQueue::signal() {
     creg::m0apptxevent::assert_event();
@@ -39,7 +39,6 @@ class MessageQueue {
         uint8_t* const data,
         size_t k)
         : fifo{data, k} {
-        chMtxInit(&mutex_write);
     }
 
     template <typename T>
@@ -47,23 +46,30 @@ class MessageQueue {
         static_assert(sizeof(T) <= Message::MAX_SIZE, "Message::MAX_SIZE too small for message type");
         static_assert(std::is_base_of<Message, T>::value, "type is not based on Message");
 
-        return push(&message, sizeof(message));
+        return push_bytes(&message, sizeof(message));
+    }
+
+    /* Pushes the first length bytes of a message with a variable size tail. */
+    template <typename T>
+    bool push(const T& message, const size_t length) {
+        static_assert(sizeof(T) <= Message::MAX_SIZE, "Message::MAX_SIZE too small for message type");
+        static_assert(std::is_base_of<Message, T>::value, "type is not based on Message");
+
+        return push_bytes(&message, std::min(length, sizeof(message)));
     }
 
     template <typename T>
     bool push_and_wait(const T& message) {
         const bool result = push(message);
         if (result) {
-            // TODO: More graceful method of waiting for empty? Maybe sleep for a bit?
-            while (!is_empty())
-                ;
+            wait_empty();
         }
         return result;
     }
 
     template <typename HandlerFn>
     void handle(HandlerFn handler) {
-        std::array<uint8_t, Message::MAX_SIZE> message_buffer;
+        alignas(8) std::array<uint8_t, Message::MAX_SIZE> message_buffer;
         while (Message* const message = peek(message_buffer)) {
             handler(message);
             skip();
@@ -80,7 +86,6 @@ class MessageQueue {
 
    private:
     FIFO<uint8_t> fifo;
-    Mutex mutex_write{};
 
     Message* peek(std::array<uint8_t, Message::MAX_SIZE>& buf) {
         Message* const p = reinterpret_cast<Message*>(buf.data());
@@ -100,19 +105,27 @@ class MessageQueue {
         return fifo.len();
     }
 
-    bool push(const void* const buf, const size_t len) {
-        chMtxLock(&mutex_write);
-        const auto result = fifo.in_r(buf, len);
-        chMtxUnlock();
-
-        const bool success = (result == len);
-        if (success) {
+    /* Each queue has its writers on one core and its reader on the other (or
+     * the same) core. The writers are serialised with a short critical section
+     * on their own core; the reader never blocks them. Only a record the
+     * reader may have missed raises the event, so bursts cost one wakeup.
+     */
+    bool push_bytes(const void* const buf, const size_t len) {
+        bool wake;
+        begin_write();
+        const auto result = fifo.in_r(buf, len, wake);
+        end_write();
+
+        if (wake) {
             signal();
         }
-        return success;
+        return (result == len);
     }
 
+    void begin_write();
+    void end_write();
     void signal();
+    void wait_empty();
 };
 
 #endif /*__MESSAGE_QUEUE_H__*/
@@ -27,6 +27,7 @@
 #include <cstddef>
 
 #include "message_queue.hpp"
+#include "cycle_profile.hpp"
 
 struct JammerChannel {
     bool enabled;
@@ -75,6 +76,28 @@ struct SharedMemory {
     uint16_t volatile m4_stack_usage{0};
     uint32_t volatile m4_heap_usage{0};
     uint16_t volatile m4_buffer_missed{0};
+
+    // Bumped by the M0 after a retune, written after the two others. The
+    // channel statistics restart on the next buffer, drop retune_settle_us
+    // worth of samples and make the first report retune_window_us long.
+    uint32_t volatile retune_epoch{0};
+    uint16_t volatile retune_settle_us{0};
+    uint16_t volatile retune_window_us{0};
+
+    // Channels to measure at once from this retune on, as offsets from the
+    // tuned frequency. Written before retune_epoch; a count of 0 is off.
+    uint32_t volatile retune_channel_count{0};
+    uint32_t volatile retune_channel_spacing{0};
+    int32_t volatile retune_channel_offsets[MultiChannelStatistics::max_channels]{};
+
+    // Sweep handshake, see SweepConfigMessage. The M4 writes the step it
+    // wants next, bumps sweep_request and raises an M4 event; the M0 tunes
+    // it and copies sweep_request to sweep_tuned.
+    uint16_t volatile sweep_step{0};
+    uint32_t volatile sweep_request{0};
+    uint32_t volatile sweep_tuned{0};
+
+    cycle_profile::Profile m4_profile{};
 };
 
 extern SharedMemory& shared_memory;
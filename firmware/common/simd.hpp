@@ -28,6 +28,8 @@
 
 #include <cstdint>
 
+#include "simd_portable.hpp"
+
 struct vec4_s8 {
     union {
         int8_t v[4];
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SIMD_PORTABLE_H__
+#define __SIMD_PORTABLE_H__
+
+/* Host builds (test/baseband, benchmarks) compile the M4 DSP code with the
+ * same CMSIS headers as the firmware, but the Cortex-M4 intrinsics in there
+ * are inline assembly. On anything that isn't ARM, redirect the intrinsics
+ * used by the baseband to bit-exact C++ equivalents. Results match the ARMv7E-M
+ * instructions, except that the Q (saturation) flag is not modelled.
+ *
+ * Include after <hal.h>: the redirection is done with macros, so the CMSIS
+ * definitions must already have been seen.
+ */
+
+#if defined(LPC43XX_M4) && !defined(__arm__)
+
+#include <hal.h>
+
+#include <cstdint>
+
+namespace simd_portable {
+
+/* Helpers ***************************************************************/
+
+static inline int16_t lo(const uint32_t x) {
+    return static_cast<int16_t>(x & 0xffff);
+}
+
+static inline int16_t hi(const uint32_t x) {
+    return static_cast<int16_t>(x >> 16);
+}
+
+static inline uint32_t pack(const int32_t l, const int32_t h) {
+    return (static_cast<uint32_t>(l) & 0xffff) | (static_cast<uint32_t>(h) << 16);
+}
+
+static inline uint32_t ror(const uint32_t x, const uint32_t sh) {
+    return (sh == 0) ? x : ((x >> sh) | (x << (32 - sh)));
+}
+
+/* Saturation ************************************************************/
+
+static inline int32_t ssat(const int32_t x, const uint32_t bits) {
+    const int32_t max = static_cast<int32_t>((1U << (bits - 1)) - 1);
+    const int32_t min = -max - 1;
+    return (x > max) ? max : ((x < min) ? min : x);
+}
+
+static inline int64_t ssat64(const int64_t x) {
+    return (x > INT32_MAX) ? INT32_MAX : ((x < INT32_MIN) ? INT32_MIN : x);
+}
+
+static inline int32_t qadd(const int32_t x, const int32_t y) {
+    return static_cast<int32_t>(ssat64(int64_t{x} + y));
+}
+
+static inline int32_t qsub(const int32_t x, const int32_t y) {
+    return static_cast<int32_t>(ssat64(int64_t{x} - y));
+}
+
+static inline uint32_t qadd16(const uint32_t x, const uint32_t y) {
+    return pack(ssat(lo(x) + lo(y), 16), ssat(hi(x) + hi(y), 16));
+}
+
+static inline uint32_t qsub16(const uint32_t x, const uint32_t y) {
+    return pack(ssat(lo(x) - lo(y), 16), ssat(hi(x) - hi(y), 16));
+}
+
+/* Packing, extension and bit manipulation *******************************/
+
+static inline uint32_t pkhbt(const uint32_t x, const uint32_t y, const uint32_t sh) {
+    return (x & 0x0000ffff) | ((y << sh) & 0xffff0000);
+}
+
+static inline uint32_t pkhtb(const uint32_t x, const uint32_t y, const uint32_t sh) {
+    return (x & 0xffff0000) | (static_cast<uint32_t>(static_cast<int32_t>(y) >> sh) & 0x0000ffff);
+}
+
+static inline uint32_t rev16(const uint32_t x) {
+    return ((x & 0xff00ff00) >> 8) | ((x & 0x00ff00ff) << 8);
+}
+
+static inline uint32_t rbit(uint32_t x) {
+    x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+    x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f) | ((x & 0x0f0f0f0f) << 4);
+    x = ((x >> 8) & 0x00ff00ff) | ((x & 0x00ff00ff) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+static inline uint32_t bfi(const uint32_t dst, const uint32_t src, const uint32_t lsb, const uint32_t width) {
+    const uint32_t mask = ((width >= 32) ? 0xffffffff : ((1U << width) - 1)) << lsb;
+    return (dst & ~mask) | ((src << lsb) & mask);
+}
+
+static inline int32_t sxtb16(const uint32_t x, const uint32_t sh = 0) {
+    const uint32_t r = ror(x, sh);
+    return static_cast<int32_t>(pack(static_cast<int8_t>(r & 0xff), static_cast<int8_t>((r >> 16) & 0xff)));
+}
+
+static inline int32_t sxth(const uint32_t x, const uint32_t sh) {
+    return lo(ror(x, sh));
+}
+
+static inline int32_t sxtah(const uint32_t acc, const uint32_t x, const uint32_t sh) {
+    return static_cast<int32_t>(acc + static_cast<uint32_t>(sxth(x, sh)));
+}
+
+/* Halving parallel arithmetic *******************************************/
+
+static inline uint32_t shadd16(const uint32_t x, const uint32_t y) {
+    return pack((lo(x) + lo(y)) >> 1, (hi(x) + hi(y)) >> 1);
+}
+
+static inline uint32_t shsub16(const uint32_t x, const uint32_t y) {
+    return pack((lo(x) - lo(y)) >> 1, (hi(x) - hi(y)) >> 1);
+}
+
+static inline uint32_t shasx(const uint32_t x, const uint32_t y) {
+    return pack((lo(x) - hi(y)) >> 1, (hi(x) + lo(y)) >> 1);
+}
+
+static inline uint32_t shsax(const uint32_t x, const uint32_t y) {
+    return pack((lo(x) + hi(y)) >> 1, (hi(x) - lo(y)) >> 1);
+}
+
+/* 16 x 16 multiplies ****************************************************/
+
+static inline int32_t smulbb(const uint32_t x, const uint32_t y) {
+    return lo(x) * lo(y);
+}
+
+static inline int32_t smulbt(const uint32_t x, const uint32_t y) {
+    return lo(x) * hi(y);
+}
+
+static inline int32_t smultb(const uint32_t x, const uint32_t y) {
+    return hi(x) * lo(y);
+}
+
+static inline int32_t smultt(const uint32_t x, const uint32_t y) {
+    return hi(x) * hi(y);
+}
+
+static inline int32_t smlabb(const uint32_t x, const uint32_t y, const uint32_t acc) {
+    return static_cast<int32_t>(static_cast<uint32_t>(smulbb(x, y)) + acc);
+}
+
+static inline int32_t smlatb(const uint32_t x, const uint32_t y, const uint32_t acc) {
+    return static_cast<int32_t>(static_cast<uint32_t>(smultb(x, y)) + acc);
+}
+
+/* Dual 16 x 16 multiplies, 32-bit results wrap like the hardware does. */
+
+static inline uint32_t smuad(const uint32_t x, const uint32_t y) {
+    return static_cast<uint32_t>(int64_t{lo(x)} * lo(y) + int64_t{hi(x)} * hi(y));
+}
+
+static inline uint32_t smuadx(const uint32_t x, const uint32_t y) {
+    return static_cast<uint32_t>(int64_t{lo(x)} * hi(y) + int64_t{hi(x)} * lo(y));
+}
+
+static inline uint32_t smusd(const uint32_t x, const uint32_t y) {
+    return static_cast<uint32_t>(int64_t{lo(x)} * lo(y) - int64_t{hi(x)} * hi(y));
+}
+
+static inline uint32_t smusdx(const uint32_t x, const uint32_t y) {
+    return static_cast<uint32_t>(int64_t{lo(x)} * hi(y) - int64_t{hi(x)} * lo(y));
+}
+
+static inline uint32_t smlad(const uint32_t x, const uint32_t y, const uint32_t acc) {
+    return smuad(x, y) + acc;
+}
+
+static inline uint32_t smladx(const uint32_t x, const uint32_t y, const uint32_t acc) {
+    return smuadx(x, y) + acc;
+}
+
+static inline uint32_t smlsd(const uint32_t x, const uint32_t y, const uint32_t acc) {
+    return smusd(x, y) + acc;
+}
+
+static inline int64_t smlaldx(const uint32_t x, const uint32_t y, const int64_t acc) {
+    return static_cast<int64_t>(static_cast<uint64_t>(acc) + static_cast<uint64_t>(int64_t{lo(x)} * hi(y) + int64_t{hi(x)} * lo(y)));
+}
+
+static inline int64_t smlsld(const uint32_t x, const uint32_t y, const int64_t acc) {
+    return static_cast<int64_t>(static_cast<uint64_t>(acc) + static_cast<uint64_t>(int64_t{lo(x)} * lo(y) - int64_t{hi(x)} * hi(y)));
+}
+
+/* 32 x 32 multiplies ****************************************************/
+
+static inline int32_t smmulr(const int32_t x, const int32_t y) {
+    return static_cast<int32_t>((int64_t{x} * y + 0x80000000LL) >> 32);
+}
+
+} /* namespace simd_portable */
+
+#undef __SSAT
+#undef __PKHBT
+#undef __PKHTB
+#undef __SMLALDX
+#undef __SMLSLD
+
+#define __SSAT simd_portable::ssat
+#define __QADD simd_portable::qadd
+#define __QSUB simd_portable::qsub
+#define __QADD16 simd_portable::qadd16
+#define __QSUB16 simd_portable::qsub16
+#define __PKHBT simd_portable::pkhbt
+#define __PKHTB simd_portable::pkhtb
+#define __REV16 simd_portable::rev16
+#define __RBIT simd_portable::rbit
+#define __BFI simd_portable::bfi
+#define __SXTB16 simd_portable::sxtb16
+#define __SXTH simd_portable::sxth
+#define __SXTAH simd_portable::sxtah
+#define __SHADD16 simd_portable::shadd16
+#define __SHSUB16 simd_portable::shsub16
+#define __SHASX simd_portable::shasx
+#define __SHSAX simd_portable::shsax
+#define __SMULBB simd_portable::smulbb
+#define __SMULBT simd_portable::smulbt
+#define __SMULTB simd_portable::smultb
+#define __SMULTT simd_portable::smultt
+#define __SMLABB simd_portable::smlabb
+#define __SMLATB simd_portable::smlatb
+#define __SMUAD simd_portable::smuad
+#define __SMUADX simd_portable::smuadx
+#define __SMUSD simd_portable::smusd
+#define __SMUSDX simd_portable::smusdx
+#define __SMLAD simd_portable::smlad
+#define __SMLADX simd_portable::smladx
+#define __SMLSD simd_portable::smlsd
+#define __SMLALDX simd_portable::smlaldx
+#define __SMLSLD simd_portable::smlsld
+#define __SMMULR simd_portable::smmulr
+
+#endif /* defined(LPC43XX_M4) && !defined(__arm__) */
+
+#endif /*__SIMD_PORTABLE_H__*/
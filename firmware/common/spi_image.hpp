@@ -86,6 +86,7 @@ constexpr image_tag_t image_tag_ais{'P', 'A', 'I', 'S'};
 constexpr image_tag_t image_tag_am_audio{'P', 'A', 'M', 'A'};
 constexpr image_tag_t image_tag_am_tv{'P', 'A', 'M', 'T'};
 constexpr image_tag_t image_tag_capture{'P', 'C', 'A', 'P'};
+constexpr image_tag_t image_tag_channelizer{'P', 'C', 'H', 'Z'};
 constexpr image_tag_t image_tag_ert{'P', 'E', 'R', 'T'};
 constexpr image_tag_t image_tag_nfm_audio{'P', 'N', 'F', 'M'};
 constexpr image_tag_t image_tag_pocsag{'P', 'P', 'O', 'C'};
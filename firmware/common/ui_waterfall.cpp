@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "ui_waterfall.hpp"
+
+#include "portapack.hpp"
+using namespace portapack;
+
+namespace ui {
+
+void WaterfallSurface::attach(const Rect r) {
+    rect_ = r;
+    attached_ = true;
+    clear();
+    display.scroll_set_area(rect_.top(), rect_.bottom());
+    display.scroll_set_position(0);
+}
+
+void WaterfallSurface::detach() {
+    if (attached_) {
+        display.scroll_disable();
+        attached_ = false;
+    }
+}
+
+void WaterfallSurface::set_levels(const size_t x, const uint8_t* const levels, const size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        line_[x + i] = lut_[levels[i]];
+    }
+}
+
+void WaterfallSurface::push_line() {
+    if (attached_) {
+        const auto y = display.scroll(1);
+        display.render_line({rect_.left(), y}, rect_.width(), line_.data());
+    }
+}
+
+void WaterfallSurface::clear() {
+    display.fill_rectangle(rect_, Color::black());
+}
+
+} /* namespace ui */
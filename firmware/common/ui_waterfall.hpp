@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __UI_WATERFALL_H__
+#define __UI_WATERFALL_H__
+
+#include "ui.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace ui {
+
+/* A waterfall kept in the ILI9341 hardware scroll region. A new line costs
+ * one scroll address write and one burst of pixels; the panel moves the rest
+ * of the picture down by itself. Levels go through a 256 entry colour LUT
+ * (see spectrum_color_lut.hpp) as they are set, so the line is ready to send
+ * when it completes.
+ *
+ * The scroll region is global, only one surface should be attached at a time.
+ */
+class WaterfallSurface {
+   public:
+    using LUT = std::array<Color, 256>;
+
+    constexpr WaterfallSurface(const LUT& lut)
+        : lut_{lut} {
+    }
+
+    WaterfallSurface(const WaterfallSurface&) = delete;
+    WaterfallSurface(WaterfallSurface&&) = delete;
+    WaterfallSurface& operator=(const WaterfallSurface&) = delete;
+    WaterfallSurface& operator=(WaterfallSurface&&) = delete;
+
+    /* Makes r (at most screen_width wide) the scroll region and clears it. */
+    void attach(const Rect r);
+
+    /* Gives the whole screen back, if attached. */
+    void detach();
+
+    bool attached() const { return attached_; }
+    Dim width() const { return rect_.width(); }
+
+    void set_level(const size_t x, const uint8_t level) {
+        line_[x] = lut_[level];
+    }
+
+    /* Sets count pixels from x on from consecutive levels. */
+    void set_levels(const size_t x, const uint8_t* const levels, const size_t count);
+
+    /* Scrolls by a line and draws the pending one at the top. */
+    void push_line();
+
+    void clear();
+
+   private:
+    const LUT& lut_;
+    Rect rect_{};
+    bool attached_{false};
+    std::array<Color, screen_width> line_{};
+};
+
+} /* namespace ui */
+
+#endif /*__UI_WATERFALL_H__*/
@@ -36,6 +36,9 @@ FRESULT f_close(FIL*) {
 FRESULT f_closedir(DIR*) {
     return FR_OK;
 }
+FRESULT f_expand(FIL*, FSIZE_t, BYTE) {
+    return FR_OK;
+}
 FRESULT f_findfirst(DIR*, FILINFO*, const TCHAR*, const TCHAR*) {
     return FR_OK;
 }
@@ -72,6 +75,9 @@ FRESULT f_truncate(FIL*) {
 FRESULT f_unlink(const TCHAR*) {
     return FR_OK;
 }
+FRESULT f_utime(const TCHAR*, const FILINFO*) {
+    return FR_OK;
+}
 FRESULT f_write(FIL*, const void*, UINT, UINT*) {
     return FR_OK;
 }
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "doctest.h"
+#include "app_arena.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("AppArena");
+
+TEST_CASE("Allocations are aligned and come from one chunk.") {
+    AppArena arena{256};
+    auto a = arena.allocate(3);
+    auto b = arena.allocate(13);
+    auto c = arena.allocate(8);
+
+    CHECK_EQ(reinterpret_cast<uintptr_t>(a) % AppArena::alignment, 0);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(b) % AppArena::alignment, 0);
+    CHECK_EQ(static_cast<uint8_t*>(b) - static_cast<uint8_t*>(a), 8);
+    CHECK_EQ(static_cast<uint8_t*>(c) - static_cast<uint8_t*>(b), 16);
+    CHECK_EQ(arena.used(), 32);
+    CHECK_GT(arena.reserved(), 256);
+}
+
+TEST_CASE("Last allocation is stepped back.") {
+    AppArena arena{256};
+    auto a = arena.allocate(1000);  // Own chunk.
+    arena.deallocate(a, 1000);
+    CHECK_EQ(arena.allocate(1000), a);
+    CHECK_EQ(arena.used(), 1000);
+}
+
+TEST_CASE("Freed small blocks are reused by size.") {
+    AppArena arena{256};
+    auto a = arena.allocate(24);
+    auto b = arena.allocate(40);
+    arena.allocate(8);
+    auto reserved = arena.reserved();
+
+    arena.deallocate(a, 24);
+    arena.deallocate(b, 40);
+    CHECK_EQ(arena.allocate(40), b);
+    CHECK_EQ(arena.allocate(20), a);
+    CHECK_EQ(arena.reserved(), reserved);
+}
+
+TEST_CASE("Oversized requests get their own chunk.") {
+    AppArena arena{64};
+    auto a = arena.allocate(16);
+    auto big = arena.allocate(4096);
+    auto b = arena.allocate(16);
+
+    CHECK_NE(big, nullptr);
+    CHECK_NE(static_cast<uint8_t*>(b) - static_cast<uint8_t*>(a), 16);
+    CHECK_GE(arena.reserved(), 4096 + 64);
+}
+
+TEST_CASE("Release hands everything back.") {
+    AppArena arena{};
+    for (int i = 0; i < 100; ++i)
+        arena.allocate(100);
+
+    CHECK_EQ(arena.high_water(), 100 * 104);
+    arena.release();
+    CHECK_EQ(arena.reserved(), 0);
+    CHECK_EQ(arena.used(), 0);
+    CHECK_EQ(arena.high_water(), 100 * 104);
+}
+
+TEST_CASE("List churn stays within the arena.") {
+    AppArena arena{};
+    std::list<std::pair<uint64_t, int>, ArenaAllocator<std::pair<uint64_t, int>>> list{arena};
+
+    for (int i = 0; i < 64; ++i)
+        list.emplace_front(i, i);
+    auto reserved = arena.reserved();
+    auto used = arena.used();
+
+    // Evict the oldest and insert a new one, like a recent entries list.
+    for (int i = 0; i < 10000; ++i) {
+        list.pop_back();
+        list.emplace_front(i, i);
+    }
+
+    CHECK_EQ(list.size(), 64);
+    CHECK_EQ(arena.reserved(), reserved);
+    CHECK_EQ(arena.used(), used);
+}
+
+TEST_CASE("Containers share and propagate the arena.") {
+    AppArena arena{};
+    using Allocator = ArenaAllocator<std::string>;
+    std::vector<std::string, Allocator> a{Allocator{arena}};
+    std::vector<std::string, Allocator> b{};
+
+    a.push_back("one");
+    CHECK_GT(arena.used(), 0);
+    CHECK_EQ(b.get_allocator().arena(), nullptr);
+
+    b = std::move(a);
+    CHECK_EQ(b.get_allocator().arena(), &arena);
+    CHECK_EQ(b.front(), "one");
+
+    b.clear();
+    b.shrink_to_fit();
+    CHECK_EQ(arena.used(), 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "ble_hop_schedule.hpp"
+
+#include <vector>
+
+using namespace ble;
+
+TEST_CASE("HopSchedule cycles the advertising channels in order") {
+    HopSchedule schedule{};
+    schedule.set_dwell_ms(100);
+
+    std::vector<uint8_t> visited{schedule.channel()};
+    for (int i = 0; i < 4; i++) {
+        CHECK_FALSE(schedule.advance(99'999));
+        CHECK(schedule.advance(1));
+        visited.push_back(schedule.channel());
+    }
+
+    CHECK(visited == std::vector<uint8_t>{37, 38, 39, 37, 38});
+}
+
+TEST_CASE("HopSchedule accumulates frame times up to the dwell") {
+    HopSchedule schedule{};
+    schedule.set_dwell_ms(50);
+    CHECK(schedule.dwell_ms() == 50);
+
+    // 60 frames per second.
+    int frames = 0;
+    while (!schedule.advance(16'667))
+        frames++;
+
+    CHECK(frames == 2);
+    CHECK(schedule.channel() == 38);
+}
+
+TEST_CASE("HopSchedule gives a full dwell after a late call") {
+    HopSchedule schedule{};
+    schedule.set_dwell_ms(100);
+
+    CHECK(schedule.advance(350'000));
+    CHECK(schedule.channel() == 38);
+    CHECK_FALSE(schedule.advance(99'000));
+    CHECK(schedule.channel() == 38);
+}
+
+TEST_CASE("HopSchedule restart goes back to channel 37") {
+    HopSchedule schedule{};
+    schedule.set_dwell_ms(100);
+    schedule.advance(60'000);
+    schedule.advance(60'000);
+    REQUIRE(schedule.channel() == 38);
+
+    schedule.restart();
+    CHECK(schedule.channel() == 37);
+    CHECK_FALSE(schedule.advance(60'000));
+}
+
+TEST_CASE("ChannelStatistics counts per advertising channel") {
+    ChannelStatistics statistics{};
+    statistics.add(37, 3, 1);
+    statistics.add(39, 5, 0);
+    statistics.add(37, 2, 4);
+
+    CHECK(statistics.counters(37).packets == 5);
+    CHECK(statistics.counters(37).crc_errors == 5);
+    CHECK(statistics.counters(38).packets == 0);
+    CHECK(statistics.counters(39).packets == 5);
+
+    statistics.clear();
+    CHECK(statistics.counters(37).packets == 0);
+    CHECK(statistics.counters(39).packets == 0);
+}
+
+TEST_CASE("ChannelStatistics ignores data channels") {
+    ChannelStatistics statistics{};
+    statistics.add(0, 1, 1);
+    statistics.add(36, 1, 1);
+    statistics.add(40, 1, 1);
+
+    for (auto channel : advertising_channels) {
+        CHECK(statistics.counters(channel).packets == 0);
+        CHECK(statistics.counters(channel).crc_errors == 0);
+    }
+    CHECK(statistics.counters(12).packets == 0);
+}
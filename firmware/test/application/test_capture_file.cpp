@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "doctest.h"
+#include "diskio.h"
+#include "ff.h"
+#include "io_convert.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* Runs FatFs against a RAM disk to compare appending capture files with
+ * writing into an extent reserved up front by FileConvertWriter::preallocate().
+ *
+ * Besides wall clock time, each disk write is charged with a simple SD card
+ * cost model: a fixed command overhead, a per-sector transfer time and a
+ * penalty when the write doesn't continue where the previous one ended
+ * (the card has to leave its open allocation unit, e.g. for a FAT update).
+ */
+
+TEST_SUITE_BEGIN("Capture file pre-allocation");
+
+namespace {
+
+/* 48 MiB FAT16 volume with 4 KiB clusters. f_mkfs is disabled in ffconf.h,
+ * so the boot sector is written by hand. */
+constexpr size_t sector_size = 512;
+constexpr size_t sector_count = 48 * 1024 * 1024 / sector_size;
+constexpr size_t sectors_per_cluster = 8;
+constexpr size_t reserved_sectors = 1;
+constexpr size_t fat_count = 2;
+constexpr size_t fat_sectors = 48;
+constexpr size_t root_entries = 512;
+constexpr size_t fat_region_end = reserved_sectors + fat_count * fat_sectors;
+
+constexpr double command_us = 250.0;
+constexpr double sector_us = 20.0;
+constexpr double random_write_us = 2000.0;
+
+struct RamDisk {
+    std::vector<uint8_t> image{};
+    DWORD next_sector{0};
+    size_t fat_sectors_written{0};
+    double busy_us{0};
+};
+
+RamDisk disk{};
+
+void put16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+void format() {
+    disk = {};
+    disk.image.assign(sector_count * sector_size, 0);
+
+    uint8_t* bs = disk.image.data();
+    memcpy(bs, "\xEB\x3C\x90" "MSDOS5.0", 11);
+    put16(bs + 11, sector_size);
+    bs[13] = sectors_per_cluster;
+    put16(bs + 14, reserved_sectors);
+    bs[16] = fat_count;
+    put16(bs + 17, root_entries);
+    put16(bs + 19, 0);  // total sectors in the 32 bit field
+    bs[21] = 0xF8;
+    put16(bs + 22, fat_sectors);
+    put16(bs + 24, 63);
+    put16(bs + 26, 255);
+    put32(bs + 32, sector_count);
+    bs[36] = 0x80;
+    bs[38] = 0x29;
+    put32(bs + 39, 0x12345678);
+    memcpy(bs + 43, "NO NAME    FAT16   ", 19);
+    put16(bs + 510, 0xAA55);
+
+    for (size_t i = 0; i < fat_count; i++) {
+        uint8_t* fat = &disk.image[(reserved_sectors + i * fat_sectors) * sector_size];
+        put16(fat, 0xFFF8);
+        put16(fat + 2, 0xFFFF);
+    }
+}
+
+struct Result {
+    double wall_ms;
+    double modeled_ms;
+    double worst_write_ms;
+    size_t fat_sectors_written;
+};
+
+/* Writes count blocks of block_size through FileConvertWriter, optionally
+ * into a pre-allocated extent, and checks the file that comes out. */
+Result capture(const size_t block_size, const size_t count, const bool preallocate) {
+    format();
+
+    FATFS fs{};
+    REQUIRE(f_mount(&fs, reinterpret_cast<const TCHAR*>(u""), 1) == FR_OK);
+
+    // A small file first, like the metadata file written next to a capture.
+    {
+        File metadata{};
+        REQUIRE_FALSE(metadata.create(u"CAPTURE.TXT").is_valid());
+        metadata.write_line("center_frequency=433920000");
+    }
+
+    std::vector<uint8_t> block(block_size);
+    Result result{};
+    {
+        FileConvertWriter writer{};
+        REQUIRE_FALSE(writer.create(u"CAPTURE.C16").is_valid());
+        if (preallocate) {
+            // Reserve more than gets written, as with a capture stopped early.
+            REQUIRE_FALSE(writer.preallocate(block_size * count * 3 / 2).is_valid());
+        }
+
+        const double busy_before = disk.busy_us;
+        const size_t fat_before = disk.fat_sectors_written;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < count; i++) {
+            std::fill(block.begin(), block.end(), static_cast<uint8_t>(i));
+            const double busy = disk.busy_us;
+            REQUIRE(writer.write(block.data(), block.size()).is_ok());
+            result.worst_write_ms = std::max(result.worst_write_ms, (disk.busy_us - busy) / 1000.0);
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        result.wall_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        result.modeled_ms = (disk.busy_us - busy_before) / 1000.0;
+        result.fat_sectors_written = disk.fat_sectors_written - fat_before;
+    }
+
+    // The writer truncated the file to the data written.
+    File file{};
+    REQUIRE_FALSE(file.open(u"CAPTURE.C16").is_valid());
+    CHECK(file.size() == block_size * count);
+
+    file.seek(block_size * (count - 1));
+    REQUIRE(file.read(block.data(), block.size()).is_ok());
+    CHECK(block.front() == static_cast<uint8_t>(count - 1));
+    CHECK(block.back() == static_cast<uint8_t>(count - 1));
+    file.close();
+
+    DWORD free_clusters = 0;
+    FATFS* pfs = nullptr;
+    REQUIRE(f_getfree(reinterpret_cast<const TCHAR*>(u""), &free_clusters, &pfs) == FR_OK);
+    const size_t used_clusters = (block_size * count + sectors_per_cluster * sector_size - 1) / (sectors_per_cluster * sector_size);
+    CHECK(free_clusters == (pfs->n_fatent - 2) - used_clusters - 1);  // + the metadata file
+
+    f_mount(nullptr, reinterpret_cast<const TCHAR*>(u""), 0);
+    return result;
+}
+
+std::string describe(const char* name, const Result& r) {
+    return std::string{name} + ": " + std::to_string(r.wall_ms) + " ms wall, " +
+           std::to_string(r.modeled_ms) + " ms modeled, worst write " +
+           std::to_string(r.worst_write_ms) + " ms, " +
+           std::to_string(r.fat_sectors_written) + " FAT sectors written";
+}
+
+} /* namespace */
+
+/* FatFs disk and OS bindings for the RAM disk. */
+
+DSTATUS disk_initialize(BYTE) {
+    return 0;
+}
+
+DSTATUS disk_status(BYTE) {
+    return 0;
+}
+
+DRESULT disk_read(BYTE, BYTE* buff, DWORD sector, UINT count) {
+    if ((sector + count) > sector_count) return RES_PARERR;
+    memcpy(buff, &disk.image[sector * sector_size], count * sector_size);
+    return RES_OK;
+}
+
+DRESULT disk_write(BYTE, const BYTE* buff, DWORD sector, UINT count) {
+    if ((sector + count) > sector_count) return RES_PARERR;
+    memcpy(&disk.image[sector * sector_size], buff, count * sector_size);
+
+    disk.busy_us += command_us + count * sector_us;
+    if (sector != disk.next_sector)
+        disk.busy_us += random_write_us;
+    disk.next_sector = sector + count;
+
+    if (sector < fat_region_end)
+        disk.fat_sectors_written += std::min<size_t>(count, fat_region_end - sector);
+    return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE, BYTE cmd, void*) {
+    return (cmd == CTRL_SYNC) ? RES_OK : RES_PARERR;
+}
+
+DWORD get_fattime(void) {
+    return ((2024UL - 1980) << 25) | (1UL << 21) | (1UL << 16);
+}
+
+int ff_cre_syncobj(BYTE, _SYNC_t*) {
+    return 1;
+}
+
+int ff_req_grant(_SYNC_t) {
+    return 1;
+}
+
+void ff_rel_grant(_SYNC_t) {}
+
+int ff_del_syncobj(_SYNC_t) {
+    return 1;
+}
+
+TEST_CASE("Preallocated capture avoids FAT updates while writing") {
+    constexpr size_t block_size = 16384;
+    constexpr size_t count = 1024;  // 16 MiB
+
+    const auto appended = capture(block_size, count, false);
+    const auto preallocated = capture(block_size, count, true);
+
+    MESSAGE(describe("append", appended));
+    MESSAGE(describe("preallocated", preallocated));
+
+    CHECK(appended.fat_sectors_written > 0);
+    CHECK(preallocated.fat_sectors_written == 0);
+    CHECK(preallocated.modeled_ms < appended.modeled_ms);
+    CHECK(preallocated.worst_write_ms <= appended.worst_write_ms);
+}
+
+TEST_CASE("Preallocated C8 capture is truncated to the converted size") {
+    format();
+
+    FATFS fs{};
+    REQUIRE(f_mount(&fs, reinterpret_cast<const TCHAR*>(u""), 1) == FR_OK);
+
+    std::vector<int16_t> block(8192, 0x1234);
+    {
+        FileConvertWriter writer{};
+        REQUIRE_FALSE(writer.create(u"CAPTURE.C8").is_valid());
+        CHECK(writer.convert_c16_to_c8);
+        REQUIRE_FALSE(writer.preallocate(1024 * 1024).is_valid());
+        for (size_t i = 0; i < 10; i++)
+            REQUIRE(writer.write(block.data(), block.size() * sizeof(int16_t)).is_ok());
+    }
+
+    File file{};
+    REQUIRE_FALSE(file.open(u"CAPTURE.C8").is_valid());
+    CHECK(file.size() == 10 * block.size());
+
+    uint8_t sample[2]{};
+    REQUIRE(file.read(sample, sizeof(sample)).is_ok());
+    CHECK(sample[0] == 0x12);
+    file.close();
+
+    f_mount(nullptr, reinterpret_cast<const TCHAR*>(u""), 0);
+}
+
+TEST_SUITE_END();
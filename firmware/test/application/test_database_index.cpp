@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "database_index.hpp"
+#include "mock_file.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using Index = DatabaseIndex<MockFile>;
+
+namespace {
+
+constexpr size_t key_length = 4;
+constexpr size_t record_length = 4;
+
+/* Record stored for a key, so a lookup can be checked against it. */
+std::string record_for(const std::string& key) {
+    std::string record = key;
+    for (auto& c : record) c ^= 0x20;
+    return record;
+}
+
+/* A few keys in scattered buckets, and bucket "55" large enough that the
+ * search has to narrow it down before reading the window. */
+std::vector<std::string> make_keys() {
+    std::vector<std::string> keys{
+        "0000", "0001", "00FF",
+        "0F10", "0F20",
+        "1A00",
+        "A000", "A0F0",
+        "FF00", "FFFF"};
+    char key[key_length + 1];
+    for (unsigned i = 0; i < 200; i++) {
+        snprintf(key, sizeof(key), "55%02X", i);
+        keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+std::string make_db(const std::vector<std::string>& keys, const bool with_header) {
+    std::string data;
+
+    if (with_header) {
+        std::vector<uint32_t> buckets(Index::bucket_count + 1, 0);
+        for (const auto& key : keys)
+            buckets[Index::bucket_of(key.data(), key_length) + 1]++;
+        for (size_t i = 0; i < Index::bucket_count; i++)
+            buckets[i + 1] += buckets[i];
+
+        const Index::FileHeader header{
+            {'P', 'P', 'D', 'B'},
+            Index::header_version,
+            key_length,
+            record_length,
+            Index::bucket_count,
+            static_cast<uint32_t>(keys.size())};
+        data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        data.append(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(uint32_t));
+    }
+
+    for (const auto& key : keys)
+        data += key;
+    for (const auto& key : keys)
+        data += record_for(key);
+    return data;
+}
+
+std::string lookup(Index& index, MockFile& file, const std::string& key, int& result) {
+    char record[record_length]{};
+    result = index.lookup(file, key, record);
+    return std::string(record, record_length);
+}
+
+/* Overwrites every record in the file, so only cached lookups still read the old ones. */
+void overwrite_records(MockFile& file, const size_t count) {
+    const auto records = file.data_.size() - count * record_length;
+    std::fill(file.data_.begin() + records, file.data_.end(), 'Z');
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("DatabaseIndex");
+
+TEST_CASE("Buckets are monotonic in key order.") {
+    const auto keys = make_keys();
+    for (size_t i = 1; i < keys.size(); i++)
+        CHECK(Index::bucket_of(keys[i - 1].data(), key_length) <= Index::bucket_of(keys[i].data(), key_length));
+}
+
+TEST_CASE("It finds the first and last key of every bucket.") {
+    const auto keys = make_keys();
+
+    for (const auto with_header : {true, false}) {
+        MockFile file{make_db(keys, with_header)};
+        Index index{};
+        REQUIRE(index.open(file, key_length, record_length));
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            const auto bucket = Index::bucket_of(keys[i].data(), key_length);
+            const bool first = (i == 0) || Index::bucket_of(keys[i - 1].data(), key_length) != bucket;
+            const bool last = (i + 1 == keys.size()) || Index::bucket_of(keys[i + 1].data(), key_length) != bucket;
+            if (!first && !last)
+                continue;
+
+            int result = 0;
+            const auto record = lookup(index, file, keys[i], result);
+            CHECK_EQ(result, DATABASE_RECORD_FOUND);
+            CHECK_EQ(record, record_for(keys[i]));
+        }
+    }
+}
+
+TEST_CASE("It finds every key of a bucket larger than the window.") {
+    const auto keys = make_keys();
+    MockFile file{make_db(keys, true)};
+    Index index{};
+    REQUIRE(index.open(file, key_length, record_length));
+
+    for (const auto& key : keys) {
+        int result = 0;
+        const auto record = lookup(index, file, key, result);
+        CHECK_EQ(result, DATABASE_RECORD_FOUND);
+        CHECK_EQ(record, record_for(key));
+    }
+}
+
+TEST_CASE("It reports a miss for keys that aren't in the file.") {
+    const auto keys = make_keys();
+
+    for (const auto with_header : {true, false}) {
+        MockFile file{make_db(keys, with_header)};
+        Index index{};
+        REQUIRE(index.open(file, key_length, record_length));
+
+        // Between keys of a bucket, in an empty bucket, past the last key,
+        // past a large bucket, and a prefix of a key.
+        for (const auto key : {"0002", "3000", "ZZZZ", "55C8", "0F"}) {
+            int result = 0;
+            lookup(index, file, key, result);
+            CHECK_EQ(result, DATABASE_RECORD_NOT_FOUND);
+        }
+    }
+}
+
+TEST_CASE("It rejects a header that doesn't match the records.") {
+    MockFile file{make_db(make_keys(), true)};
+    Index index{};
+    CHECK_FALSE(index.open(file, key_length, record_length + 1));
+}
+
+TEST_CASE("A damaged bucket table only causes misses.") {
+    const auto keys = make_keys();
+    const auto data = make_db(keys, true);
+    const auto bucket = Index::bucket_of("55", key_length);
+
+    // Offset of a bucket table entry in the file.
+    auto entry_offset = [](size_t bucket) {
+        return sizeof(Index::FileHeader) + bucket * sizeof(uint32_t);
+    };
+    uint32_t bucket_end = 0;
+    memcpy(&bucket_end, &data[entry_offset(bucket + 1)], sizeof(bucket_end));
+
+    // A bucket starting after its end, and one starting past the records.
+    for (const uint32_t first : {bucket_end + 1, static_cast<uint32_t>(keys.size() + 1000)}) {
+        MockFile file{data};
+        memcpy(&file.data_[entry_offset(bucket)], &first, sizeof(first));
+        Index index{};
+        REQUIRE(index.open(file, key_length, record_length));
+
+        // The search stays within the records, MockFile grows on seeks past its end.
+        int result = 0;
+        lookup(index, file, "5510", result);
+        CHECK_EQ(result, DATABASE_RECORD_NOT_FOUND);
+        CHECK_EQ(file.data_.size(), data.size());
+    }
+}
+
+TEST_CASE("The cache evicts the least recently used key.") {
+    const auto keys = make_keys();
+    MockFile file{make_db(keys, true)};
+    Index index{};
+    REQUIRE(index.open(file, key_length, record_length));
+
+    // Fill the cache, then use keys[0] again so keys[1] is the oldest.
+    int result = 0;
+    for (size_t i = 0; i < Index::cache_slots; i++)
+        lookup(index, file, keys[i], result);
+    lookup(index, file, keys[0], result);
+    lookup(index, file, keys[Index::cache_slots], result);
+
+    overwrite_records(file, keys.size());
+
+    CHECK_EQ(lookup(index, file, keys[0], result), record_for(keys[0]));
+    for (size_t i = 2; i <= Index::cache_slots; i++)
+        CHECK_EQ(lookup(index, file, keys[i], result), record_for(keys[i]));
+
+    CHECK_EQ(lookup(index, file, keys[1], result), "ZZZZ");
+    CHECK_EQ(result, DATABASE_RECORD_FOUND);
+}
+
+TEST_CASE("The cache remembers misses.") {
+    const auto keys = make_keys();
+    MockFile file{make_db(keys, true)};
+    Index index{};
+    REQUIRE(index.open(file, key_length, record_length));
+
+    int result = 0;
+    lookup(index, file, "0002", result);
+    REQUIRE_EQ(result, DATABASE_RECORD_NOT_FOUND);
+
+    // Even once the key shows up in the file.
+    auto pos = file.data_.find("0001");
+    file.data_.replace(pos, key_length, "0002");
+    lookup(index, file, "0002", result);
+    CHECK_EQ(result, DATABASE_RECORD_NOT_FOUND);
+
+    index.close();
+    file.seek(0);
+    REQUIRE(index.open(file, key_length, record_length));
+    lookup(index, file, "0002", result);
+    CHECK_EQ(result, DATABASE_RECORD_FOUND);
+}
+
+TEST_SUITE_END();
@@ -21,6 +21,10 @@
 
 #include "doctest.h"
 #include "freqman_db.hpp"
+#include "mock_file.hpp"
+
+#include <chrono>
+#include <string>
 
 TEST_SUITE_BEGIN("Freqman Parsing");
 
@@ -266,3 +270,221 @@ TEST_CASE("It can parse frequency step") {
 */
 
 TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("Freqman Index");
+
+namespace {
+
+/* MockFile that counts reads, a stand-in for SD accesses. */
+class CountingFile : public MockFile {
+   public:
+    using MockFile::MockFile;
+
+    Result<Size> read(void* data, Size bytes_to_read) {
+        reads++;
+        return MockFile::read(data, bytes_to_read);
+    }
+
+    uint32_t reads{0};
+};
+
+/* Entry as FreqmanDB reads it through the BufferWrapper. */
+template <typename Wrapper>
+freqman_entry read_line(Wrapper& w, uint32_t line, bool read_raw = true) {
+    auto text = w.get_text(line, 0, std::min<uint32_t>(w.line_length(line), freqman_max_line_length));
+    freqman_entry entry;
+    if (text && (parse_freqman_line(*text, entry) || read_raw))
+        return entry;
+    return {};
+}
+
+/* Entry as FreqmanDB reads it through the index. */
+template <typename Index>
+freqman_entry read_record(const Index& index, uint32_t line, bool read_raw = true) {
+    auto record = index.record(line);
+    if (record && (record->parsed || read_raw))
+        return from_index_record(*record);
+    return {};
+}
+
+std::string make_freqman_file(size_t count) {
+    std::string data;
+    for (size_t i = 0; i < count; ++i) {
+        freqman_entry entry{
+            .frequency_a = 100'000'000 + static_cast<int64_t>(i) * 12'500,
+            .description = "Entry " + std::to_string(i),
+            .type = freqman_type::Single,
+            .modulation = static_cast<freqman_index_t>(i % 3),
+            .bandwidth = 0,
+        };
+        data += to_freqman_string(entry) + "\n";
+    }
+    return data;
+}
+
+}  // namespace
+
+TEST_CASE("Index records match the lines read through the wrapper.") {
+    CountingFile source{
+        "f=123000000,d=Single\n"
+        "# A comment\n"
+        "\n"
+        "a=100000000,b=200000000,d=Range,m=NFM\n"
+        "not an entry at all, but longer than thirty characters\n"
+        "r=145000000,t=145600000,d=Ham"};
+    CountingFile idx{""};
+
+    REQUIRE(FreqmanIndex<CountingFile>::build(source, idx, 0x1234));
+    FreqmanIndex<CountingFile> index;
+    REQUIRE(index.open(idx, source.size(), 0x1234));
+
+    auto w = wrap_buffer(source);
+    REQUIRE_EQ(index.entry_count(), w.line_count());
+
+    for (uint32_t i = 0; i < w.line_count(); ++i) {
+        CHECK_EQ(*index.line_offset(i), w.line_range(i)->start);
+        CHECK(read_record(index, i) == read_line(w, i));
+        CHECK(read_record(index, i, false) == read_line(w, i, false));
+    }
+
+    CHECK_EQ(read_record(index, 0).type, freqman_type::Single);
+    CHECK_EQ(read_record(index, 1).type, freqman_type::Raw);
+    CHECK_EQ(read_record(index, 4).description.length(), freqman_max_desc_size);
+    CHECK_EQ(read_record(index, 5).type, freqman_type::HamRadio);
+    CHECK_FALSE(index.record(6));
+}
+
+TEST_CASE("Overlong lines are cut short but keep the following lines in place.") {
+    CountingFile source{
+        "f=123000000,d=" + std::string(5000, 'x') + "\n" +
+        std::string(5000, 'y') + "\n"
+        "f=124000000,d=After"};
+    CountingFile idx{""};
+
+    REQUIRE(FreqmanIndex<CountingFile>::build(source, idx, 0));
+    FreqmanIndex<CountingFile> index;
+    REQUIRE(index.open(idx, source.size(), 0));
+
+    auto w = wrap_buffer(source);
+    REQUIRE_EQ(index.entry_count(), 3);
+    for (uint32_t i = 0; i < w.line_count(); ++i) {
+        CHECK_EQ(*index.line_offset(i), w.line_range(i)->start);
+        CHECK(read_record(index, i) == read_line(w, i));
+    }
+
+    CHECK_EQ(read_record(index, 0).type, freqman_type::Single);
+    CHECK_EQ(read_record(index, 0).description, std::string(freqman_max_desc_size, 'x'));
+    CHECK_EQ(read_record(index, 1).type, freqman_type::Raw);
+    CHECK_EQ(read_record(index, 2).description, "After");
+}
+
+TEST_CASE("Empty source has an empty index.") {
+    CountingFile source{""};
+    CountingFile idx{""};
+
+    REQUIRE(FreqmanIndex<CountingFile>::build(source, idx, 0));
+    FreqmanIndex<CountingFile> index;
+    REQUIRE(index.open(idx, 0, 0));
+    CHECK_EQ(index.entry_count(), 0);
+}
+
+TEST_CASE("Index is rejected when the source changed.") {
+    CountingFile source{make_freqman_file(10)};
+    CountingFile idx{""};
+    REQUIRE(FreqmanIndex<CountingFile>::build(source, idx, 0x1234));
+
+    FreqmanIndex<CountingFile> index;
+    CHECK(index.open(idx, source.size(), 0x1234));
+    CHECK_FALSE(index.open(idx, source.size() + 1, 0x1234));
+    CHECK_FALSE(index.is_open());
+    CHECK_FALSE(index.open(idx, source.size(), 0x1235));
+
+    SUBCASE("Truncated index.") {
+        idx.data_.resize(idx.data_.size() - 1);
+        CHECK_FALSE(index.open(idx, source.size(), 0x1234));
+    }
+
+    SUBCASE("Unfinished build.") {
+        idx.data_[0] = 0;
+        CHECK_FALSE(index.open(idx, source.size(), 0x1234));
+    }
+}
+
+TEST_CASE("Rebuilding over a longer index truncates it.") {
+    CountingFile big{make_freqman_file(20)};
+    CountingFile small{make_freqman_file(5)};
+    CountingFile idx{""};
+
+    REQUIRE(FreqmanIndex<CountingFile>::build(big, idx, 1));
+    REQUIRE(FreqmanIndex<CountingFile>::build(small, idx, 2));
+
+    FreqmanIndex<CountingFile> index;
+    REQUIRE(index.open(idx, small.size(), 2));
+    CHECK_EQ(index.entry_count(), 5);
+    CHECK_EQ(read_record(index, 4).description, "Entry 4");
+}
+
+TEST_CASE("Index gives constant time access to a large file.") {
+    constexpr size_t count = 5000;
+    constexpr size_t lookups = 2000;
+    using clock = std::chrono::steady_clock;
+    auto micros = [](clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+
+    CountingFile source{make_freqman_file(count)};
+    CountingFile idx{""};
+
+    // Jump around like a scrolling list or a scanner picking entries.
+    std::vector<uint32_t> lines(lookups);
+    uint32_t lfsr = 0xace1;
+    for (auto& line : lines) {
+        lfsr = lfsr * 1664525 + 1013904223;
+        line = (lfsr >> 8) % count;
+    }
+
+    // Wrapper: newline scan on open, then the newline cache window.
+    auto start = clock::now();
+    auto w = wrap_buffer(source);
+    auto wrapper_open = clock::now() - start;
+    auto wrapper_open_reads = source.reads;
+    REQUIRE_EQ(w.line_count(), count);
+
+    source.reads = 0;
+    start = clock::now();
+    int64_t wrapper_sum = 0;
+    for (auto line : lines)
+        wrapper_sum += read_line(w, line).frequency_a;
+    auto wrapper_lookup = clock::now() - start;
+    auto wrapper_lookup_reads = source.reads;
+
+    // Index: one pass to build, then header read and one read per entry.
+    source.reads = 0;
+    start = clock::now();
+    REQUIRE(FreqmanIndex<CountingFile>::build(source, idx, 0));
+    auto index_build = clock::now() - start;
+    auto index_build_reads = source.reads;
+
+    FreqmanIndex<CountingFile> index;
+    start = clock::now();
+    REQUIRE(index.open(idx, source.size(), 0));
+    auto index_open = clock::now() - start;
+    CHECK_EQ(idx.reads, 1);
+    REQUIRE_EQ(index.entry_count(), count);
+
+    idx.reads = 0;
+    start = clock::now();
+    int64_t index_sum = 0;
+    for (auto line : lines)
+        index_sum += read_record(index, line).frequency_a;
+    auto index_lookup = clock::now() - start;
+    CHECK_EQ(idx.reads, lookups);
+    CHECK_EQ(index_sum, wrapper_sum);
+
+    MESSAGE("wrapper open: " << micros(wrapper_open) << "us, " << wrapper_open_reads << " reads; "
+                             << lookups << " lookups: " << micros(wrapper_lookup) << "us, " << wrapper_lookup_reads << " reads");
+    MESSAGE("index build: " << micros(index_build) << "us, " << index_build_reads << " reads; open: "
+                            << micros(index_open) << "us; " << lookups << " lookups: " << micros(index_lookup) << "us, " << lookups << " reads");
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "iq_block_ring.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+constexpr size_t block_size = 16;
+constexpr size_t block_count = 4;
+
+std::vector<uint8_t> block_of(const uint8_t value, const size_t size = block_size) {
+    return std::vector<uint8_t>(size, value);
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("IqBlockRing");
+
+TEST_CASE("Blocks come out in order with their numbers") {
+    std::vector<uint8_t> storage(IqBlockRing::storage_size(block_size, block_count));
+    IqBlockRing ring{storage.data(), block_size, block_count};
+    CHECK(ring.empty());
+
+    CHECK(ring.push(block_of(1).data(), block_size));
+    CHECK(ring.push(block_of(2, 5).data(), 5));
+
+    std::vector<uint8_t> out(block_size);
+    uint32_t index = 99;
+    CHECK(ring.pop(out.data(), index) == block_size);
+    CHECK(index == 0);
+    CHECK(out == block_of(1));
+
+    CHECK(ring.pop(out.data(), index) == 5);
+    CHECK(index == 1);
+    CHECK(std::vector<uint8_t>(out.begin(), out.begin() + 5) == block_of(2, 5));
+
+    CHECK(ring.empty());
+    CHECK(ring.pop(out.data(), index) == 0);
+    CHECK(ring.blocks() == 2);
+    CHECK(ring.dropped() == 0);
+}
+
+TEST_CASE("A full ring drops whole blocks and leaves a gap in the numbering") {
+    std::vector<uint8_t> storage(IqBlockRing::storage_size(block_size, block_count));
+    IqBlockRing ring{storage.data(), block_size, block_count};
+
+    for (uint8_t i = 0; i < block_count; i++)
+        CHECK(ring.push(block_of(i).data(), block_size));
+    CHECK_FALSE(ring.push(block_of(0xAA).data(), block_size));
+    CHECK_FALSE(ring.push(block_of(0xBB).data(), block_size));
+    CHECK(ring.blocks() == block_count + 2);
+    CHECK(ring.dropped() == 2);
+
+    std::vector<uint8_t> out(block_size);
+    uint32_t index = 0;
+    CHECK(ring.pop(out.data(), index) == block_size);
+    CHECK(index == 0);
+
+    // Room again, this one is numbered after the two dropped ones.
+    CHECK(ring.push(block_of(0xCC).data(), block_size));
+    for (uint32_t expected = 1; expected < block_count; expected++) {
+        CHECK(ring.pop(out.data(), index) == block_size);
+        CHECK(index == expected);
+        CHECK(out == block_of(expected));
+    }
+    CHECK(ring.pop(out.data(), index) == block_size);
+    CHECK(index == block_count + 2);
+    CHECK(out == block_of(0xCC));
+    CHECK(ring.empty());
+}
+
+TEST_CASE("Oversized blocks are dropped") {
+    std::vector<uint8_t> storage(IqBlockRing::storage_size(block_size, block_count));
+    IqBlockRing ring{storage.data(), block_size, block_count};
+
+    CHECK_FALSE(ring.push(block_of(1, block_size + 1).data(), block_size + 1));
+    CHECK(ring.empty());
+    CHECK(ring.dropped() == 1);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "doctest.h"
+#include "message_queue.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/* Host bindings for the per-core parts of MessageQueue. signal() stands in
+ * for the inter-core event: it sets a flag and wakes the reader thread. */
+
+namespace {
+
+std::mutex event_mutex{};
+std::condition_variable event_cv{};
+bool event_pending{false};
+size_t signal_count{0};
+
+void reset_events() {
+    std::lock_guard<std::mutex> lock{event_mutex};
+    event_pending = false;
+    signal_count = 0;
+}
+
+/* Returns false if no event arrived within the timeout. */
+bool wait_event(const std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock{event_mutex};
+    const bool signalled = event_cv.wait_for(lock, timeout, [] { return event_pending; });
+    event_pending = false;
+    return signalled;
+}
+
+struct SmallTestMessage : Message {
+    constexpr SmallTestMessage(const uint32_t sequence)
+        : Message{ID::ChannelStatistics},
+          sequence{sequence} {
+    }
+
+    uint32_t sequence;
+};
+
+struct LargeTestMessage : Message {
+    LargeTestMessage(const uint32_t sequence)
+        : Message{ID::AFSKData},
+          sequence{sequence} {
+        for (size_t i = 0; i < payload.size(); i++)
+            payload[i] = static_cast<uint8_t>(sequence + i);
+    }
+
+    uint32_t sequence;
+    std::array<uint8_t, 300> payload{};
+};
+
+} /* namespace */
+
+void MessageQueue::begin_write() {}
+
+void MessageQueue::end_write() {}
+
+void MessageQueue::signal() {
+    {
+        std::lock_guard<std::mutex> lock{event_mutex};
+        event_pending = true;
+        signal_count++;
+    }
+    event_cv.notify_one();
+}
+
+void MessageQueue::wait_empty() {
+    while (!is_empty())
+        std::this_thread::yield();
+}
+
+TEST_SUITE_BEGIN("MessageQueue");
+
+TEST_CASE("A burst of messages raises a single wakeup") {
+    std::array<uint8_t, 1 << 11> data{};
+    MessageQueue queue{data.data(), 11};
+    reset_events();
+
+    for (uint32_t i = 0; i < 5; i++)
+        REQUIRE(queue.push(SmallTestMessage{i}));
+    CHECK(signal_count == 1);
+
+    uint32_t expected = 0;
+    queue.handle([&expected](Message* const message) {
+        REQUIRE(message->id == Message::ID::ChannelStatistics);
+        CHECK(reinterpret_cast<SmallTestMessage*>(message)->sequence == expected++);
+    });
+    CHECK(expected == 5);
+    CHECK(queue.is_empty());
+
+    // Drained, so the next message needs a new wakeup.
+    REQUIRE(queue.push(SmallTestMessage{5}));
+    CHECK(signal_count == 2);
+}
+
+TEST_CASE("A full queue rejects messages without signalling") {
+    std::array<uint8_t, 1 << 11> data{};
+    MessageQueue queue{data.data(), 11};
+    reset_events();
+
+    size_t pushed = 0;
+    while (queue.push(LargeTestMessage{static_cast<uint32_t>(pushed)}))
+        pushed++;
+
+    // 2 byte record header per message.
+    CHECK(pushed == data.size() / (sizeof(LargeTestMessage) + 2));
+    CHECK(signal_count == 1);
+
+    size_t handled = 0;
+    queue.handle([&handled](Message* const message) {
+        CHECK(reinterpret_cast<LargeTestMessage*>(message)->sequence == handled++);
+    });
+    CHECK(handled == pushed);
+}
+
+TEST_CASE("Writer and reader threads exchange messages without loss") {
+    constexpr uint32_t message_count = 200000;
+
+    std::array<uint8_t, 1 << 11> data{};
+    MessageQueue queue{data.data(), 11};
+    reset_events();
+
+    size_t full_count = 0;
+    std::thread writer{[&queue, &full_count] {
+        for (uint32_t sequence = 0; sequence < message_count; sequence++) {
+            // Retry instead of dropping so the reader can check the sequence.
+            while (true) {
+                const bool pushed = (sequence % 3 == 0)
+                                        ? queue.push(LargeTestMessage{sequence})
+                                        : queue.push(SmallTestMessage{sequence});
+                if (pushed) break;
+                full_count++;
+                std::this_thread::yield();
+            }
+        }
+    }};
+
+    uint32_t expected = 0;
+    size_t corrupt_count = 0;
+    size_t lost_wakeups = 0;
+    while (expected < message_count) {
+        if (!wait_event(std::chrono::milliseconds{500})) {
+            // No event, yet there is data: the writer failed to wake us.
+            if (!queue.is_empty()) lost_wakeups++;
+        }
+
+        queue.handle([&expected, &corrupt_count](Message* const message) {
+            if (expected % 3 == 0) {
+                const auto large = reinterpret_cast<LargeTestMessage*>(message);
+                bool intact = (message->id == Message::ID::AFSKData) && (large->sequence == expected);
+                for (size_t i = 0; i < large->payload.size(); i++)
+                    intact &= (large->payload[i] == static_cast<uint8_t>(expected + i));
+                if (!intact) corrupt_count++;
+            } else {
+                const auto small = reinterpret_cast<SmallTestMessage*>(message);
+                if ((message->id != Message::ID::ChannelStatistics) || (small->sequence != expected))
+                    corrupt_count++;
+            }
+            expected++;
+        });
+    }
+    writer.join();
+
+    MESSAGE(message_count << " messages, " << signal_count << " wakeups, " << full_count << " full retries");
+    CHECK(expected == message_count);
+    CHECK(corrupt_count == 0);
+    CHECK(lost_wakeups == 0);
+    CHECK(signal_count < message_count);
+    CHECK(queue.is_empty());
+}
+
+TEST_CASE("A packet batch carries its messages through the queue") {
+    std::array<uint8_t, 1 << 11> data{};
+    MessageQueue queue{data.data(), 11};
+    reset_events();
+
+    PacketBatchMessage batch{};
+    uint32_t appended = 0;
+    while (batch.append(SmallTestMessage{appended}, sizeof(SmallTestMessage), 1000 + appended))
+        appended++;
+    REQUIRE(batch.append(LargeTestMessage{0}, sizeof(LargeTestMessage), 0) == false);
+    CHECK(appended == sizeof(batch.data) / PacketBatchMessage::entry_size(sizeof(SmallTestMessage)));
+
+    REQUIRE(queue.push(batch, batch.size()));
+    CHECK(signal_count == 1);
+
+    uint32_t expected = 0;
+    queue.handle([&expected](Message* const message) {
+        REQUIRE(message->id == Message::ID::PacketBatch);
+        reinterpret_cast<PacketBatchMessage*>(message)->for_each([&expected](Message* const packet, const uint32_t timestamp) {
+            CHECK(packet->id == Message::ID::ChannelStatistics);
+            CHECK((reinterpret_cast<uintptr_t>(packet) % 8) == 0);
+            CHECK(reinterpret_cast<SmallTestMessage*>(packet)->sequence == expected);
+            CHECK(timestamp == 1000 + expected);
+            expected++;
+        });
+    });
+    CHECK(expected == appended);
+
+    // Only the used part is queued.
+    batch.clear();
+    REQUIRE(batch.append(LargeTestMessage{7}, sizeof(LargeTestMessage), 0));
+    CHECK(batch.size() == 8 + PacketBatchMessage::entry_size(sizeof(LargeTestMessage)));
+    REQUIRE(queue.push(batch, batch.size()));
+    queue.handle([](Message* const message) {
+        size_t count = 0;
+        reinterpret_cast<PacketBatchMessage*>(message)->for_each([&count](Message* const packet, uint32_t) {
+            const auto large = reinterpret_cast<LargeTestMessage*>(packet);
+            CHECK(large->sequence == 7);
+            CHECK(large->payload.back() == static_cast<uint8_t>(7 + large->payload.size() - 1));
+            count++;
+        });
+        CHECK(count == 1);
+    });
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "scanner_schedule.hpp"
+#include "tuning.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace scanner;
+
+namespace {
+std::vector<rf::Frequency> channel_plan(rf::Frequency start, rf::Frequency step, size_t count) {
+    std::vector<rf::Frequency> frequencies;
+    for (size_t i = 0; i < count; i++)
+        frequencies.push_back(start + step * i);
+    return frequencies;
+}
+
+/* First LO changes when the radio follows the list in its own order,
+ * with or without keeping the current first LO. */
+size_t file_order_first_lo_changes(const std::vector<rf::Frequency>& frequencies, bool sticky) {
+    size_t changes = 0;
+    rf::Frequency first_lo = 0;
+    for (size_t pass = 0; pass < 2; pass++) {
+        for (auto f : frequencies) {
+            auto next = sticky ? tuning::config::create(f, first_lo).first_lo_frequency
+                               : tuning::config::create(f).first_lo_frequency;
+            if (pass == 1 && next != first_lo)
+                changes++;
+            first_lo = next;
+        }
+    }
+    return changes;
+}
+
+/* Channels per second for a list without activity: the old fixed 50ms
+ * dwell against settle + probe window + ~1ms of message/thread overhead. */
+double channels_per_second(size_t size, size_t first_lo_changes) {
+    const double overhead_us = 1000.0;
+    double total_us = 0;
+    total_us += first_lo_changes * (first_lo_settle_us + probe_window_us + overhead_us);
+    total_us += (size - first_lo_changes) * (second_lo_settle_us + probe_window_us + overhead_us);
+    return size * 1e6 / total_us;
+}
+
+void check_schedule(const std::vector<rf::Frequency>& frequencies, const char* name) {
+    ScanSchedule schedule{frequencies};
+    REQUIRE(schedule.size() == frequencies.size());
+
+    // A permutation, in ascending frequency order.
+    std::vector<size_t> seen(frequencies.size(), 0);
+    for (size_t i = 0; i < schedule.size(); i++) {
+        seen[schedule.index(i)]++;
+        if (i > 0)
+            CHECK(frequencies[schedule.index(i - 1)] <= frequencies[schedule.index(i)]);
+    }
+    CHECK(std::all_of(seen.begin(), seen.end(), [](size_t n) { return n == 1; }));
+
+    // The recorded first LO is what tuning would use for that channel.
+    rf::Frequency first_lo = schedule.first_lo(schedule.size() - 1);
+    for (size_t i = 0; i < schedule.size(); i++) {
+        auto config = tuning::config::create(frequencies[schedule.index(i)], first_lo);
+        CHECK(config.first_lo_frequency == schedule.first_lo(i));
+        first_lo = config.first_lo_frequency;
+    }
+
+    const auto nominal_changes = file_order_first_lo_changes(frequencies, false);
+    const auto file_changes = file_order_first_lo_changes(frequencies, true);
+    CHECK(file_changes <= nominal_changes);
+    CHECK(schedule.first_lo_changes() <= file_changes);
+
+    // Batches cover the positions in order and fit around their tune.
+    size_t next = 0;
+    for (size_t b = 0; b < schedule.batch_count(); b++) {
+        const auto& batch = schedule.batch(b);
+        CHECK(batch.first == next);
+        CHECK(batch.count >= 1);
+        CHECK(batch.count <= batch_max_channels);
+        CHECK(batch.spacing >= batch_min_spacing);
+        CHECK(batch.spacing <= batch_max_spacing);
+        for (size_t i = batch.first; i < batch.first + batch.count; i++) {
+            CHECK(schedule.batch_of(i) == b);
+            CHECK(std::abs(frequencies[schedule.index(i)] - batch.center) <= batch_max_offset);
+        }
+        next += batch.count;
+    }
+    CHECK(next == schedule.size());
+
+    MESSAGE(std::string{name}, ": quiet pass ", schedule.size(), " -> ", schedule.batch_count(), " tunes");
+    MESSAGE(std::string{name}, ": ", frequencies.size(), " channels, first LO changes ",
+            nominal_changes, " -> ", file_changes, " (sticky) -> ", schedule.first_lo_changes(), " (sorted)",
+            ", channels/s ", 1000.0 / 50, " -> ",
+            channels_per_second(schedule.size(), schedule.first_lo_changes()));
+}
+}  // namespace
+
+TEST_SUITE_BEGIN("Scan Schedule");
+
+TEST_CASE("Empty list gives an empty schedule.") {
+    ScanSchedule schedule{std::vector<rf::Frequency>{}};
+    CHECK(schedule.empty());
+    CHECK(schedule.first_lo_changes() == 0);
+}
+
+TEST_CASE("Schedule visits channels by frequency, keeping list indexes.") {
+    std::vector<rf::Frequency> frequencies{446'100'000, 433'500'000, 446'000'000, 433'500'000};
+    ScanSchedule schedule{frequencies};
+    REQUIRE(schedule.size() == 4);
+    CHECK(schedule.index(0) == 1);
+    CHECK(schedule.index(1) == 3);  // Stable for duplicates.
+    CHECK(schedule.index(2) == 2);
+    CHECK(schedule.index(3) == 0);
+}
+
+TEST_CASE("Neighbouring channels share the first LO.") {
+    auto pmr446 = channel_plan(446'006'250, 12'500, 16);
+    ScanSchedule schedule{pmr446};
+    CHECK(schedule.first_lo_changes() <= 1);
+}
+
+TEST_CASE("Close channels are measured from one tune.") {
+    ScanSchedule pmr446{channel_plan(446'006'250, 12'500, 16)};
+    REQUIRE(pmr446.batch_count() == 1);
+    CHECK(pmr446.batch(0).count == 16);
+    CHECK(pmr446.batch(0).spacing == 12'500);
+    CHECK(pmr446.batch(0).center == 446'100'000);
+
+    // 25kHz apart, 8 fit in the span.
+    ScanSchedule marine{channel_plan(156'050'000, 25'000, 57)};
+    CHECK(marine.batch_count() == 8);
+    CHECK(marine.batch(0).count == 8);
+    CHECK(marine.batch(7).count == 1);
+
+    ScanSchedule apart{{100'000'000, 200'000'000}};
+    CHECK(apart.batch_count() == 2);
+}
+
+TEST_CASE("Settle time depends on the first LO.") {
+    CHECK(settle_us(true) > settle_us(false));
+}
+
+TEST_CASE("Channel lists scan with fewer first LO changes.") {
+    check_schedule(channel_plan(446'006'250, 12'500, 16), "PMR446");
+    check_schedule(channel_plan(156'050'000, 25'000, 57), "Marine VHF");
+
+    // Airband, interleaved as a hand-edited list tends to be.
+    auto airband = channel_plan(118'000'000, 25'000, 760);
+    std::vector<rf::Frequency> interleaved;
+    for (size_t i = 0; i < airband.size(); i += 2)
+        interleaved.push_back(airband[i]);
+    for (size_t i = 1; i < airband.size(); i += 2)
+        interleaved.push_back(airband[i]);
+    check_schedule(interleaved, "Airband");
+
+    uint32_t seed = 1234;
+    std::vector<rf::Frequency> wide;
+    for (size_t i = 0; i < 200; i++) {
+        seed = seed * 1664525 + 1013904223;
+        wide.push_back(50'000'000 + (seed % 2'450'000) * 1000);
+    }
+    check_schedule(wide, "Random 50MHz-2.5GHz");
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "sweep_log.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace sweep_log;
+
+namespace {
+
+std::vector<uint8_t> levels(const size_t sweep, const size_t count) {
+    std::vector<uint8_t> v(count);
+    for (size_t i = 0; i < count; i++)
+        v[i] = static_cast<uint8_t>(sweep * 7 + i);
+    return v;
+}
+
+/* Logs count sweeps of bin_count bins, returning the file and the offset of each sweep. */
+std::vector<uint8_t> make_log(const size_t count, const uint16_t bin_count, const uint16_t interval, std::vector<uint32_t>& offsets, const bool finish = true) {
+    std::vector<uint8_t> file;
+    auto out = [&file](const void* p, const size_t n) {
+        auto b = static_cast<const uint8_t*>(p);
+        file.insert(file.end(), b, b + n);
+    };
+
+    Encoder encoder{interval};
+    encoder.begin(out);
+    for (size_t s = 0; s < count; s++) {
+        offsets.push_back(encoder.size());
+        const auto expected = file.size() + encoder.sweep_size(bin_count);
+        const SweepHeader header{
+            static_cast<uint32_t>(1709210096 + s),
+            static_cast<uint32_t>(s * 100),
+            100000000 + s,
+            200000000 + s,
+            416666,
+            bin_count,
+            0};
+        const auto bins = levels(s, bin_count);
+        encoder.sweep(header, bins.data(), out);
+        REQUIRE(file.size() == expected);
+    }
+    if (finish) {
+        const auto expected = file.size() + encoder.finish_size();
+        encoder.finish(out);
+        REQUIRE(file.size() == expected);
+    }
+    REQUIRE(file.size() == encoder.size());
+    return file;
+}
+
+void check_sweep(const Sweep& sweep, const size_t s, const uint16_t bin_count) {
+    CHECK(sweep.header.time == 1709210096 + s);
+    CHECK(sweep.header.uptime_ms == s * 100);
+    CHECK(sweep.header.start_frequency == 100000000 + s);
+    CHECK(sweep.header.stop_frequency == 200000000 + s);
+    CHECK(sweep.header.bin_width == 416666);
+    REQUIRE(sweep.header.bin_count == bin_count);
+    CHECK(std::vector<uint8_t>(sweep.bins, sweep.bins + bin_count) == levels(s, bin_count));
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("Sweep log");
+
+TEST_CASE("unix_time matches known dates") {
+    CHECK(unix_time(1970, 1, 1, 0, 0, 0) == 0);
+    CHECK(unix_time(2000, 1, 1, 0, 0, 0) == 946684800);
+    CHECK(unix_time(2024, 2, 29, 12, 34, 56) == 1709210096);
+    CHECK(unix_time(2099, 12, 31, 23, 59, 59) == 4102444799);
+}
+
+TEST_CASE("Records are padded to 4 bytes") {
+    CHECK(sweep_record_size(240) == 8 + 32 + 240);
+    CHECK(sweep_record_size(3) == 44);
+    CHECK(index_record_size(2) == 8 + 12 + 8);
+}
+
+TEST_CASE("Sweeps read back in order, with an index every interval and at the end") {
+    std::vector<uint32_t> offsets;
+    const auto file = make_log(70, 241, 32, offsets);
+
+    Reader reader{file.data(), file.size()};
+    REQUIRE(reader.valid());
+    CHECK(reader.index_interval() == 32);
+
+    Sweep sweep{};
+    size_t count = 0;
+    while (reader.next(sweep)) {
+        CHECK(sweep.offset == offsets[count]);
+        check_sweep(sweep, count, 241);
+        count++;
+    }
+    CHECK(count == 70);
+
+    CHECK(reader.indexed_sweeps() == offsets);
+
+    REQUIRE(reader.sweep_at(offsets[40], sweep));
+    check_sweep(sweep, 40, 241);
+    CHECK_FALSE(reader.sweep_at(offsets[40] + 4, sweep));
+}
+
+TEST_CASE("A log cut short reads up to its last complete record") {
+    std::vector<uint32_t> offsets;
+    const auto full = make_log(70, 240, 32, offsets, false);
+
+    // Cut in the middle of sweep 66, after the second index.
+    const size_t cut = offsets[66] + 100;
+    const std::vector<uint8_t> file(full.begin(), full.begin() + cut);
+
+    Reader reader{file.data(), file.size()};
+    Sweep sweep{};
+    size_t count = 0;
+    while (reader.next(sweep)) {
+        check_sweep(sweep, count, 240);
+        count++;
+    }
+    CHECK(count == 66);
+
+    const auto indexed = reader.indexed_sweeps();
+    CHECK(indexed == std::vector<uint32_t>(offsets.begin(), offsets.begin() + 64));
+}
+
+TEST_CASE("A damaged record stops the reader") {
+    std::vector<uint32_t> offsets;
+    auto file = make_log(10, 16, 4, offsets);
+    file[offsets[5]] ^= 0xff;  // Sync of sweep 5
+
+    Reader reader{file.data(), file.size()};
+    Sweep sweep{};
+    size_t count = 0;
+    while (reader.next(sweep))
+        count++;
+    CHECK(count == 5);
+}
+
+TEST_CASE("Not a sweep log") {
+    const std::vector<uint8_t> file(64, 0);
+    Reader reader{file.data(), file.size()};
+    Sweep sweep{};
+    CHECK_FALSE(reader.valid());
+    CHECK_FALSE(reader.next(sweep));
+    CHECK(reader.indexed_sweeps().empty());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "usb_serial_frame.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace serial_frame;
+
+namespace {
+
+struct Received {
+    Type type;
+    uint8_t sequence;
+    std::vector<uint8_t> payload;
+};
+
+std::vector<uint8_t> frame_bytes(const Type type, const uint8_t sequence, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> out(payload.size() + header_size + trailer_size);
+    out.resize(encode(type, sequence, payload.data(), payload.size(), out.data()));
+    return out;
+}
+
+std::vector<Received> decode_all(Decoder& decoder, const std::vector<uint8_t>& bytes) {
+    std::vector<Received> frames;
+    decoder.feed(bytes.data(), bytes.size(), [&frames](const Frame& f) {
+        frames.push_back({f.type, f.sequence, {f.payload, f.payload + f.length}});
+    });
+    return frames;
+}
+
+uint32_t lcg_state = 12345;
+
+uint32_t next_random() {
+    lcg_state = lcg_state * 1664525 + 1013904223;
+    return lcg_state >> 8;
+}
+
+std::vector<uint8_t> random_bytes(const size_t count) {
+    std::vector<uint8_t> v(count);
+    for (auto& b : v) b = next_random();
+    return v;
+}
+
+void append(std::vector<uint8_t>& to, const std::vector<uint8_t>& from) {
+    to.insert(to.end(), from.begin(), from.end());
+}
+
+} /* namespace */
+
+TEST_SUITE_BEGIN("USB serial framing");
+
+TEST_CASE("crc32 matches zlib and can be continued") {
+    const char* check = "123456789";
+    CHECK(crc32(check, 9) == 0xCBF43926);
+    CHECK(crc32(check + 4, 5, crc32(check, 4)) == 0xCBF43926);
+    CHECK(crc32(check, 0) == 0);
+}
+
+TEST_CASE("Frames round trip through the decoder") {
+    const auto empty = std::vector<uint8_t>{};
+    const auto full = random_bytes(max_payload);
+    const auto text = std::vector<uint8_t>{'/', 'A', '.', 'T', 'X', 'T'};
+
+    std::vector<uint8_t> stream;
+    append(stream, frame_bytes(Type::Get, 0, text));
+    append(stream, frame_bytes(Type::Data, 255, full));
+    append(stream, frame_bytes(Type::Ack, 7, empty));
+
+    SUBCASE("in one go") {
+        Decoder decoder;
+        const auto frames = decode_all(decoder, stream);
+        REQUIRE(frames.size() == 3);
+        CHECK(frames[0].type == Type::Get);
+        CHECK(frames[0].payload == text);
+        CHECK(frames[1].type == Type::Data);
+        CHECK(frames[1].sequence == 255);
+        CHECK(frames[1].payload == full);
+        CHECK(frames[2].type == Type::Ack);
+        CHECK(frames[2].sequence == 7);
+        CHECK(frames[2].payload.empty());
+        CHECK(decoder.errors() == 0);
+    }
+
+    SUBCASE("a byte at a time") {
+        Decoder decoder;
+        size_t count = 0;
+        for (const auto b : stream)
+            count += decode_all(decoder, {b}).size();
+        CHECK(count == 3);
+    }
+}
+
+TEST_CASE("The decoder resynchronises after damage") {
+    const auto a = frame_bytes(Type::Data, 1, random_bytes(100));
+    auto b = frame_bytes(Type::Data, 2, random_bytes(100));
+    const auto c = frame_bytes(Type::Data, 3, random_bytes(100));
+    b[50] ^= 0x10;
+
+    std::vector<uint8_t> stream{'o', 'k', '\r', '\n', 'P'};  // Shell output and a stray sync byte
+    append(stream, a);
+    append(stream, b);
+    append(stream, {'P', 'F', 0x20, 0, 0xff, 0xff});  // Length past max_payload
+    append(stream, c);
+
+    Decoder decoder;
+    const auto frames = decode_all(decoder, stream);
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[0].sequence == 1);
+    CHECK(frames[1].sequence == 3);
+    CHECK(decoder.errors() == 2);
+}
+
+TEST_CASE("SendWindow releases acked frames and numbers on past 255") {
+    SendWindow w;
+    const uint8_t payload[1] = {0};
+    for (size_t round = 0; round < 100; round++) {
+        while (!w.full())
+            w.push(Type::Data, payload, 1);
+        CHECK(w.pending() == window);
+        const uint8_t oldest = w.next_sequence() - window;
+        CHECK(w.at(0).data[3] == oldest);
+
+        CHECK_FALSE(w.ack(oldest - 1));  // Before the window
+        CHECK_FALSE(w.ack(w.next_sequence() + 1));
+        CHECK(w.ack(oldest + 1));
+        CHECK(w.pending() == window - 1);
+        CHECK(w.ack(w.next_sequence()));
+        CHECK(w.empty());
+    }
+}
+
+TEST_CASE("A lossy loopback delivers a stream intact with go back N") {
+    const auto source = random_bytes(100000);
+    std::vector<uint8_t> sink;
+
+    SendWindow w;
+    size_t position = 0;
+    bool ended = false;
+    uint8_t expected = 0;
+    size_t unacked = 0;
+    bool nak_sent = false;
+    bool complete = false;
+
+    Decoder to_receiver;
+    Decoder to_sender;
+    std::vector<uint8_t> receiver_wire;
+    std::vector<uint8_t> sender_wire;
+    size_t frames_sent = 0;
+    size_t frames_lost = 0;
+
+    auto transmit = [&](std::vector<uint8_t>& wire, const uint8_t* data, const size_t size) {
+        frames_sent++;
+        if (next_random() % 10 == 0) {
+            frames_lost++;
+            return;
+        }
+        wire.insert(wire.end(), data, data + size);
+    };
+
+    auto reply = [&](const Type type, const uint8_t sequence) {
+        uint8_t out[header_size + trailer_size];
+        transmit(sender_wire, out, encode(type, sequence, nullptr, 0, out));
+    };
+
+    size_t rounds = 0;
+    while (!(complete && ended && w.empty()) && rounds++ < 100000) {
+        // Sender fills its window.
+        while (!ended && !w.full()) {
+            const size_t length = std::min(max_payload, source.size() - position);
+            const auto& slot = length ? w.push(Type::Data, &source[position], length) : w.push(Type::End, nullptr, 0);
+            position += length;
+            ended = length == 0;
+            transmit(receiver_wire, slot.data.data(), slot.size);
+        }
+
+        // Receiver, as Session::receive_stream() does it.
+        std::vector<uint8_t> wire;
+        wire.swap(receiver_wire);
+        to_receiver.feed(wire.data(), wire.size(), [&](const Frame& f) {
+            if (f.sequence != expected) {
+                if (static_cast<uint8_t>(expected - f.sequence) <= window) {
+                    reply(Type::Ack, expected);
+                } else if (!nak_sent) {
+                    reply(Type::Nak, expected);
+                    nak_sent = true;
+                }
+                return;
+            }
+            nak_sent = false;
+            expected++;
+            if (f.type == Type::End) {
+                complete = true;
+                reply(Type::Ack, expected);
+                return;
+            }
+            sink.insert(sink.end(), f.payload, f.payload + f.length);
+            if (++unacked >= window / 2) {
+                reply(Type::Ack, expected);
+                unacked = 0;
+            }
+        });
+
+        // Sender takes the replies, or times out and goes back.
+        wire.clear();
+        wire.swap(sender_wire);
+        bool heard = false;
+        bool resend = false;
+        to_sender.feed(wire.data(), wire.size(), [&](const Frame& f) {
+            heard = true;
+            if (w.ack(f.sequence) && f.type == Type::Nak)
+                resend = true;
+        });
+        if (!heard || resend) {
+            for (size_t i = 0; i < w.pending(); i++)
+                transmit(receiver_wire, w.at(i).data.data(), w.at(i).size);
+        }
+    }
+
+    CHECK(complete);
+    CHECK(w.empty());
+    CHECK(sink == source);
+    CHECK(frames_lost > 0);
+    CHECK(to_receiver.errors() == 0);
+}
+
+TEST_CASE("RLE round trips screen lines within max_rle_size") {
+    std::vector<std::vector<uint16_t>> lines;
+    lines.push_back(std::vector<uint16_t>(240, 0x1234));  // Blank
+    std::vector<uint16_t> noise(240);
+    for (auto& p : noise) p = next_random();
+    lines.push_back(noise);
+    std::vector<uint16_t> pairs(240);  // Worst case mix of single pixels and runs of 2
+    for (size_t i = 0; i < pairs.size(); i++) pairs[i] = (i % 3 == 2) ? i : i / 3 * 3 + 1000;
+    lines.push_back(pairs);
+    std::vector<uint16_t> mixed(1000);
+    for (size_t i = 0; i < mixed.size(); i++) mixed[i] = (next_random() % 4 == 0) ? next_random() : mixed[i ? i - 1 : 0];
+    lines.push_back(mixed);
+    lines.push_back({42});
+
+    for (const auto& line : lines) {
+        std::vector<uint8_t> encoded(max_rle_size(line.size()));
+        const size_t size = rle_encode(line.data(), line.size(), encoded.data());
+        CHECK(size <= max_rle_size(line.size()));
+
+        std::vector<uint16_t> decoded(line.size());
+        CHECK(rle_decode(encoded.data(), size, decoded.data(), decoded.size()) == line.size());
+        CHECK(decoded == line);
+    }
+
+    std::vector<uint8_t> encoded(max_rle_size(240));
+    CHECK(rle_encode(lines[0].data(), 240, encoded.data()) == 6);
+    uint16_t small[10];
+    CHECK(rle_decode(encoded.data(), 6, small, 10) == 0);  // Doesn't fit
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "adsb_demod.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Checks for the Mode S CRC, syndrome error correction and the ADS-B
+ * demodulator. The demodulator is fed a synthetic 2 Msps C8 capture with
+ * known frames; set ADSB_C8_CAPTURE to the path of a recorded .C8 capture
+ * (2 Msps, 1090 MHz) to also time and report on real traffic.
+ */
+
+using namespace adsb;
+
+namespace {
+
+constexpr size_t block_size = 2048;
+
+/* The original bit-serial CRC from ADSBFrame, kept as the reference. */
+uint32_t reference_crc(const uint8_t* const data, const size_t length) {
+    uint8_t adsb_crc[14] = {0};
+    const uint32_t crc_poly = 0x1205FFF;
+    memcpy(adsb_crc, data, length - 3);
+
+    for (size_t c = 0; c < length - 3; c++) {
+        for (size_t b = 0; b < 8; b++) {
+            if ((adsb_crc[c] << b) & 0x80) {
+                for (size_t s = 0; s < 25; s++) {
+                    const size_t bitn = (c * 8) + b + s;
+                    if ((crc_poly >> s) & 1) adsb_crc[bitn >> 3] ^= (0x80 >> (bitn & 7));
+                }
+            }
+        }
+    }
+
+    const size_t n = length - 3;
+    return (adsb_crc[n] << 16) + (adsb_crc[n + 1] << 8) + adsb_crc[n + 2];
+}
+
+struct Lcg {
+    uint32_t state;
+
+    uint32_t operator()() {
+        state = state * 1664525 + 1013904223;
+        return state >> 8;
+    }
+};
+
+ADSBFrame make_frame(Lcg& rng, const uint8_t df) {
+    ADSBFrame frame{};
+    frame.push_byte((df << 3) | 5);
+    for (size_t i = 1; i < ADSBFrame::length_for_DF(df); i++)
+        frame.push_byte(rng());
+    frame.make_CRC();
+    return frame;
+}
+
+/* PPM modulation at two samples per bit, random carrier phase per frame. */
+void modulate(std::vector<complex8_t>& out, size_t at, const ADSBFrame& frame, const double amplitude, Lcg& rng) {
+    const double phase = (rng() & 0xFFFF) * (2 * M_PI / 65536.0);
+    const complex8_t hi{static_cast<int8_t>(std::lround(amplitude * std::cos(phase))),
+                        static_cast<int8_t>(std::lround(amplitude * std::sin(phase)))};
+
+    for (size_t i = 0; i < 16; i++) {
+        if (adsb_preamble[i]) out[at + i] = hi;
+    }
+    at += 16;
+
+    const auto data = frame.get_raw_data();
+    for (size_t bit = 0; bit < frame.length() * 8; bit++) {
+        const bool one = (data[bit >> 3] >> (7 - (bit & 7))) & 1;
+        out[at + bit * 2 + (one ? 0 : 1)] = hi;
+    }
+}
+
+void add_noise(std::vector<complex8_t>& v, Lcg& rng, const int level) {
+    for (auto& s : v) {
+        const int re = s.real() + static_cast<int>(rng() % (2 * level + 1)) - level;
+        const int im = s.imag() + static_cast<int>(rng() % (2 * level + 1)) - level;
+        s = {static_cast<int8_t>(std::max(-127, std::min(127, re))),
+             static_cast<int8_t>(std::max(-127, std::min(127, im)))};
+    }
+}
+
+struct Received {
+    std::vector<ADSBFrame> frames;
+    size_t bad{0};
+};
+
+Received demodulate(std::vector<complex8_t>& capture, Demodulator::Statistics* stats = nullptr, double* msps = nullptr) {
+    Received received{};
+    Demodulator demod{[&received](const ADSBFrame& frame, const uint32_t) {
+        ADSBFrame copy = frame;
+        if (copy.check_CRC())
+            received.frames.push_back(copy);
+        else
+            received.bad++;
+    }};
+    demod.reset();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i + block_size <= capture.size(); i += block_size) {
+        const buffer_c8_t buffer{&capture[i], block_size, 2000000};
+        demod.execute(buffer);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    if (msps) *msps = capture.size() / std::chrono::duration<double>(end - start).count() / 1e6;
+    if (stats) *stats = demod.statistics();
+    return received;
+}
+
+bool same_frame(const ADSBFrame& a, const ADSBFrame& b) {
+    return memcmp(a.get_raw_data(), b.get_raw_data(), ADSBFrame::long_length) == 0;
+}
+
+} /* namespace */
+
+TEST_CASE("crc24 matches the bit-serial Mode S CRC") {
+    Lcg rng{1};
+    for (size_t i = 0; i < 200; i++) {
+        const auto frame = make_frame(rng, (i & 1) ? 17 : 11);
+        const auto data = frame.get_raw_data();
+        CHECK(crc24(data, frame.length() - 3) == reference_crc(data, frame.length()));
+        CHECK(crc_syndrome(data, frame.length()) == 0);
+    }
+}
+
+TEST_CASE("correct_bit_errors repairs single and double bit errors") {
+    Lcg rng{2};
+    for (size_t i = 0; i < 500; i++) {
+        const uint8_t df = (i % 3 == 0) ? 11 : 17;
+        const auto good = make_frame(rng, df);
+        const size_t bits = good.length() * 8;
+
+        auto bad = good;
+        const size_t bit1 = 5 + rng() % (bits - 5);
+        bad.get_raw_data()[bit1 >> 3] ^= 0x80 >> (bit1 & 7);
+        REQUIRE_FALSE(bad.check_CRC());
+        CHECK(correct_bit_errors(bad.get_raw_data(), bad.length(), 1) == 1);
+        CHECK(same_frame(bad, good));
+
+        if (df == 17) {
+            size_t bit2 = bit1;
+            while (bit2 == bit1) bit2 = 5 + rng() % (bits - 5);
+            bad.get_raw_data()[bit1 >> 3] ^= 0x80 >> (bit1 & 7);
+            bad.get_raw_data()[bit2 >> 3] ^= 0x80 >> (bit2 & 7);
+            CHECK(bad.correct_errors());
+            CHECK(same_frame(bad, good));
+        }
+    }
+}
+
+TEST_CASE("correct_bit_errors leaves the DF field alone") {
+    Lcg rng{3};
+    auto frame = make_frame(rng, 17);
+    frame.get_raw_data()[0] ^= 0x40;  // DF 17 -> DF 25
+    CHECK(correct_bit_errors(frame.get_raw_data(), ADSBFrame::long_length, 1) == -1);
+}
+
+TEST_CASE("Demodulator decodes DF11 and DF17 frames") {
+    Lcg rng{4};
+    std::vector<complex8_t> capture(block_size * 64);
+    std::vector<ADSBFrame> sent{};
+
+    // One frame every 300us, some with a corrupted bit, straddling block edges.
+    for (size_t at = 100; at + 300 < capture.size(); at += 600) {
+        const uint8_t df = (sent.size() % 4 == 3) ? 11 : 17;
+        auto frame = make_frame(rng, df);
+        sent.push_back(frame);
+
+        if (sent.size() % 5 == 0) {
+            const size_t bit = 8 + rng() % (frame.length() * 8 - 8);
+            frame.get_raw_data()[bit >> 3] ^= 0x80 >> (bit & 7);
+        }
+        modulate(capture, at, frame, 60.0 + (rng() % 40), rng);
+    }
+    add_noise(capture, rng, 3);
+
+    Demodulator::Statistics stats{};
+    const auto received = demodulate(capture, &stats);
+
+    // False preambles inside frames may add some bad frames, but every sent frame must come out.
+    CHECK(received.frames.size() == sent.size());
+    CHECK(stats.frames_corrected == sent.size() / 5);
+    for (size_t i = 0; i < std::min(sent.size(), received.frames.size()); i++) {
+        CHECK(same_frame(received.frames[i], sent[i]));
+    }
+}
+
+TEST_CASE("Demodulator throughput") {
+    std::vector<complex8_t> capture{};
+
+    const char* const path = std::getenv("ADSB_C8_CAPTURE");
+    std::ifstream file{path ? path : "", std::ios::binary};
+    if (file) {
+        file.seekg(0, std::ios::end);
+        capture.resize(static_cast<size_t>(file.tellg()) / sizeof(complex8_t) / block_size * block_size);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(capture.data()), capture.size() * sizeof(complex8_t));
+    } else {
+        // About one second of moderately busy air.
+        Lcg rng{5};
+        capture.resize(block_size * 1024);
+        for (size_t at = 0; at + 300 < capture.size(); at += 1000 + rng() % 4000)
+            modulate(capture, at, make_frame(rng, (rng() & 3) ? 17 : 11), 20.0 + rng() % 100, rng);
+        add_noise(capture, rng, 6);
+    }
+
+    Demodulator::Statistics stats{};
+    double msps = 0;
+    const auto received = demodulate(capture, &stats, &msps);
+
+    MESSAGE(std::string{file ? "capture" : "synthetic"} << ": " << msps << " Msps, " << stats.preambles << " preambles, " << stats.frames << " frames, " << stats.frames_valid << " valid, " << stats.frames_corrected << " corrected");
+    CHECK(received.frames.size() == stats.frames_valid + stats.frames_corrected);
+}
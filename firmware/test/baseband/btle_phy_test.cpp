@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "btle_phy.hpp"
+#include "doctest.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace btle;
+
+namespace {
+
+uint32_t lcg_state = 12345;
+
+uint32_t next_random() {
+    lcg_state = lcg_state * 1664525 + 1013904223;
+    return lcg_state >> 8;
+}
+
+/* Bit at a time, the way the spec draws the LFSR. */
+uint32_t crc24_bitwise(const std::vector<uint8_t>& data, uint32_t crc) {
+    for (const auto byte : data) {
+        for (size_t bit = 0; bit < 8; bit++) {
+            const uint32_t feedback = (crc ^ (byte >> bit)) & 1;
+            crc >>= 1;
+            if (feedback)
+                crc ^= 0xDA6000;
+        }
+    }
+    return crc;
+}
+
+size_t feed_bits(AccessAddressCorrelator& correlator, const uint32_t value, const size_t bits) {
+    size_t hits = 0;
+    for (size_t i = 0; i < bits; i++)
+        hits += correlator.feed((value >> i) & 1) ? 1 : 0;
+    return hits;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("BTLE PHY");
+
+TEST_CASE("Dewhitening sequence matches the advertising channels") {
+    // First bytes of the sequences from the former per channel table.
+    const uint8_t channel_0[] = {64, 178, 188, 195, 31, 55, 74, 95};
+    const uint8_t channel_37[] = {141, 210, 87, 161, 61, 167, 102, 176};
+    const uint8_t channel_38[] = {214, 197, 68, 32, 89, 222, 225, 143};
+    const uint8_t channel_39[] = {31, 55, 74, 95, 133, 246, 156, 154};
+    const struct {
+        uint8_t channel;
+        const uint8_t* expected;
+    } cases[] = {{0, channel_0}, {37, channel_37}, {38, channel_38}, {39, channel_39}};
+
+    for (const auto& c : cases) {
+        Dewhitener dewhitener;
+        dewhitener.configure(c.channel);
+        for (size_t i = 0; i < 8; i++)
+            CHECK(dewhitener.sequence()[i] == c.expected[i]);
+    }
+}
+
+TEST_CASE("Dewhitening is its own inverse at any offset") {
+    Dewhitener dewhitener;
+    dewhitener.configure(38);
+
+    std::vector<uint8_t> pdu(Dewhitener::max_length);
+    for (auto& b : pdu) b = next_random();
+    auto whitened = pdu;
+    for (size_t i = 0; i < whitened.size(); i++)
+        whitened[i] ^= dewhitener.sequence()[i];
+
+    // Header and payload separately, as the processor does, with an odd split.
+    dewhitener.apply(&whitened[0], 0, 2);
+    dewhitener.apply(&whitened[2], 2, whitened.size() - 2);
+    CHECK(whitened == pdu);
+
+    // Nothing past the longest PDU is touched.
+    std::vector<uint8_t> tail(8, 0xAA);
+    dewhitener.apply(tail.data(), Dewhitener::max_length - 3, tail.size());
+    CHECK(tail[2] != 0xAA);
+    CHECK(tail[3] == 0xAA);
+}
+
+TEST_CASE("Slicing by 4 CRC-24 matches the bitwise one") {
+    for (size_t length = 0; length < 48; length++) {
+        std::vector<uint8_t> data(length);
+        for (auto& b : data) b = next_random();
+        const uint32_t init = next_random() & 0xFFFFFF;
+        CHECK(crc24(data.data(), data.size(), init) == crc24_bitwise(data, init));
+    }
+}
+
+TEST_CASE("Access address correlator tolerates the configured bit errors") {
+    AccessAddressCorrelator exact{advertising_access_address, 0};
+    AccessAddressCorrelator tolerant{advertising_access_address, 1};
+
+    // Not before 32 bits are in, even if the register happens to match.
+    CHECK(feed_bits(exact, advertising_access_address, 31) == 0);
+
+    exact.reset();
+    CHECK(feed_bits(exact, 0x55555555, 16) == 0);  // Preamble
+    CHECK(feed_bits(exact, advertising_access_address, 32) == 1);
+    CHECK(exact.errors() == 0);
+
+    for (size_t flip = 0; flip < 32; flip++) {
+        const uint32_t one_error = advertising_access_address ^ (1u << flip);
+        exact.reset();
+        tolerant.reset();
+        CHECK(feed_bits(exact, 0x55555555, 32) == 0);
+        CHECK(feed_bits(tolerant, 0x55555555, 32) == 0);
+        CHECK(feed_bits(exact, one_error, 32) == 0);
+        CHECK(feed_bits(tolerant, one_error, 32) == 1);
+        CHECK(tolerant.errors() == 1);
+
+        const uint32_t two_errors = one_error ^ (1u << ((flip + 7) % 32));
+        tolerant.reset();
+        CHECK(feed_bits(tolerant, two_errors, 32) == 0);
+    }
+}
+
+TEST_SUITE_END();
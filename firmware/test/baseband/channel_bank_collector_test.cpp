@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "channel_bank_collector.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_fir_taps.hpp"
+#include "doctest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t channel_rate = 384000;
+constexpr size_t buffer_size = 256;  // NFM/AM decim_0 output per DMA buffer
+
+template <typename T>
+std::vector<T> make_tone(const uint32_t sampling_rate, const double frequency, const double amplitude, const size_t count) {
+    std::vector<T> v(count);
+    for (size_t i = 0; i < count; i++) {
+        const double p = 2 * M_PI * frequency * i / sampling_rate;
+        v[i] = {static_cast<typename T::value_type>(std::lround(amplitude * std::cos(p))),
+                static_cast<typename T::value_type>(std::lround(amplitude * std::sin(p)))};
+    }
+    return v;
+}
+
+struct Bank {
+    ChannelBankCollector bank{};
+    MultiChannelStatistics last{};
+    size_t reports{0};
+
+    Bank(const std::vector<int32_t>& offsets, const uint32_t spacing) {
+        bank.configure(offsets.data(), offsets.size(), spacing, channel_rate);
+        bank.restart(1, 0, 0);
+    }
+
+    void feed(std::vector<complex16_t>& samples) {
+        for (size_t i = 0; i + buffer_size <= samples.size(); i += buffer_size) {
+            const buffer_c16_t buffer{&samples[i], buffer_size, channel_rate};
+            bank.feed(buffer, [this](const MultiChannelStatistics& statistics) {
+                last = statistics;
+                reports++;
+            });
+        }
+    }
+};
+
+}  // namespace
+
+TEST_SUITE_BEGIN("Channel bank");
+
+TEST_CASE("Block length follows the channel spacing.") {
+    const std::vector<int32_t> offsets{0};
+    CHECK(Bank{offsets, 12500}.bank.block_length() == 31);
+    CHECK(Bank{offsets, 25000}.bank.block_length() == 15);
+    CHECK(Bank{offsets, 1000}.bank.block_length() == ChannelBankCollector::max_block_length);
+    CHECK(Bank{offsets, 200000}.bank.block_length() == ChannelBankCollector::min_block_length);
+}
+
+TEST_CASE("Nothing is measured without channels.") {
+    Bank b{{}, 12500};
+    auto tone = make_tone<complex16_t>(channel_rate, 0, 16384, channel_rate / 5);
+    b.feed(tone);
+    CHECK_FALSE(b.bank.enabled());
+    CHECK(b.reports == 0);
+}
+
+TEST_CASE("A tone is reported in its channel only.") {
+    const std::vector<int32_t> offsets{-25000, -12500, 0, 12500, 25000};
+    Bank b{offsets, 12500};
+
+    // Half scale, +12.5kHz: -6dB in channel 3.
+    auto tone = make_tone<complex16_t>(channel_rate, 12500, 16384, channel_rate / 10 + buffer_size);
+    b.feed(tone);
+
+    REQUIRE(b.reports == 1);
+    CHECK(b.last.channel_count == offsets.size());
+    CHECK(b.last.epoch == 1);
+    CHECK(b.last.max_db[3] == doctest::Approx(-6).epsilon(0.1));
+    for (auto c : {0, 1, 2, 4})
+        CHECK(b.last.max_db[c] < b.last.max_db[3] - 25);
+}
+
+TEST_CASE("Restart skips the settle time and reports the probe window.") {
+    Bank b{{0}, 12500};
+    b.bank.restart(7, 1000, 2000);
+
+    auto tone = make_tone<complex16_t>(channel_rate, 0, 16384, 16 * buffer_size);
+    b.feed(tone);
+
+    // 1000 skipped, then the first report once 2000 samples were measured.
+    REQUIRE(b.reports == 1);
+    CHECK(b.last.epoch == 7);
+    CHECK(b.last.count == 12 * buffer_size - 1000);
+}
+
+TEST_CASE("Channels across the NFM front end read alike.") {
+    // Same path as proc_nfm_audio: c8 at 3.072MHz, fs/4 shift and decimation by 8.
+    constexpr uint32_t baseband_rate = 3072000;
+    constexpr int32_t span = 96000;
+    const std::vector<int32_t> offsets{-span, -span / 2, 0, span / 2, span};
+
+    std::vector<int16_t> levels;
+    for (size_t channel = 0; channel < offsets.size(); channel++) {
+        dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0{};
+        decim_0.configure(taps_11k0_decim_0.taps);
+        Bank b{offsets, span / 2};
+        b.bank.restart(1, buffer_size, 0);  // Decimator start up
+
+        auto input = make_tone<complex8_t>(baseband_rate, baseband_rate / 4 + offsets[channel], 64, baseband_rate / 8);
+        std::vector<complex16_t> out(buffer_size);
+        for (size_t i = 0; i + 2048 <= input.size(); i += 2048) {
+            const buffer_c8_t src{&input[i], 2048, baseband_rate};
+            const auto decimated = decim_0.execute(src, {out.data(), out.size()});
+            b.bank.feed(decimated, [&b](const MultiChannelStatistics& statistics) {
+                b.last = statistics;
+                b.reports++;
+            });
+        }
+
+        REQUIRE(b.reports > 0);
+        for (size_t c = 0; c < offsets.size(); c++) {
+            if (c != channel)
+                CHECK(b.last.max_db[c] < b.last.max_db[channel] - 25);
+        }
+        levels.push_back(b.last.max_db[channel]);
+    }
+
+    MESSAGE("Tone level across +/-96kHz: ", levels[0], " ", levels[1], " ", levels[2], " ", levels[3], " ", levels[4], " dB");
+    for (auto level : levels)
+        CHECK(std::abs(level - levels[2]) <= 3);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dsp_channelizer.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_fir_taps.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+using namespace dsp::channelize;
+
+namespace {
+
+constexpr uint32_t sampling_rate = 800000;  // 3.2MHz after the FS/4 decimate by 4
+constexpr size_t M = PolyphaseChannelizer::channels_count;
+constexpr double channel_width = static_cast<double>(sampling_rate) / M;
+
+std::vector<complex16_t> make_tone(const double frequency, const double amplitude, const size_t count) {
+    std::vector<complex16_t> v(count);
+    for (size_t i = 0; i < count; i++) {
+        const double p = 2 * M_PI * frequency * i / sampling_rate;
+        v[i] = {static_cast<int16_t>(std::lround(amplitude * std::cos(p))),
+                static_cast<int16_t>(std::lround(amplitude * std::sin(p)))};
+    }
+    return v;
+}
+
+/* Runs the bank and returns the frames after the filter filled up. */
+std::vector<std::vector<std::complex<float>>> channelize(std::vector<complex16_t>& input) {
+    PolyphaseChannelizer channelizer{};
+    std::vector<std::vector<std::complex<float>>> frames;
+    for (size_t i = 0; i + 512 <= input.size(); i += 512) {
+        channelizer.execute({&input[i], 512, sampling_rate}, [&frames](const complex16_t* channels) {
+            frames.emplace_back(M);
+            for (size_t c = 0; c < M; c++)
+                frames.back()[c] = {static_cast<float>(channels[c].real()), static_cast<float>(channels[c].imag())};
+        });
+    }
+    frames.erase(frames.begin(), frames.begin() + PolyphaseChannelizer::taps_per_channel);
+    return frames;
+}
+
+float level_db(const std::vector<std::vector<std::complex<float>>>& frames, const size_t c) {
+    float power = 0;
+    for (const auto& f : frames)
+        power += std::norm(f[c]);
+    return 10 * std::log10(power / frames.size() / (32768.0f * 32768.0f) + 1e-20f);
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("Polyphase channelizer");
+
+TEST_CASE("Offsets map to the closest channel.") {
+    CHECK(PolyphaseChannelizer::channel_for(0, sampling_rate) == 0);
+    CHECK(PolyphaseChannelizer::channel_for(12500, sampling_rate) == 1);
+    CHECK(PolyphaseChannelizer::channel_for(18000, sampling_rate) == 1);
+    CHECK(PolyphaseChannelizer::channel_for(-12500, sampling_rate) == M - 1);
+    CHECK(PolyphaseChannelizer::channel_for(-19000, sampling_rate) == M - 2);
+}
+
+TEST_CASE("A tone comes out of its channel only.") {
+    for (const int channel : {0, 3, -7, 20}) {
+        auto input = make_tone(channel * channel_width, 16384, M * 64);
+        const auto frames = channelize(input);
+        const size_t c = channel & (M - 1);
+
+        CHECK(level_db(frames, c) == doctest::Approx(-6.0).epsilon(0.05));
+        float worst = -200;
+        for (size_t other = 0; other < M; other++) {
+            if (other != c)
+                worst = std::max(worst, level_db(frames, other));
+        }
+        MESSAGE("Tone in channel ", channel, ": strongest other channel ", worst, " dB");
+        CHECK(worst < -6 - 50);
+    }
+}
+
+TEST_CASE("Neighbouring channels cross at -6dB.") {
+    auto input = make_tone(2.5 * channel_width, 16384, M * 64);
+    const auto frames = channelize(input);
+    CHECK(level_db(frames, 2) == doctest::Approx(-12.0).epsilon(0.1));
+    CHECK(level_db(frames, 3) == doctest::Approx(-12.0).epsilon(0.1));
+}
+
+TEST_CASE("Channel outputs keep the offset within the channel.") {
+    // 2kHz above the center of channel 5, output at channel_width samples/s.
+    constexpr double offset = 2000;
+    auto input = make_tone(5 * channel_width + offset, 16384, M * 128);
+    const auto frames = channelize(input);
+
+    double phase_sum = 0;
+    for (size_t i = 1; i < frames.size(); i++)
+        phase_sum += std::arg(frames[i][5] * std::conj(frames[i - 1][5]));
+    const double measured = phase_sum / (frames.size() - 1) / (2 * M_PI) * channel_width;
+    CHECK(measured == doctest::Approx(offset).epsilon(0.01));
+}
+
+TEST_CASE("The front end passes the inner channels flat.") {
+    // Tones at the capture rate, fs/4 above the tune like in Mode::Capture.
+    constexpr uint32_t capture_rate = sampling_rate * 4;
+    dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0{};
+    decim_0.configure(taps_channelizer_decim_0.taps);
+
+    float reference = 0;
+    for (const int channel : {0, 10, -10, 21, -22}) {
+        std::vector<complex8_t> input(M * 64 * 4);
+        for (size_t i = 0; i < input.size(); i++) {
+            const double p = 2 * M_PI * (capture_rate / 4 + channel * channel_width) * i / capture_rate;
+            input[i] = {static_cast<int8_t>(std::lround(100 * std::cos(p))),
+                        static_cast<int8_t>(std::lround(100 * std::sin(p)))};
+        }
+
+        std::vector<complex16_t> decimated(input.size() / 4);
+        for (size_t i = 0; i < input.size(); i += 2048)
+            decim_0.execute({&input[i], 2048, capture_rate}, {&decimated[i / 4], 512, sampling_rate});
+
+        const auto level = level_db(channelize(decimated), channel & (M - 1));
+        if (channel == 0)
+            reference = level;
+        MESSAGE("Channel ", channel, ": ", level - reference, " dB");
+        CHECK(std::abs(level - reference) < 1.0f);
+    }
+}
+
+TEST_CASE("Benchmark") {
+    auto input = make_tone(3 * channel_width, 16384, M * 2048);
+    PolyphaseChannelizer channelizer{};
+    size_t frames = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < 8; n++) {
+        for (size_t i = 0; i + 512 <= input.size(); i += 512)
+            channelizer.execute({&input[i], 512, sampling_rate}, [&frames](const complex16_t*) { frames++; });
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    MESSAGE("Channelizer: ", elapsed.count() / (input.size() * 8), " ns/sample (host), ", frames, " frames");
+    CHECK(frames == input.size() * 8 / M);
+}
+
+TEST_SUITE_END();
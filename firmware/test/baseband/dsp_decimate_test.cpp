@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_decimate.hpp"
+#include "dsp_fir_taps.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+/* Regression and throughput checks for the receive front-end decimators.
+ * Each decimator is fed the same synthetic stream in DMA-sized blocks; the
+ * output is reduced to a checksum that was captured from the current code,
+ * so any change in the arithmetic (or in the host SIMD fallbacks) shows up.
+ */
+
+namespace {
+
+constexpr size_t block_size = 2048;
+constexpr size_t block_count = 16;
+constexpr uint32_t sampling_rate = 3072000;
+
+/* Two tones and some LFSR noise, scaled to the requested full scale. */
+template <typename T>
+std::vector<T> make_stream(const double full_scale) {
+    std::vector<T> v(block_size * block_count);
+    uint32_t lfsr = 0xdeadbeef;
+    for (size_t i = 0; i < v.size(); i++) {
+        lfsr = lfsr * 1664525 + 1013904223;
+        const double noise = static_cast<int32_t>(lfsr) / 2147483648.0;
+        const double p1 = 2 * M_PI * 0.0113 * i;
+        const double p2 = 2 * M_PI * -0.271 * i;
+        const double re = 0.5 * std::cos(p1) + 0.3 * std::cos(p2) + 0.1 * noise;
+        const double im = 0.5 * std::sin(p1) + 0.3 * std::sin(p2) - 0.1 * noise;
+        v[i] = {static_cast<typename T::value_type>(std::lround(re * full_scale)),
+                static_cast<typename T::value_type>(std::lround(im * full_scale))};
+    }
+    return v;
+}
+
+std::vector<int16_t> make_real_stream() {
+    std::vector<int16_t> v(block_size * block_count);
+    uint32_t lfsr = 0xcafef00d;
+    for (size_t i = 0; i < v.size(); i++) {
+        lfsr = lfsr * 1664525 + 1013904223;
+        const double noise = static_cast<int32_t>(lfsr) / 2147483648.0;
+        v[i] = std::lround((0.6 * std::sin(2 * M_PI * 0.0071 * i) + 0.1 * noise) * 32767);
+    }
+    return v;
+}
+
+/* FNV-1a over the raw output bytes. */
+uint32_t checksum(const void* const data, const size_t bytes, uint32_t hash) {
+    const uint8_t* const p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < bytes; i++) {
+        hash = (hash ^ p[i]) * 16777619;
+    }
+    return hash;
+}
+
+struct Result {
+    uint32_t checksum;
+    size_t output_count;
+    double msps;
+};
+
+/* Runs the stream through the decimator block by block, once for the
+ * checksum and then repeatedly for timing.
+ */
+template <typename Decimator, typename In, typename Out>
+Result run(Decimator& decimator, std::vector<In>& in) {
+    std::vector<Out> out(block_size);
+    Result result{2166136261, 0, 0};
+    for (size_t b = 0; b < block_count; b++) {
+        const buffer_t<In> src{&in[b * block_size], block_size, sampling_rate};
+        const buffer_t<Out> dst{out.data(), out.size()};
+        const auto r = decimator.execute(src, dst);
+        result.checksum = checksum(r.p, r.count * sizeof(Out), result.checksum);
+        result.output_count += r.count;
+    }
+
+    constexpr size_t rounds = 20;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < rounds; n++) {
+        for (size_t b = 0; b < block_count; b++) {
+            const buffer_t<In> src{&in[b * block_size], block_size, sampling_rate};
+            const buffer_t<Out> dst{out.data(), out.size()};
+            decimator.execute(src, dst);
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    result.msps = (rounds * in.size()) / seconds / 1e6;
+    return result;
+}
+
+template <typename Decimator, typename In, typename Out = complex16_t>
+Result check(const char* const name, Decimator& decimator, std::vector<In>& in, const uint32_t expected_checksum, const size_t decimation_factor) {
+    const auto result = run<Decimator, In, Out>(decimator, in);
+    MESSAGE(std::string{name} << ": " << result.msps << " Msps in, checksum " << result.checksum);
+    CHECK(result.output_count == in.size() / decimation_factor);
+    CHECK(result.checksum == expected_checksum);
+    return result;
+}
+
+} /* namespace */
+
+using namespace dsp::decimate;
+
+TEST_CASE("Complex8DecimateBy2CIC3 matches the CIC3 difference equation") {
+    auto in = make_stream<complex8_t>(127);
+    std::vector<complex16_t> out(block_size / 2);
+    Complex8DecimateBy2CIC3 decimator;
+    decimator.execute({in.data(), block_size, sampling_rate}, {out.data(), out.size()});
+
+    /* D0 = (s[n-3] + 3 * s[n-2] + 3 * s[n-1] + s[n]) * 32, history starts at zero. */
+    for (size_t k = 1; k < out.size(); k++) {
+        const size_t n = k * 2 + 1;
+        const int32_t i = in[n - 3].real() + 3 * in[n - 2].real() + 3 * in[n - 1].real() + in[n].real();
+        const int32_t q = in[n - 3].imag() + 3 * in[n - 2].imag() + 3 * in[n - 1].imag() + in[n].imag();
+        CHECK(out[k].real() == i * 32);
+        CHECK(out[k].imag() == q * 32);
+    }
+}
+
+TEST_CASE("Complex8DecimateBy2CIC3") {
+    auto in = make_stream<complex8_t>(127);
+    Complex8DecimateBy2CIC3 decimator;
+    check("Complex8DecimateBy2CIC3", decimator, in, 0xa08e672e, 2);
+}
+
+TEST_CASE("TranslateByFSOver4AndDecimateBy2CIC3") {
+    auto in = make_stream<complex8_t>(127);
+    TranslateByFSOver4AndDecimateBy2CIC3 decimator;
+    check("TranslateByFSOver4AndDecimateBy2CIC3", decimator, in, 0x0ecbcd39, 2);
+}
+
+TEST_CASE("DecimateBy2CIC3") {
+    auto in = make_stream<complex16_t>(32767);
+    DecimateBy2CIC3 decimator;
+    check("DecimateBy2CIC3", decimator, in, 0x485c6ce7, 2);
+}
+
+TEST_CASE("FIRC8xR16x24FS4Decim4") {
+    auto in = make_stream<complex8_t>(127);
+    FIRC8xR16x24FS4Decim4 decimator;
+    decimator.configure(taps_200k_wfm_decim_0.taps);
+    check("FIRC8xR16x24FS4Decim4", decimator, in, 0xfe4c70be, 4);
+}
+
+TEST_CASE("FIRC8xR16x24FS4Decim8") {
+    auto in = make_stream<complex8_t>(127);
+    FIRC8xR16x24FS4Decim8 decimator;
+    decimator.configure(taps_16k0_decim_0.taps);
+    check("FIRC8xR16x24FS4Decim8", decimator, in, 0x4f1c0c66, 8);
+}
+
+TEST_CASE("FIRC8xR16x24FS4Decim8 shifted up") {
+    auto in = make_stream<complex8_t>(127);
+    FIRC8xR16x24FS4Decim8 decimator;
+    decimator.configure(taps_16k0_decim_0.taps, c8_to_c32_sat_scalar, FIRC8xR16x24FS4Decim8::Shift::Up);
+    check("FIRC8xR16x24FS4Decim8 up", decimator, in, 0xa40b938a, 8);
+}
+
+TEST_CASE("FIRC16xR16x16Decim2") {
+    auto in = make_stream<complex16_t>(32767);
+    FIRC16xR16x16Decim2 decimator;
+    decimator.configure(taps_200k_wfm_decim_1.taps);
+    check("FIRC16xR16x16Decim2", decimator, in, 0x99b0819d, 2);
+}
+
+TEST_CASE("FIRC16xR16x32Decim8") {
+    auto in = make_stream<complex16_t>(32767);
+    FIRC16xR16x32Decim8 decimator;
+    decimator.configure(taps_16k0_decim_1.taps);
+    check("FIRC16xR16x32Decim8", decimator, in, 0x1b200dcb, 8);
+}
+
+TEST_CASE("FIRAndDecimateComplex") {
+    auto in = make_stream<complex16_t>(32767);
+    FIRAndDecimateComplex decimator;
+    decimator.configure(taps_2k8_usb_channel.taps, 4);
+    check("FIRAndDecimateComplex", decimator, in, 0xfd13e67e, 4);
+}
+
+TEST_CASE("FIR64AndDecimateBy2Real") {
+    auto in = make_real_stream();
+    FIR64AndDecimateBy2Real decimator;
+    decimator.configure(taps_64_lp_025_025.taps);
+    check<FIR64AndDecimateBy2Real, int16_t, int16_t>("FIR64AndDecimateBy2Real", decimator, in, 0x680d5a61, 2);
+}
+
+TEST_CASE("DecimateBy2CIC4Real") {
+    auto in = make_real_stream();
+    DecimateBy2CIC4Real decimator;
+    check<DecimateBy2CIC4Real, int16_t, int16_t>("DecimateBy2CIC4Real", decimator, in, 0xd03d1da2, 2);
+}
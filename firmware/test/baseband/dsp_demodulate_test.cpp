@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "dsp_demodulate.hpp"
+#include "fxpt_atan2.hpp"
+#include "doctest.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<complex16_t> make_tone(const size_t count, const double frequency, const double sampling_rate, const double amplitude) {
+    std::vector<complex16_t> v(count);
+    for (size_t i = 0; i < count; i++) {
+        const double p = 2 * M_PI * frequency * i / sampling_rate;
+        v[i] = {static_cast<int16_t>(std::lround(amplitude * std::cos(p))),
+                static_cast<int16_t>(std::lround(amplitude * std::sin(p)))};
+    }
+    return v;
+}
+
+}  // namespace
+
+TEST_CASE("AM demodulator returns the carrier magnitude") {
+    auto in = make_tone(64, 1000, 48000, 16384);
+    std::vector<float> out(in.size());
+    dsp::demodulate::AM am;
+    const auto result = am.execute({in.data(), in.size(), 48000}, {out.data(), out.size()});
+
+    CHECK(result.count == in.size());
+    for (const auto v : out) {
+        CHECK(v == doctest::Approx(0.5f).epsilon(0.001));
+    }
+}
+
+TEST_CASE("FM demodulator scales a tone offset by the deviation") {
+    constexpr float sampling_rate = 48000;
+    auto in = make_tone(64, 2500, sampling_rate, 20000);
+
+    dsp::demodulate::FM fm;
+    fm.configure(sampling_rate, 5000);
+
+    std::vector<float> out_f32(in.size());
+    fm.execute({in.data(), in.size(), 48000}, buffer_f32_t{out_f32.data(), out_f32.size()});
+    /* First sample is relative to the initial (zero) history. */
+    for (size_t i = 1; i < out_f32.size(); i++) {
+        CHECK(out_f32[i] == doctest::Approx(0.5f).epsilon(0.001));
+    }
+
+    std::vector<int16_t> out_s16(in.size());
+    fm.execute({in.data(), in.size(), 48000}, buffer_s16_t{out_s16.data(), out_s16.size()});
+    /* s16 output uses the 0.27 degree atan approximation. */
+    for (size_t i = 1; i < out_s16.size(); i++) {
+        CHECK(std::abs(out_s16[i] - 16384) < 256);
+    }
+}
+
+TEST_CASE("fxpt_atan2 is within 0.01 rad everywhere") {
+    for (int a = 0; a < 360; a += 7) {
+        const double angle = a * M_PI / 180.0;
+        const int16_t y = std::lround(30000 * std::sin(angle));
+        const int16_t x = std::lround(30000 * std::cos(angle));
+        const uint16_t result = fxpt_atan2(y, x);
+        const double expected = std::fmod(std::atan2(y, x) + 2 * M_PI, 2 * M_PI) * 32768.0 / M_PI;
+        double error = std::fabs(result - expected);
+        error = std::min(error, 65536.0 - error);
+        CHECK(error * M_PI / 32768.0 < 0.01);
+    }
+}
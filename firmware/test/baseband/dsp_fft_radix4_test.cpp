@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_fft_radix4.hpp"
+#include "dsp_fft.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+using complexd = std::complex<double>;
+
+std::vector<complexd> make_signal(const size_t n, const double amplitude) {
+    /* Two tones plus deterministic pseudo-random noise. */
+    std::vector<complexd> v(n);
+    uint32_t lfsr = 0x12345678;
+    for (size_t i = 0; i < n; i++) {
+        lfsr = lfsr * 1664525 + 1013904223;
+        const double noise = (static_cast<int32_t>(lfsr) / 2147483648.0) * 0.05;
+        const double p1 = 2 * M_PI * 5.0 * i / n;
+        const double p2 = 2 * M_PI * -17.3 * i / n;
+        v[i] = amplitude * (complexd{std::cos(p1), std::sin(p1)} * 0.6 +
+                            complexd{std::cos(p2), std::sin(p2)} * 0.3 +
+                            complexd{noise, -noise});
+    }
+    return v;
+}
+
+std::vector<complexd> reference_dft(const std::vector<complexd>& x) {
+    const size_t n = x.size();
+    std::vector<complexd> y(n);
+    for (size_t k = 0; k < n; k++) {
+        complexd acc{0, 0};
+        for (size_t i = 0; i < n; i++) {
+            const double a = -2 * M_PI * static_cast<double>((k * i) % n) / n;
+            acc += x[i] * complexd{std::cos(a), std::sin(a)};
+        }
+        y[k] = acc;
+    }
+    return y;
+}
+
+size_t bit_reversed(const size_t i, const size_t n) {
+    size_t r = 0;
+    for (size_t b = 1; b < n; b <<= 1) {
+        r = (r << 1) | ((i & b) ? 1 : 0);
+    }
+    return r;
+}
+
+/* Worst case error relative to the largest reference bin. */
+template <typename T>
+double relative_error(const T& result, const std::vector<complexd>& reference, const double scale) {
+    double peak = 0;
+    double error = 0;
+    for (size_t k = 0; k < reference.size(); k++) {
+        const complexd r{static_cast<double>(result[k].real()) * scale, static_cast<double>(result[k].imag()) * scale};
+        peak = std::max(peak, std::abs(reference[k]));
+        error = std::max(error, std::abs(r - reference[k]));
+    }
+    return error / peak;
+}
+
+template <typename F>
+double ns_per_point(const size_t n, F&& f) {
+    constexpr size_t rounds = 200;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; i++) {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * n);
+}
+
+template <size_t N>
+void check_float() {
+    const auto signal = make_signal(N, 1000.0);
+    const auto reference = reference_dft(signal);
+    std::array<std::complex<float>, N> data;
+    for (size_t i = 0; i < N; i++) {
+        data[i] = {static_cast<float>(signal[i].real()), static_cast<float>(signal[i].imag())};
+    }
+    dsp::fft::forward(data);
+    CHECK(relative_error(data, reference, 1.0) < 1e-5);
+}
+
+template <size_t N>
+void check_q15() {
+    const auto signal = make_signal(N, 20000.0);
+    const auto reference = reference_dft(signal);
+    std::array<complex16_t, N> data;
+    for (size_t i = 0; i < N; i++) {
+        data[i] = {static_cast<int16_t>(std::lround(signal[i].real())), static_cast<int16_t>(std::lround(signal[i].imag()))};
+    }
+    dsp::fft::forward(data);
+    /* Output is scaled by 1/N; allow a few LSBs of rounding per stage. */
+    CHECK(relative_error(data, reference, static_cast<double>(N)) < 1e-3);
+}
+
+template <size_t N>
+void check_against_current() {
+    const auto signal = make_signal(N, 1000.0);
+    std::array<std::complex<float>, N> current;
+    std::array<std::complex<float>, N> radix4;
+    for (size_t i = 0; i < N; i++) {
+        const std::complex<float> s{static_cast<float>(signal[i].real()), static_cast<float>(signal[i].imag())};
+        current[bit_reversed(i, N)] = s;
+        radix4[i] = s;
+    }
+    fft_c_preswapped(current, 0, log_2(N));
+    dsp::fft::forward(radix4);
+
+    double peak = 0;
+    double error = 0;
+    for (size_t k = 0; k < N; k++) {
+        peak = std::max(peak, static_cast<double>(std::abs(current[k])));
+        error = std::max(error, static_cast<double>(std::abs(current[k] - radix4[k])));
+    }
+    CHECK(error / peak < 1e-4);
+
+    const double t_current = ns_per_point(N, [&current]() { fft_c_preswapped(current, 0, log_2(N)); });
+    const double t_float = ns_per_point(N, [&radix4]() { dsp::fft::forward(radix4); });
+    std::array<complex16_t, N> q15{};
+    const double t_q15 = ns_per_point(N, [&q15]() { dsp::fft::forward(q15); });
+    MESSAGE("N=" << N << " ns/point: radix-2 float " << t_current << ", radix-4 float " << t_float << ", radix-4 Q15 " << t_q15);
+}
+
+} /* namespace */
+
+TEST_CASE("radix-4 float FFT matches reference DFT for all supported sizes") {
+    check_float<64>();
+    check_float<128>();
+    check_float<256>();
+    check_float<512>();
+    check_float<1024>();
+    check_float<2048>();
+}
+
+TEST_CASE("radix-4 Q15 FFT matches scaled reference DFT for all supported sizes") {
+    check_q15<64>();
+    check_q15<128>();
+    check_q15<256>();
+    check_q15<512>();
+    check_q15<1024>();
+    check_q15<2048>();
+}
+
+TEST_CASE("radix-4 Q15 FFT puts a full scale tone into a single bin") {
+    constexpr size_t N = 1024;
+    std::array<complex16_t, N> data;
+    for (size_t i = 0; i < N; i++) {
+        const double p = 2 * M_PI * 100 * i / N;
+        data[i] = {static_cast<int16_t>(std::lround(32767 * std::cos(p))), static_cast<int16_t>(std::lround(32767 * std::sin(p)))};
+    }
+    dsp::fft::forward(data);
+
+    CHECK(std::abs(data[100].real() - 32767) <= 16);
+    CHECK(std::abs(data[100].imag()) <= 16);
+    for (size_t k = 0; k < N; k++) {
+        if (k != 100) {
+            CHECK(std::abs(data[k].real()) <= 8);
+            CHECK(std::abs(data[k].imag()) <= 8);
+        }
+    }
+}
+
+TEST_CASE("radix-4 FFT matches the current radix-2 FFT and benchmark") {
+    check_against_current<64>();
+    check_against_current<128>();
+    check_against_current<256>();
+}
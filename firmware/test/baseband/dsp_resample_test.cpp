@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "dsp_resample.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/* Checks for the AudioTX polyphase interpolator and PCM reader, and a
+ * host-side comparison of the old per-sample stream read + zero-order hold
+ * against a block fetch + hold or polyphase interpolation per 2048 sample
+ * baseband buffer.
+ */
+
+namespace {
+
+constexpr uint32_t audio_fs = 192000;
+constexpr size_t baseband_count = 2048;
+constexpr size_t hold_factor = 8;
+constexpr size_t audio_count = baseband_count / hold_factor;
+
+std::vector<int16_t> make_tone(const uint32_t rate, const double frequency, const size_t count) {
+    std::vector<int16_t> v(count);
+    for (size_t i = 0; i < count; i++) {
+        v[i] = std::lround(0.5 * std::sin(2 * M_PI * frequency * i / rate) * 32767);
+    }
+    return v;
+}
+
+/* Runs src through the interpolator in baseband sized blocks, as AudioTX does. */
+std::vector<int16_t> interpolate(dsp::resample::PolyphaseInterpolator& resampler, const std::vector<int16_t>& src, const uint32_t rate, const size_t blocks) {
+    std::vector<int16_t> out(blocks * audio_count);
+    size_t in_pos = 0;
+    for (size_t b = 0; b < blocks; b++) {
+        const size_t needed = resampler.input_needed(audio_count);
+        REQUIRE(in_pos + needed <= src.size());
+        const buffer_s16_t in{const_cast<int16_t*>(&src[in_pos]), needed, rate};
+        resampler.execute(in, {&out[b * audio_count], audio_count, audio_fs});
+        in_pos += needed;
+    }
+    return out;
+}
+
+/* Input samples advanced per output, truncated to 16.16 as the interpolator does. */
+double step(const uint32_t rate) {
+    return static_cast<double>((static_cast<uint64_t>(rate) << 16) / audio_fs) / 65536.0;
+}
+
+/* Worst error against the ideal tone delayed by delay input samples,
+ * skipping the filter warm-up. */
+double max_error(const std::vector<int16_t>& out, const uint32_t rate, const double frequency, const double delay) {
+    double worst = 0;
+    for (size_t i = 64; i < out.size(); i++) {
+        const double t = i * step(rate) - delay;
+        const double ideal = 0.5 * std::sin(2 * M_PI * frequency * t / rate) * 32767;
+        worst = std::max(worst, std::fabs(out[i] - ideal));
+    }
+    return worst;
+}
+
+/* Stands in for StreamOutput: a virtual read over a byte buffer. */
+class FakeStream {
+   public:
+    FakeStream(const std::vector<uint8_t>& data)
+        : data{data} {
+    }
+    virtual ~FakeStream() = default;
+
+    virtual size_t read(void* const p, const size_t count) {
+        const size_t n = std::min(count, data.size() - pos);
+        std::memcpy(p, &data[pos], n);
+        pos = (pos + n) % data.size();
+        return n;
+    }
+
+   private:
+    const std::vector<uint8_t>& data;
+    size_t pos{0};
+};
+
+} /* namespace */
+
+using namespace dsp::resample;
+
+TEST_CASE("PolyphaseInterpolator has unity DC gain on every phase") {
+    PolyphaseInterpolator resampler;
+    resampler.configure(44100, audio_fs);
+
+    const std::vector<int16_t> dc(4096, 10000);
+    const auto out = interpolate(resampler, dc, 44100, 16);
+    for (size_t i = 64; i < out.size(); i++) {
+        CHECK(std::abs(out[i] - 10000) <= 2);
+    }
+}
+
+TEST_CASE("PolyphaseInterpolator consumes exactly what input_needed reports") {
+    for (const uint32_t rate : {8000U, 11025U, 22050U, 44100U, 48000U, 96000U, 192000U, 352800U, 384000U}) {
+        PolyphaseInterpolator resampler;
+        resampler.configure(rate, audio_fs);
+
+        size_t total = 0;
+        for (size_t b = 0; b < 100; b++) {
+            const size_t needed = resampler.input_needed(audio_count);
+            REQUIRE(needed <= audio_count * PolyphaseInterpolator::max_step);
+            total += needed;
+            std::vector<int16_t> in(needed, 0);
+            std::vector<int16_t> out(audio_count);
+            if (b & 1)
+                resampler.execute({in.data(), needed, rate}, {out.data(), out.size(), audio_fs});
+            else
+                resampler.hold({in.data(), needed, rate}, {out.data(), out.size(), audio_fs});
+        }
+
+        // 16.16 step truncation makes the long term rate slightly low.
+        const double expected = 100.0 * audio_count * rate / audio_fs;
+        CHECK(total <= expected + 1);
+        CHECK(total >= expected * 0.9999 - 1);
+    }
+}
+
+TEST_CASE("PolyphaseInterpolator tracks a tone closer than zero-order hold") {
+    constexpr uint32_t rate = 22050;
+    constexpr double frequency = 3000;
+    const auto tone = make_tone(rate, frequency, 8192);
+
+    PolyphaseInterpolator resampler;
+    resampler.configure(rate, audio_fs);
+    const auto out = interpolate(resampler, tone, rate, 100);
+
+    // Zero-order hold of the same tone to the same rate.
+    std::vector<int16_t> zoh(out.size());
+    for (size_t i = 0; i < zoh.size(); i++) {
+        zoh[i] = tone[static_cast<size_t>(i * step(rate))];
+    }
+
+    /* The interpolator output lags by half the filter span plus the sample
+     * shifted in ahead of each window; a hold lags by half a sample on average. */
+    const double delay = PolyphaseInterpolator::taps_count / 2 + 1;
+    const double polyphase_error = max_error(out, rate, frequency, delay);
+    const double zoh_error = max_error(zoh, rate, frequency, 0.5);
+    MESSAGE("max error, polyphase: " << polyphase_error << ", zero-order hold: " << zoh_error);
+    CHECK(polyphase_error < zoh_error / 4);
+}
+
+TEST_CASE("PolyphaseInterpolator hold repeats the last input consumed") {
+    constexpr uint32_t rate = 44100;
+    const auto tone = make_tone(rate, 1000, 8192);
+
+    PolyphaseInterpolator resampler;
+    resampler.configure(rate, audio_fs);
+
+    std::vector<int16_t> out(100 * audio_count);
+    size_t in_pos = 0;
+    for (size_t b = 0; b < 100; b++) {
+        const size_t needed = resampler.input_needed(audio_count);
+        resampler.hold({const_cast<int16_t*>(&tone[in_pos]), needed, rate}, {&out[b * audio_count], audio_count, audio_fs});
+        in_pos += needed;
+    }
+
+    // Output i shows the input consumed by the outputs before it.
+    const uint32_t step16 = (static_cast<uint64_t>(rate) << 16) / audio_fs;
+    for (size_t i = 1; i < out.size(); i++) {
+        const size_t consumed = (static_cast<uint64_t>(i) * step16) >> 16;
+        CHECK(out[i] == (consumed ? tone[consumed - 1] : 0));
+    }
+}
+
+TEST_CASE("PCMReader reads 32-bit stereo at 48kHz for every buffer") {
+    constexpr size_t frame_size = 8;
+    constexpr size_t blocks = 200;
+
+    // At 192kHz a buffer needs more frames than one read block holds.
+    for (const uint32_t rate : {48000U, 192000U}) {
+        // Left carries the tone, right its inverse at half level, in the top 16 bits.
+        const auto tone = make_tone(rate, 1000, rate);
+        std::vector<uint8_t> wav(tone.size() * frame_size);
+        for (size_t i = 0; i < tone.size(); i++) {
+            const int32_t left = static_cast<int32_t>(tone[i]) * 65536 + 0x1234;
+            const int32_t right = -static_cast<int32_t>(tone[i] / 2) * 65536;
+            std::memcpy(&wav[i * frame_size], &left, 4);
+            std::memcpy(&wav[i * frame_size + 4], &right, 4);
+        }
+        FakeStream stream{wav};
+
+        dsp::resample::PCMReader reader;
+        reader.configure(4, 2);
+        PolyphaseInterpolator resampler;
+        resampler.configure(rate, audio_fs);
+
+        std::array<int16_t, audio_count * PolyphaseInterpolator::max_step> input{};
+        std::array<int16_t, audio_count> block{};
+        size_t decoded = 0;
+        for (size_t b = 0; b < blocks; b++) {
+            const size_t needed = resampler.input_needed(audio_count);
+            REQUIRE(needed <= input.size());
+            CHECK(reader.read(stream, input.data(), needed) == needed);
+
+            for (size_t n = 0; n < needed; n++, decoded++) {
+                const int16_t t = tone[decoded % tone.size()];
+                CHECK(std::abs(input[n] - (t - t / 2) / 2) <= 1);
+            }
+            resampler.hold({input.data(), needed, rate}, {block.data(), block.size(), audio_fs});
+        }
+        CHECK(decoded == blocks * audio_count * rate / audio_fs);
+    }
+}
+
+TEST_CASE("PCMReader reads silence past the end of the stream") {
+    class ShortStream {
+       public:
+        size_t read(void* const p, const size_t count) {
+            const size_t n = std::min<size_t>(count, 10);
+            std::memset(p, 0x7f, n);
+            return n;
+        }
+    } stream;
+
+    dsp::resample::PCMReader reader;
+    reader.configure(2, 1);
+    std::vector<int16_t> out(100, 1);
+    CHECK(reader.read(stream, out.data(), out.size()) == 5);
+    for (size_t i = 0; i < out.size(); i++)
+        CHECK(out[i] == (i < 5 ? 0x7f7f : 0));
+}
+
+TEST_CASE("AudioTX block fetch + polyphase vs per-sample read + zero-order hold") {
+    constexpr uint32_t rate = 44100;
+    constexpr size_t buffers = 20000;
+
+    const auto tone = make_tone(rate, 1000, 44100);
+    std::vector<uint8_t> wav(tone.size() * 2);
+    std::memcpy(wav.data(), tone.data(), wav.size());
+
+    int32_t sink = 0;
+
+    // The previous loop: 16.16 accumulator, one stream read per input sample.
+    FakeStream old_stream{wav};
+    const uint32_t resample_inc = (static_cast<uint64_t>(rate) << 16) / (audio_fs * hold_factor);
+    uint32_t resample_acc = 0;
+    uint32_t audio_sample = 0;
+    const auto old_start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < buffers; b++) {
+        for (size_t i = 0; i < baseband_count; i++) {
+            resample_acc += resample_inc;
+            if (resample_acc >= 0x10000) {
+                resample_acc -= 0x10000;
+                audio_sample = 0;
+                old_stream.read(&audio_sample, 2);
+            }
+            sink += static_cast<int16_t>(audio_sample) / 256;
+        }
+    }
+    const auto old_end = std::chrono::steady_clock::now();
+
+    // Block fetch, then hold or interpolate, then hold for the baseband.
+    const auto block_run = [&](const bool interpolate) {
+        FakeStream stream{wav};
+        dsp::resample::PCMReader reader;
+        reader.configure(2, 1);
+        PolyphaseInterpolator resampler;
+        resampler.configure(rate, audio_fs);
+        std::array<int16_t, audio_count * PolyphaseInterpolator::max_step> input{};
+        std::array<int16_t, audio_count> block{};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t b = 0; b < buffers; b++) {
+            const size_t needed = resampler.input_needed(audio_count);
+            reader.read(stream, input.data(), needed);
+            if (interpolate)
+                resampler.execute({input.data(), needed, rate}, {block.data(), block.size(), audio_fs});
+            else
+                resampler.hold({input.data(), needed, rate}, {block.data(), block.size(), audio_fs});
+            for (const auto audio_sample : block) {
+                for (size_t h = 0; h < hold_factor; h++)
+                    sink += audio_sample / 256;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(end - start).count() / buffers;
+    };
+    const double hold_us = block_run(false);
+    const double polyphase_us = block_run(true);
+
+    const double old_us = std::chrono::duration<double, std::micro>(old_end - old_start).count() / buffers;
+    MESSAGE("per 2048 sample buffer, per-sample read + ZOH: " << old_us << " us, block + hold: " << hold_us << " us, block + polyphase: " << polyphase_us << " us (host)");
+    CHECK(sink != 0);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_spectrum.hpp"
+#include "doctest.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace dsp::spectrum;
+
+namespace {
+
+constexpr size_t N = PowerAverager::fft_size;
+using Window = PowerAverager::Window;
+using Detector = PowerAverager::Detector;
+
+/* Tone at a frequency in bins, with a random-ish phase per frame. */
+std::vector<complex8_t> make_tone(const double bin, const double amplitude, const double phase) {
+    std::vector<complex8_t> v(N);
+    for (size_t i = 0; i < N; i++) {
+        const double p = 2 * M_PI * bin * i / N + phase;
+        v[i] = {static_cast<int8_t>(std::lround(amplitude * std::cos(p))),
+                static_cast<int8_t>(std::lround(amplitude * std::sin(p)))};
+    }
+    return v;
+}
+
+uint32_t lcg_state = 1;
+
+int8_t noise(const int32_t amplitude) {
+    lcg_state = lcg_state * 1664525U + 1013904223U;
+    return static_cast<int8_t>(static_cast<int32_t>(lcg_state >> 24) * amplitude / 128 - amplitude);
+}
+
+std::vector<complex8_t> make_noise(const int32_t amplitude) {
+    std::vector<complex8_t> v(N);
+    for (auto& s : v) s = {noise(amplitude), noise(amplitude)};
+    return v;
+}
+
+float db(const float power) {
+    return 10.0f * std::log10(std::max(power, 1e-12f));
+}
+
+/* Worst bin at least guard bins away from a tone on bin, relative to the tone bin. */
+float leakage(const PowerAverager& averager, const size_t bin, const size_t guard) {
+    const float tone = averager.power(bin, Detector::Average);
+    float worst = 0.0f;
+    for (size_t k = 0; k < N; k++) {
+        const size_t d = std::min((k - bin) & (N - 1), (bin - k) & (N - 1));
+        if (d >= guard) worst = std::max(worst, averager.power(k, Detector::Average));
+    }
+    return db(worst) - db(tone);
+}
+
+/* Spread of the bin powers, in dB, of white noise averaged over frames. */
+float spread(const size_t frames) {
+    PowerAverager averager{};
+    for (size_t f = 0; f < frames; f++) {
+        const auto v = make_noise(100);
+        averager.accumulate(v.data());
+    }
+    float mean = 0.0f;
+    for (size_t k = 0; k < N; k++) mean += averager.power(k, Detector::Average);
+    mean /= N;
+    float var = 0.0f;
+    for (size_t k = 0; k < N; k++) {
+        const float d = averager.power(k, Detector::Average) - mean;
+        var += d * d;
+    }
+    return std::sqrt(var / N) / mean;
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("dsp::spectrum::PowerAverager");
+
+TEST_CASE("A tone centred on a bin reads its level relative to full scale whatever the window") {
+    for (const auto window : {Window::Rectangular, Window::Hann, Window::BlackmanHarris}) {
+        PowerAverager averager{};
+        averager.set_window(window);
+        const auto v = make_tone(40, 64, 0.3);
+        averager.accumulate(v.data());
+
+        CHECK(averager.frames() == 1);
+        CHECK(db(averager.power(40, Detector::Average)) == doctest::Approx(20 * std::log10(64.0 / 128.0)).epsilon(0.02));
+    }
+}
+
+TEST_CASE("Windowing keeps an off-bin tone from leaking over the spectrum") {
+    PowerAverager rectangular{};
+    rectangular.set_window(Window::Rectangular);
+    PowerAverager blackman_harris{};
+    blackman_harris.set_window(Window::BlackmanHarris);
+
+    for (size_t f = 0; f < 16; f++) {
+        const auto v = make_tone(40.5, 120, f * 0.7);
+        rectangular.accumulate(v.data());
+        blackman_harris.accumulate(v.data());
+    }
+
+    CHECK(leakage(rectangular, 40, 16) > -45.0f);
+    CHECK(leakage(blackman_harris, 40, 16) < -60.0f);
+}
+
+TEST_CASE("Averaging frames narrows the spread of the noise floor") {
+    const float one = spread(1);
+    const float many = spread(64);
+
+    // Power of one frame spreads as much as its mean, averaging n frames divides that by sqrt(n).
+    CHECK(one > 0.7f);
+    CHECK(many < one / 5.0f);
+}
+
+TEST_CASE("Peak holds a tone present in a single frame that the average dilutes") {
+    PowerAverager averager{};
+    for (size_t f = 0; f < 16; f++) {
+        const auto v = (f == 5) ? make_tone(100, 100, 0) : make_noise(2);
+        averager.accumulate(v.data());
+    }
+
+    const float peak = db(averager.power(100, Detector::Peak));
+    const float average = db(averager.power(100, Detector::Average));
+    CHECK(peak == doctest::Approx(20 * std::log10(100.0 / 128.0)).epsilon(0.05));
+    CHECK(peak - average == doctest::Approx(10 * std::log10(16.0)).epsilon(0.05));
+
+    for (size_t k = 0; k < N; k++) {
+        CHECK(averager.power(k, Detector::Peak) >= averager.power(k, Detector::Average));
+    }
+
+    averager.clear();
+    CHECK(averager.frames() == 0);
+    CHECK(averager.power(100, Detector::Peak) == 0.0f);
+}
+
+TEST_CASE("The display scale keeps a 1 LSB noise floor above 0 and clamps strong tones") {
+    PowerAverager averager{};
+    averager.set_window(Window::BlackmanHarris);
+    for (size_t f = 0; f < 16; f++) {
+        const auto v = make_noise(2);
+        averager.accumulate(v.data());
+    }
+
+    for (size_t k = 0; k < N; k++) {
+        const auto level = display_level(averager.power(k, Detector::Average));
+        CHECK(level > 0);
+        CHECK(level < 128);
+    }
+
+    CHECK(display_level(1.0f) == 255);
+    CHECK(display_level(0.0f) == 0);
+}
+
+TEST_SUITE_END();
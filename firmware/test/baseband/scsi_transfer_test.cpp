@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "sd_over_usb/scsi_transfer.h"
+extern "C" {
+#include "sd_over_usb/diskio.h"
+}
+#include "doctest.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+/* RAM backed card and a bulk endpoint that completes a transfer when it is
+ * waited for, so buffers are only read or filled as late as the hardware
+ * could. Queueing a second transfer, or touching a buffer that is on the
+ * bus, is counted as a fault. */
+struct Simulation {
+    static constexpr uint32_t block_count = 1024;
+
+    std::vector<uint8_t> card = std::vector<uint8_t>(block_count * SCSI_BLOCK_SIZE);
+    std::vector<uint8_t> to_host{};
+    std::vector<uint8_t> from_host{};
+    size_t from_host_position{0};
+    uint32_t failing_lba{UINT32_MAX};
+
+    bool pending{false};
+    bool pending_send{false};
+    uint8_t* pending_data{nullptr};
+    uint32_t pending_length{0};
+    volatile bool* pending_done{nullptr};
+
+    size_t sd_commands{0};
+    size_t usb_transfers{0};
+    size_t overlapped{0};
+    size_t faults{0};
+
+    void card_access(const uint32_t startblk, const uint8_t* const buf, const uint32_t n) {
+        sd_commands++;
+        if (n == 0 || n > SCSI_TRANSFER_BLOCKS) faults++;
+        if (pending) {
+            overlapped++;
+            if (buf < pending_data + pending_length && pending_data < buf + n * SCSI_BLOCK_SIZE) faults++;
+        }
+        (void)startblk;
+    }
+
+    bool card_fails(const uint32_t startblk, const uint32_t n) const {
+        return startblk + n > block_count || (failing_lba >= startblk && failing_lba < startblk + n);
+    }
+
+    void start(const bool send, uint8_t* const data, const uint32_t length, volatile bool* const done) {
+        if (pending) faults++;
+        usb_transfers++;
+        pending = true;
+        pending_send = send;
+        pending_data = data;
+        pending_length = length;
+        pending_done = done;
+        *done = false;
+    }
+
+    void wait(volatile bool* const done) {
+        if (pending && done == pending_done) {
+            if (pending_send) {
+                to_host.insert(to_host.end(), pending_data, pending_data + pending_length);
+            } else {
+                if (from_host_position + pending_length > from_host.size()) faults++;
+                std::memcpy(pending_data, &from_host[from_host_position], pending_length);
+                from_host_position += pending_length;
+            }
+            pending = false;
+            *done = true;
+        }
+        if (!*done) faults++;  // Would spin forever
+    }
+};
+
+Simulation sim;
+
+std::vector<uint8_t> buffer_memory(2 * SCSI_TRANSFER_BYTES);
+uint8_t* const buffers[2] = {&buffer_memory[0], &buffer_memory[SCSI_TRANSFER_BYTES]};
+
+uint32_t lcg_state = 1;
+
+uint8_t next_byte() {
+    lcg_state = lcg_state * 1664525 + 1013904223;
+    return lcg_state >> 24;
+}
+
+void reset() {
+    sim = Simulation{};
+    for (auto& b : sim.card) b = next_byte();
+}
+
+std::vector<uint8_t> card_slice(const uint32_t lba, const uint32_t count) {
+    return {sim.card.begin() + lba * SCSI_BLOCK_SIZE, sim.card.begin() + (lba + count) * SCSI_BLOCK_SIZE};
+}
+
+size_t chunks(const uint32_t count) {
+    return (count + SCSI_TRANSFER_BLOCKS - 1) / SCSI_TRANSFER_BLOCKS;
+}
+
+} /* namespace */
+
+extern "C" {
+
+uint32_t get_capacity(void) {
+    return Simulation::block_count;
+}
+
+bool_t read_block(uint32_t startblk, uint8_t* buf, uint32_t n) {
+    sim.card_access(startblk, buf, n);
+    if (sim.card_fails(startblk, n)) return true;
+    std::memcpy(buf, &sim.card[startblk * SCSI_BLOCK_SIZE], n * SCSI_BLOCK_SIZE);
+    return false;
+}
+
+bool_t write_block(uint32_t startblk, uint8_t* buf, uint32_t n) {
+    sim.card_access(startblk, buf, n);
+    if (sim.card_fails(startblk, n)) return true;
+    std::memcpy(&sim.card[startblk * SCSI_BLOCK_SIZE], buf, n * SCSI_BLOCK_SIZE);
+    return false;
+}
+
+void usb_bulk_start_send(uint8_t* const data, const uint32_t length, volatile bool* const done) {
+    sim.start(true, data, length, done);
+}
+
+void usb_bulk_start_receive(uint8_t* const data, const uint32_t length, volatile bool* const done) {
+    sim.start(false, data, length, done);
+}
+
+void usb_bulk_wait(volatile bool* const done) {
+    sim.wait(done);
+}
+}
+
+TEST_SUITE_BEGIN("SCSI transfers");
+
+TEST_CASE("READ(10) streams multi-block chunks while the previous one is sent") {
+    for (const uint32_t count : {1, 15, 16, 17, 32, 100, 256}) {
+        reset();
+        const uint32_t lba = 7;
+
+        CHECK(scsi_transfer_read(lba, count, buffers) == 0);
+        CHECK(sim.to_host == card_slice(lba, count));
+        CHECK(sim.sd_commands == chunks(count));
+        CHECK(sim.usb_transfers == chunks(count));
+        CHECK(sim.overlapped == chunks(count) - 1);
+        CHECK(sim.faults == 0);
+        CHECK_FALSE(sim.pending);
+    }
+}
+
+TEST_CASE("WRITE(10) receives the next chunk while the card writes") {
+    for (const uint32_t count : {1, 15, 16, 17, 32, 100, 256}) {
+        reset();
+        const uint32_t lba = 300;
+        for (uint32_t i = 0; i < count * SCSI_BLOCK_SIZE; i++) sim.from_host.push_back(next_byte());
+        const auto before = sim.card;
+
+        CHECK(scsi_transfer_write(lba, count, buffers) == 0);
+        CHECK(card_slice(lba, count) == sim.from_host);
+        CHECK(std::equal(sim.card.begin(), sim.card.begin() + lba * SCSI_BLOCK_SIZE, before.begin()));
+        CHECK(std::equal(sim.card.begin() + (lba + count) * SCSI_BLOCK_SIZE, sim.card.end(), before.begin() + (lba + count) * SCSI_BLOCK_SIZE));
+        CHECK(sim.from_host_position == sim.from_host.size());
+        CHECK(sim.sd_commands == chunks(count));
+        CHECK(sim.usb_transfers == chunks(count));
+        CHECK(sim.overlapped == chunks(count) - 1);
+        CHECK(sim.faults == 0);
+    }
+}
+
+TEST_CASE("A whole card read takes a sixteenth of the per-block requests") {
+    reset();
+    const uint32_t count = Simulation::block_count;
+    CHECK(scsi_transfer_read(0, count, buffers) == 0);
+    CHECK(sim.sd_commands == count / SCSI_TRANSFER_BLOCKS);
+    CHECK(sim.usb_transfers == count / SCSI_TRANSFER_BLOCKS);
+    CHECK(sim.faults == 0);
+}
+
+TEST_CASE("Card errors fail the command but keep the host in step") {
+    reset();
+    sim.failing_lba = 40;
+    CHECK(scsi_transfer_read(0, 64, buffers) == 1);
+    CHECK(sim.to_host.size() == 64 * SCSI_BLOCK_SIZE);
+    CHECK(sim.faults == 0);
+
+    reset();
+    sim.failing_lba = 40;
+    sim.from_host.resize(64 * SCSI_BLOCK_SIZE);
+    CHECK(scsi_transfer_write(0, 64, buffers) == 1);
+    CHECK(sim.from_host_position == sim.from_host.size());
+    CHECK(sim.faults == 0);
+}
+
+TEST_CASE("Card errors leave MEDIUM ERROR sense until it is taken") {
+    reset();
+    scsi_transfer_take_sense();
+    CHECK(scsi_transfer_read(0, 64, buffers) == 0);
+    CHECK(scsi_transfer_take_sense().key == 0);
+
+    sim.failing_lba = 40;
+    CHECK(scsi_transfer_read(0, 64, buffers) == 1);
+    auto sense = scsi_transfer_take_sense();
+    CHECK(sense.key == SCSI_TRANSFER_SENSE_KEY_MEDIUM_ERROR);
+    CHECK(sense.asc == SCSI_TRANSFER_ASENSE_UNRECOVERED_READ_ERROR);
+    CHECK(sense.ascq == 0);
+
+    sense = scsi_transfer_take_sense();
+    CHECK(sense.key == 0);
+    CHECK(sense.asc == 0);
+
+    reset();
+    sim.failing_lba = 40;
+    sim.from_host.resize(64 * SCSI_BLOCK_SIZE);
+    CHECK(scsi_transfer_write(0, 64, buffers) == 1);
+    sense = scsi_transfer_take_sense();
+    CHECK(sense.key == SCSI_TRANSFER_SENSE_KEY_MEDIUM_ERROR);
+    CHECK(sense.asc == SCSI_TRANSFER_ASENSE_WRITE_ERROR);
+}
+
+TEST_CASE("Zero blocks transfer nothing") {
+    reset();
+    CHECK(scsi_transfer_read(0, 0, buffers) == 0);
+    CHECK(scsi_transfer_write(0, 0, buffers) == 0);
+    CHECK(sim.sd_commands == 0);
+    CHECK(sim.usb_transfers == 0);
+}
+
+TEST_SUITE_END();
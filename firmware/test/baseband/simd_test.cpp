@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "simd.hpp"
+#include "doctest.h"
+
+#include <climits>
+
+/* Expected values are worked out by hand from the ARMv7-M Architecture
+ * Reference Manual descriptions, so these hold the host fallbacks to the
+ * behaviour of the Cortex-M4 instructions.
+ */
+
+TEST_CASE("saturating intrinsics") {
+    CHECK(__SSAT(5, 16) == 5);
+    CHECK(__SSAT(40000, 16) == 32767);
+    CHECK(__SSAT(-40000, 16) == -32768);
+    CHECK(__SSAT(200, 8) == 127);
+    CHECK(__QADD(INT32_MAX, 1) == INT32_MAX);
+    CHECK(__QSUB(INT32_MIN, 1) == INT32_MIN);
+    CHECK(__QADD(-5, 3) == -2);
+    CHECK(__QADD16(0x7fff8000, 0x00010001) == 0x7fff8001);
+    CHECK(__QSUB16(0x80007fff, 0x0001ffff) == 0x80007fff);
+}
+
+TEST_CASE("packing and extension intrinsics") {
+    CHECK(__PKHBT(0x11112222, 0x33334444, 16) == 0x44442222);
+    CHECK(__PKHBT(0x11112222, 0x33334444, 0) == 0x33332222);
+    CHECK(__PKHTB(0x11112222, 0x80004444, 16) == 0x11118000);
+    CHECK(__PKHTB(0x11112222, 0x80004444, 0) == 0x11114444);
+    CHECK(__REV16(0x11223344) == 0x22114433);
+    CHECK(__RBIT(0x00000001) == 0x80000000);
+    CHECK(__RBIT(0x12345678) == 0x1e6a2c48);
+    CHECK(__BFI(0xffffffff, 0x1234, 16, 16) == 0x1234ffff);
+    CHECK(__BFI(0x00000000, 0xabcd, 4, 8) == 0x00000cd0);
+    CHECK(static_cast<uint32_t>(__SXTB16(0x80ff7f01, 0)) == 0xffff0001);
+    CHECK(static_cast<uint32_t>(__SXTB16(0x80ff7f01, 8)) == 0xff80007f);
+    CHECK(static_cast<uint32_t>(__SXTB16(0x80ff7f01, 24)) == 0x007fff80);
+    CHECK(__SXTH(0x8000ffff, 0) == -1);
+    CHECK(__SXTH(0x8000ffff, 16) == -32768);
+    CHECK(__SXTAH(100, 0x8000ffff, 16) == -32668);
+    CHECK(__SXTAH(100, 0x8000ffff, 0) == 99);
+}
+
+TEST_CASE("halving parallel intrinsics") {
+    CHECK(__SHADD16(0x00030005, 0x00010003) == 0x00020004);
+    CHECK(__SHSUB16(0x00010003, 0x00030005) == 0xffffffff);
+    CHECK(__SHADD16(0x80008000, 0x80008000) == 0x80008000);
+    CHECK(__SHASX(0x00040008, 0x00020006) == 0x00050003);
+    CHECK(__SHSAX(0x00040008, 0x00020006) == 0xffff0005);
+}
+
+TEST_CASE("multiply intrinsics") {
+    /* x = {lo -2, hi 3}, y = {lo 2, hi 5} */
+    const uint32_t x = 0x0003fffe;
+    const uint32_t y = 0x00050002;
+    CHECK(__SMULBB(x, y) == -4);
+    CHECK(__SMULBT(x, y) == -10);
+    CHECK(__SMULTB(x, y) == 6);
+    CHECK(__SMULTT(x, y) == 15);
+    CHECK(__SMLABB(x, y, 10) == 6);
+    CHECK(__SMLATB(x, y, 10) == 16);
+    CHECK(static_cast<int32_t>(__SMUAD(x, y)) == 11);
+    CHECK(static_cast<int32_t>(__SMUADX(x, y)) == -4);
+    CHECK(static_cast<int32_t>(__SMUSD(x, y)) == -19);
+    CHECK(static_cast<int32_t>(__SMUSDX(x, y)) == -16);
+    CHECK(static_cast<int32_t>(__SMLAD(x, y, 100)) == 111);
+    CHECK(static_cast<int32_t>(__SMLADX(x, y, 100)) == 96);
+    CHECK(static_cast<int32_t>(__SMLSD(x, y, 100)) == 81);
+    CHECK(__SMLALDX(0x00020003, 0x00040005, 10) == 32);
+    CHECK(__SMLSLD(0x00020003, 0x00040005, -100) == -93);
+    CHECK(__SMLALDX(0x80008000, 0x80008000, INT64_C(0x100000000)) == INT64_C(0x180000000));
+
+    /* Dual multiply-accumulate wraps at 32 bits like the hardware. */
+    CHECK(__SMLAD(0x80008000, 0x80008000, 0) == 0x80000000);
+}
+
+TEST_CASE("most significant word multiply rounds") {
+    CHECK(__SMMULR(0x40000000, 0x40000000) == 0x10000000);
+    CHECK(__SMMULR(1, static_cast<int32_t>(0x80000000)) == 0);
+    CHECK(__SMMULR(0x7fffffff, 0x7fffffff) == 0x3fffffff);
+    CHECK(__SMMULR(-0x40000000, 0x40000000) == -0x10000000);
+}
+
+TEST_CASE("vec2_s16 and vec4_s8 helpers") {
+    vec4_s8 v;
+    v.w = 0x04fe02ff;  // q1 = 4, i1 = -2, q0 = 2, i0 = -1
+
+    const auto i = sxtb16(v);
+    CHECK(i.v[0] == -1);
+    CHECK(i.v[1] == -2);
+    const auto q = sxtb16(v, 8);
+    CHECK(q.v[0] == 2);
+    CHECK(q.v[1] == 4);
+
+    CHECK(rev16(v).w == 0xfe04ff02);
+    CHECK(pkhbt(vec2_s16{1, 2}, vec2_s16{3, 4}, 16).w == vec2_s16(1, 3).w);
+    CHECK(pkhtb(vec2_s16{1, 2}, vec2_s16{3, 4}, 16).w == vec2_s16(4, 2).w);
+    CHECK(smlad(vec2_s16{2, 3}, vec2_s16{4, 5}, 1) == 24);
+    CHECK(smlsd(vec2_s16{2, 3}, vec2_s16{4, 5}, 1) == -6);
+}
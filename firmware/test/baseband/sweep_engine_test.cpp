@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2024 PortaPack Mayhem contributors
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "sweep_engine.hpp"
+#include "doctest.h"
+
+#include <vector>
+
+namespace {
+
+constexpr uint32_t sampling_rate = 20000000;
+constexpr size_t buffer_count = 2048;
+constexpr uint32_t budget = 1000000;  // Plenty, every step transforms right away
+
+/* Stands in for the M0: tunes every request at once and takes the batches
+ * unless the queue is marked full. */
+class FakeLink : public SweepLink {
+   public:
+    std::vector<uint16_t> requested_steps{};
+    std::vector<SweepBatchMessage> messages{};
+    bool queue_full{false};
+
+    uint32_t request(const uint16_t step) override {
+        requested_steps.push_back(step);
+        return ++requests;
+    }
+
+    bool tuned(const uint32_t request) const override {
+        return request == requests;
+    }
+
+    bool post(const SweepBatchMessage& message) override {
+        if (queue_full) return false;
+        messages.push_back(message);
+        return true;
+    }
+
+   private:
+    uint32_t requests{0};
+};
+
+struct Sweep {
+    dsp::spectrum::PowerAverager averager{};
+    FakeLink link{};
+    SweepEngine engine{averager, link};
+    std::vector<complex8_t> samples = std::vector<complex8_t>(buffer_count, {10, 0});
+
+    void configure(const uint16_t step_count, const uint32_t generation) {
+        engine.configure({1000000000, 1000000, step_count, 1, 0, generation}, sampling_rate);
+    }
+
+    void run(const size_t buffers) {
+        for (size_t i = 0; i < buffers; i++)
+            engine.execute({samples.data(), samples.size(), sampling_rate}, budget);
+    }
+
+    /* Steps of the posted batches in order, releasing them like the M0. */
+    std::vector<uint16_t> take(std::vector<size_t>* counts = nullptr) {
+        std::vector<uint16_t> steps;
+        for (const auto& message : link.messages) {
+            REQUIRE(message.batch->busy);
+            for (size_t i = 0; i < message.batch->count; i++)
+                steps.push_back(message.batch->spectra[i].step);
+            if (counts)
+                counts->push_back(message.batch->count);
+            message.batch->busy = false;
+        }
+        link.messages.clear();
+        return steps;
+    }
+};
+
+}  // namespace
+
+TEST_SUITE_BEGIN("SweepEngine");
+
+TEST_CASE("Slices are posted in batches, with the rest flushed at the end of a pass.") {
+    Sweep sweep;
+    sweep.configure(10, 1);
+
+    // Each step takes a buffer to see the retune and one to capture.
+    std::vector<uint16_t> steps;
+    std::vector<size_t> counts;
+    for (size_t i = 0; i < 2 * 20; i++) {
+        sweep.run(1);
+        const auto taken = sweep.take(&counts);
+        steps.insert(steps.end(), taken.begin(), taken.end());
+    }
+
+    const std::vector<size_t> expected_counts{4, 4, 2, 4, 4, 2};
+    CHECK(counts == expected_counts);
+    REQUIRE(steps.size() == 20);
+    for (size_t i = 0; i < steps.size(); i++)
+        CHECK(steps[i] == i % 10);
+
+    CHECK(sweep.link.requested_steps.front() == 0);
+    CHECK(sweep.link.requested_steps[10] == 0);
+}
+
+TEST_CASE("Spectra carry the frequency of their step.") {
+    Sweep sweep;
+    sweep.configure(3, 1);
+    sweep.run(2 * 3);
+
+    REQUIRE(sweep.link.messages.size() == 1);
+    const auto& batch = *sweep.link.messages[0].batch;
+    REQUIRE(batch.count == 3);
+    for (size_t i = 0; i < batch.count; i++)
+        CHECK(batch.spectra[i].center_frequency == 1000000000 + static_cast<int64_t>(i) * 1000000);
+}
+
+TEST_CASE("The sweep holds off while the M0 has both batches.") {
+    Sweep sweep;
+    sweep.configure(100, 1);
+    sweep.run(2 * 20);
+
+    // Two full batches posted and never released, nothing more is captured.
+    CHECK(sweep.link.messages.size() == 2);
+    const auto requests = sweep.link.requested_steps.size();
+    sweep.run(20);
+    CHECK(sweep.link.messages.size() == 2);
+    CHECK(sweep.link.requested_steps.size() == requests);
+
+    // Released, it carries on from the step after the last one posted.
+    const auto steps = sweep.take();
+    CHECK(steps.back() == 7);
+    sweep.run(2 * 4);
+    const auto next = sweep.take();
+    REQUIRE_FALSE(next.empty());
+    CHECK(next.front() == 8);
+}
+
+TEST_CASE("A batch the queue can't take is posted again later.") {
+    Sweep sweep;
+    sweep.configure(10, 1);
+
+    sweep.link.queue_full = true;
+    sweep.run(2 * 6);
+    CHECK(sweep.link.messages.empty());
+
+    // The unposted batch isn't marked busy and isn't overrun meanwhile.
+    sweep.link.queue_full = false;
+    sweep.run(1);
+    REQUIRE(sweep.link.messages.size() == 1);
+    CHECK(sweep.link.messages[0].batch->count == SweepBatch::max_spectra);
+
+    std::vector<uint16_t> steps = sweep.take();
+    sweep.run(2 * 10);
+    const auto more = sweep.take();
+    steps.insert(steps.end(), more.begin(), more.end());
+
+    // Nothing lost or repeated across the failed posts.
+    REQUIRE(steps.size() >= 10);
+    for (size_t i = 0; i < steps.size(); i++)
+        CHECK(steps[i] == i % 10);
+}
+
+TEST_CASE("A new plan starts with free batches and its own generation.") {
+    Sweep sweep;
+    sweep.configure(100, 1);
+    sweep.run(2 * 20);
+    REQUIRE(sweep.link.messages.size() == 2);
+    for (const auto& message : sweep.link.messages)
+        CHECK(message.generation == 1);
+
+    // The M0 still holds both batches of the old plan.
+    sweep.link.messages.clear();
+    sweep.configure(100, 2);
+    sweep.run(2 * 4);
+
+    REQUIRE(sweep.link.messages.size() == 1);
+    const auto& message = sweep.link.messages[0];
+    CHECK(message.generation == 2);
+    CHECK(message.batch->count == 4);
+    CHECK(message.batch->spectra[0].step == 0);
+}
+
+TEST_SUITE_END();
@@ -24,8 +24,31 @@
 # as a source.
 # -------------------------------------------------------------------------------------
 import csv
+import struct
 import unicodedata
+
+KEY_LENGTH=7
+RECORD_LENGTH=146
+BUCKET_COUNT=256
+
+# Must match DatabaseIndex::bucket_of() in firmware/application/database_index.hpp: the
+# first two characters of the key, each mapped to a monotonic nibble.
+def bucket_nibble(c):
+    if c < '0':
+        return 0
+    if c <= '9':
+        return ord(c) - ord('0')
+    if c < 'A':
+        return 9
+    if c <= 'F':
+        return ord(c) - ord('A') + 10
+    return 15
+
+def bucket_of(key):
+    return (bucket_nibble(key[0]) << 4) | bucket_nibble(key[1])
+
 icao24_codes=bytearray()
+buckets=[0] * (BUCKET_COUNT + 1)
 data=bytearray()
 row_count=0
 
@@ -49,6 +72,7 @@ with open('aircraftDatabase.csv', 'rt') as csv_file:
                 operator=row[9][:32].encode('ascii', 'ignore')
                 #padding
                 icao24_codes.extend(bytearray(icao24_code+'\0', encoding='ascii'))
+                buckets[bucket_of(icao24_code) + 1]+=1
                 registration_padding=bytearray('\0' * (9 - len(registration)), encoding='ascii')    
                 manufacturer_padding=bytearray('\0' * (33 - len(manufacturer)), encoding='ascii')
                 model_padding=bytearray('\0' * (33 - len(model)), encoding='ascii')
@@ -57,6 +81,11 @@ with open('aircraftDatabase.csv', 'rt') as csv_file:
                 operator_padding=bytearray('\0' * (33 - len(operator)), encoding='ascii')
                 data.extend(bytearray(registration+registration_padding+manufacturer+manufacturer_padding+model+model_padding+actype+actype_padding+owner+owner_padding+operator+operator_padding))
                 row_count+=1
-database.write(icao24_codes+data)
+# Header and bucket table (first record index of each bucket) let the
+# firmware go straight to the right part of the key index.
+for i in range(BUCKET_COUNT):
+    buckets[i + 1]+=buckets[i]
+header=struct.pack('<4sHHHHI', b'PPDB', 1, KEY_LENGTH, RECORD_LENGTH, BUCKET_COUNT, row_count)
+database.write(header+struct.pack('<%dI' % (BUCKET_COUNT + 1), *buckets)+icao24_codes+data)
 print("Total of", row_count, "ICAO codes stored in database")
 
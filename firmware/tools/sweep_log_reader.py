@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+#
+# Copyright (C) 2024 PortaPack Mayhem contributors
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+import sys
+import struct
+import datetime
+
+usage_message = """
+PortaPack sweep log reader
+
+Usage: <command> <log_path> [<csv_path>]
+       Dumps the sweeps of a Looking Glass SWEEP_????.PPS file as CSV rows:
+       time, start Hz, stop Hz, bin width Hz, then one dBFS value per bin.
+       Reads up to the last complete record of a file cut short.
+"""
+
+file_magic = 0x4C535050
+file_version = 1
+record_sync = 0x5753
+record_sweep = 1
+record_index = 2
+
+file_header = struct.Struct('<IHH8x')
+record_header = struct.Struct('<HBxI')
+sweep_header = struct.Struct('<IIQQIH2x')
+
+
+def read_sweeps(data):
+    if len(data) < file_header.size:
+        raise ValueError('file too short')
+    magic, version, index_interval = file_header.unpack_from(data, 0)
+    if magic != file_magic or version != file_version:
+        raise ValueError('not a sweep log')
+
+    offset = file_header.size
+    while offset + record_header.size <= len(data):
+        sync, record_type, size = record_header.unpack_from(data, offset)
+        if sync != record_sync or size < record_header.size or size % 4 or offset + size > len(data):
+            break  # Damaged or cut short
+
+        if record_type == record_sweep:
+            body = offset + record_header.size
+            time, uptime_ms, start, stop, bin_width, bin_count = sweep_header.unpack_from(data, body)
+            bins = data[body + sweep_header.size:body + sweep_header.size + bin_count]
+            yield time, uptime_ms, start, stop, bin_width, bins
+
+        offset += size
+
+
+def level_to_db(level):
+    # ChannelSpectrum scale, 0.2dB a step up to 255 at full scale.
+    return (level - 255) / 5.0
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(usage_message)
+        sys.exit(-1)
+
+    with open(sys.argv[1], 'rb') as f:
+        data = f.read()
+
+    out = open(sys.argv[2], 'w') if len(sys.argv) == 3 else sys.stdout
+    count = 0
+    for time, uptime_ms, start, stop, bin_width, bins in read_sweeps(data):
+        stamp = datetime.datetime.utcfromtimestamp(time).strftime('%Y-%m-%d %H:%M:%S')
+        row = [stamp, str(start), str(stop), str(bin_width)]
+        row += ['%.1f' % level_to_db(level) for level in bins]
+        out.write(','.join(row) + '\n')
+        count += 1
+
+    if out is not sys.stdout:
+        out.close()
+    print('%d sweeps' % count, file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
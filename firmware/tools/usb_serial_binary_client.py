@@ -0,0 +1,390 @@
+#!/usr/bin/env python3
+
+#
+# Copyright (C) 2024 PortaPack Mayhem contributors
+#
+# This file is part of PortaPack.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+import os
+import sys
+import time
+import struct
+import select
+import termios
+import tty
+import zlib
+
+usage_message = """
+PortaPack USB serial binary mode client (Linux)
+
+Usage: <command> <device> get <remote_path> <local_path>
+       <command> <device> put <local_path> <remote_path>
+       <command> <device> screen <png_path>
+       <command> <device> iq <local_path> [seconds]
+       Where device is the PortaPack serial port, e.g. /dev/ttyACM0.
+       iq writes the IQ of a running uC8 or uC16 capture to local_path, or to
+       stdout for "-", until Ctrl-C or for the given number of seconds.
+       Blocks the PortaPack had to drop are filled with zeros.
+       See firmware/application/usb_serial_frame.hpp for the framing.
+"""
+
+SYNC = b'PF'
+HEADER = struct.Struct('<2sBBH')
+MAX_PAYLOAD = 512
+WINDOW = 4
+ACK_TIMEOUT = 0.5
+DATA_TIMEOUT = 5.0
+MAX_RETRIES = 8
+
+ACK = 0x01
+NAK = 0x02
+ERROR = 0x03
+GET = 0x10
+PUT = 0x11
+SCREEN = 0x12
+IQ = 0x13
+EXIT = 0x1F
+DATA = 0x20
+END = 0x21
+IQ_INFO = 0x22
+IQ_DATA = 0x23
+
+IQ_INFO_FORMAT = struct.Struct('<QIBHII')
+IQ_DATA_HEADER = struct.Struct('<IH')
+
+SCREEN_WIDTH = 240
+SCREEN_HEIGHT = 320
+
+
+class ProtocolError(Exception):
+    pass
+
+
+def encode(frame_type, sequence, payload=b''):
+    header = HEADER.pack(SYNC, frame_type, sequence, len(payload))
+    crc = zlib.crc32(header[2:] + payload) & 0xffffffff
+    return header + payload + struct.pack('<I', crc)
+
+
+class Link:
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+        self.buffer = bytearray()
+
+    def close(self):
+        os.close(self.fd)
+
+    def write(self, data):
+        view = memoryview(data)
+        while view:
+            written = os.write(self.fd, view)
+            view = view[written:]
+
+    def read_some(self, timeout):
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return False
+        self.buffer += os.read(self.fd, 4096)
+        return True
+
+    def shell(self, command):
+        self.write(command.encode() + b'\r\n')
+        deadline = time.monotonic() + DATA_TIMEOUT
+        while b'ok\r\n' not in self.buffer:
+            if not self.read_some(deadline - time.monotonic()):
+                raise ProtocolError('no reply to ' + command)
+        del self.buffer[:self.buffer.index(b'ok\r\n') + 4]
+
+    def send(self, frame_type, sequence, payload=b''):
+        self.write(encode(frame_type, sequence, payload))
+
+    def parse(self):
+        while True:
+            start = self.buffer.find(SYNC)
+            if start < 0:
+                del self.buffer[:max(0, len(self.buffer) - 1)]
+                return None
+            del self.buffer[:start]
+            if len(self.buffer) < HEADER.size:
+                return None
+            _, frame_type, sequence, length = HEADER.unpack_from(self.buffer)
+            size = HEADER.size + length + 4
+            if length > MAX_PAYLOAD:
+                del self.buffer[:1]
+                continue
+            if len(self.buffer) < size:
+                return None
+            (crc,) = struct.unpack_from('<I', self.buffer, size - 4)
+            if zlib.crc32(self.buffer[2:size - 4]) & 0xffffffff != crc:
+                del self.buffer[:1]
+                continue
+            payload = bytes(self.buffer[HEADER.size:size - 4])
+            del self.buffer[:size]
+            return frame_type, sequence, payload
+
+    def receive(self, timeout):
+        deadline = time.monotonic() + timeout
+        while True:
+            frame = self.parse()
+            if frame:
+                return frame
+            remaining = deadline - time.monotonic()
+            if remaining <= 0 or not self.read_some(remaining):
+                return None
+
+    def receive_stream(self, on_data):
+        # Same rules as Session::receive_stream() on the device.
+        expected, total, crc, unacked, nak_sent = 0, 0, 0, 0, False
+        while True:
+            frame = self.receive(DATA_TIMEOUT)
+            if frame is None:
+                raise ProtocolError('timed out')
+            frame_type, sequence, payload = frame
+            if frame_type == ERROR:
+                raise ProtocolError(payload.decode(errors='replace'))
+            if frame_type not in (DATA, END):
+                continue
+            if sequence != expected:
+                if (expected - sequence) & 0xff <= WINDOW:
+                    self.send(ACK, expected)
+                elif not nak_sent:
+                    self.send(NAK, expected)
+                    nak_sent = True
+                continue
+            nak_sent = False
+            expected = (expected + 1) & 0xff
+            if frame_type == END:
+                if struct.unpack('<II', payload) != (total, crc):
+                    raise ProtocolError('size or CRC mismatch')
+                self.send(ACK, expected)
+                return total
+            on_data(payload)
+            total += len(payload)
+            crc = zlib.crc32(payload, crc) & 0xffffffff
+            unacked += 1
+            if unacked >= WINDOW // 2:
+                self.send(ACK, expected)
+                unacked = 0
+
+    def send_stream(self, chunks):
+        # Go back N, as Session::send_stream() on the device.
+        pending = []
+        sequence, total, crc, ended, retries = 0, 0, 0, False, 0
+        while True:
+            while not ended and len(pending) < WINDOW:
+                chunk = next(chunks, None)
+                if chunk is None:
+                    frame = encode(END, sequence, struct.pack('<II', total, crc))
+                    ended = True
+                else:
+                    total += len(chunk)
+                    crc = zlib.crc32(chunk, crc) & 0xffffffff
+                    frame = encode(DATA, sequence, chunk)
+                pending.append((sequence, frame))
+                sequence = (sequence + 1) & 0xff
+                self.write(frame)
+
+            if ended and not pending:
+                return total
+
+            frame = self.receive(ACK_TIMEOUT)
+            if frame is None:
+                retries += 1
+                if retries > MAX_RETRIES:
+                    raise ProtocolError('timed out')
+                for _, data in pending:
+                    self.write(data)
+                continue
+
+            frame_type, next_expected, payload = frame
+            if frame_type == ERROR:
+                raise ProtocolError(payload.decode(errors='replace'))
+            if frame_type not in (ACK, NAK) or not pending:
+                continue
+            acked = (next_expected - pending[0][0]) & 0xff
+            if acked > len(pending):
+                continue
+            del pending[:acked]
+            retries = 0
+            if frame_type == NAK:
+                for _, data in pending:
+                    self.write(data)
+
+
+def rle_decode(data):
+    pixels = []
+    i = 0
+    while i < len(data):
+        control = data[i]
+        i += 1
+        if control < 128:
+            count = control + 1
+            pixels += struct.unpack_from('<%dH' % count, data, i)
+            i += count * 2
+        else:
+            pixels += struct.unpack_from('<H', data, i) * (control - 126)
+            i += 2
+    return pixels
+
+
+def write_png(path, width, height, rows):
+    def chunk(kind, data):
+        body = kind + data
+        return struct.pack('>I', len(data)) + body + struct.pack('>I', zlib.crc32(body) & 0xffffffff)
+
+    raw = b''.join(b'\x00' + row for row in rows)
+    with open(path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n')
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(raw)))
+        f.write(chunk(b'IEND', b''))
+
+
+def rgb565_row(pixels):
+    row = bytearray()
+    for p in pixels:
+        row += bytes(((p >> 8) & 0xf8, (p >> 3) & 0xfc, (p << 3) & 0xf8))
+    return bytes(row)
+
+
+def get(link, remote, local):
+    link.send(GET, 0, remote.encode())
+    with open(local, 'wb') as f:
+        return link.receive_stream(f.write)
+
+
+def put(link, local, remote):
+    link.send(PUT, 0, remote.encode())
+    frame = link.receive(DATA_TIMEOUT)
+    if frame is None:
+        raise ProtocolError('timed out')
+    if frame[0] == ERROR:
+        raise ProtocolError(frame[2].decode(errors='replace'))
+    with open(local, 'rb') as f:
+        return link.send_stream(iter(lambda: f.read(MAX_PAYLOAD), b''))
+
+
+def screen(link, path):
+    rows = []
+    link.send(SCREEN, 0)
+    link.receive_stream(lambda line: rows.append(rgb565_row(rle_decode(line))))
+    if len(rows) != SCREEN_HEIGHT:
+        raise ProtocolError('got %d lines' % len(rows))
+    write_png(path, SCREEN_WIDTH, SCREEN_HEIGHT, rows)
+    return len(rows)
+
+
+def iq(link, local, seconds='0'):
+    out = sys.stdout.buffer if local == '-' else open(local, 'wb')
+    deadline = time.monotonic() + float(seconds) if float(seconds) > 0 else None
+    info = None
+    base = None  # (block number, file position) the running capture is placed from
+    written = 0
+
+    def show(info):
+        frequency, rate, sample_bytes, _, blocks, dropped = info
+        if sample_bytes:
+            sys.stderr.write('%d Hz, %d S/s, C%d, %d blocks, %d dropped\n' % (frequency, rate, sample_bytes * 8, blocks, dropped))
+        else:
+            sys.stderr.write('waiting for a uC8 or uC16 capture\n')
+
+    link.send(IQ, 0)
+    last_frame = time.monotonic()
+    try:
+        while deadline is None or time.monotonic() < deadline:
+            wait = DATA_TIMEOUT if deadline is None else min(DATA_TIMEOUT, deadline - time.monotonic())
+            frame = link.receive(max(0, wait))
+            if frame is None:
+                # IqInfo comes every second even while no capture is running.
+                if time.monotonic() - last_frame >= DATA_TIMEOUT:
+                    raise ProtocolError('timed out')
+                continue
+            last_frame = time.monotonic()
+            frame_type, _, payload = frame
+            if frame_type == ERROR:
+                raise ProtocolError(payload.decode(errors='replace'))
+            if frame_type == IQ_INFO:
+                latest = IQ_INFO_FORMAT.unpack(payload)
+                if info is None or latest[:4] != info[:4]:
+                    show(latest)
+                info = latest
+                continue
+            if frame_type != IQ_DATA or info is None:
+                continue
+
+            index, offset = IQ_DATA_HEADER.unpack_from(payload)
+            block_size = info[3]
+            if base is None or index < base[0]:
+                base = (index, written)  # Numbering restarts with each capture
+            position = base[1] + (index - base[0]) * block_size + offset
+            if position < written:
+                continue
+            out.write(bytes(position - written))
+            out.write(payload[IQ_DATA_HEADER.size:])
+            written = position + len(payload) - IQ_DATA_HEADER.size
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if out is not sys.stdout.buffer:
+            out.close()
+
+    # Any frame stops the stream, the device answers with a last IqInfo and an Ack.
+    link.send(ACK, 0)
+    while True:
+        frame = link.receive(DATA_TIMEOUT)
+        if frame is None or frame[0] == ACK:
+            break
+        if frame[0] == IQ_INFO:
+            info = IQ_INFO_FORMAT.unpack(frame[2])
+    if info:
+        show(info)
+    return written
+
+
+def main():
+    commands = {'get': (get, 2), 'put': (put, 2), 'screen': (screen, 1), 'iq': (iq, 1)}
+    optional = {'iq': 1}
+    if (len(sys.argv) < 3 or sys.argv[2] not in commands or
+            not 0 <= len(sys.argv) - 3 - commands[sys.argv[2]][1] <= optional.get(sys.argv[2], 0)):
+        print(usage_message)
+        sys.exit(-1)
+
+    handler = commands[sys.argv[2]][0]
+    link = Link(sys.argv[1])
+    try:
+        link.shell('binmode')
+        start = time.monotonic()
+        result = handler(link, *sys.argv[3:])
+        elapsed = time.monotonic() - start
+        link.send(EXIT, 0)
+        link.receive(ACK_TIMEOUT)
+        if sys.argv[2] != 'screen':
+            # stderr, iq may be writing to stdout
+            sys.stderr.write('%d bytes in %.2f s, %.1f KiB/s\n' % (result, elapsed, result / 1024 / max(elapsed, 1e-6)))
+    except ProtocolError as e:
+        print('error: %s' % e)
+        sys.exit(1)
+    finally:
+        link.close()
+
+
+if __name__ == '__main__':
+    main()